@@ -0,0 +1,188 @@
+/**
+ * @file:     deca_cir.c
+ *
+ * @brief     CIR analysis: magnitude, noise floor, peak and first path search
+ *
+ * All integer, no division or square root per sample, so it can run on every
+ * received frame.
+ */
+#include <stdint.h>
+#include <limits.h>
+#include "deca_device_api.h"
+#include "deca_cir.h"
+#include "qmath.h"
+
+#define CIR_SAMPLE_SIGN_BIT 0x800000UL
+
+/* 20 / log2(10) in Q8.8 per LSB of log2_lut_fast(), in Q32, rounded. */
+#define LOG2_TO_DB20_Q8_Q32 202017810LL
+
+/* |re| and |im| to magnitude, see cir_magnitude_48b(). Two constant
+ * multiplies and two compares per sample, instead of the square root per
+ * sample of an exact (or CMSIS-DSP) complex magnitude. */
+static inline uint32_t cir_mag(uint32_t a, uint32_t b)
+{
+    uint32_t hi = (a > b) ? a : b;
+    uint32_t lo = (a > b) ? b : a;
+    uint32_t m = ((29U * hi) >> 5U) + ((61U * lo) >> 7U);
+
+    return (m > hi) ? m : hi;
+}
+
+/* Absolute value of a 24 bit two's complement sample (18 bits dynamic). */
+static inline uint32_t cir_abs24(const uint8_t *p)
+{
+    uint32_t v = (uint32_t)p[0] | ((uint32_t)p[1] << 8UL) | ((uint32_t)p[2] << 16UL);
+
+    return ((v & CIR_SAMPLE_SIGN_BIT) != 0UL) ? (0x1000000UL - v) : v;
+}
+
+static inline uint32_t cir_abs16(int16_t v)
+{
+    int32_t v32 = v;
+
+    return (uint32_t)((v32 < 0) ? -v32 : v32);
+}
+
+void cir_magnitude_48b(const uint8_t *samples, uint16_t num_samples, uint32_t *mag)
+{
+    for (uint16_t i = 0U; i < num_samples; i++)
+    {
+        mag[i] = cir_mag(cir_abs24(&samples[6U * i]), cir_abs24(&samples[(6U * i) + 3U]));
+    }
+}
+
+void cir_magnitude_16b(const int16_t *samples, uint16_t num_samples, uint8_t exponent, uint32_t *mag)
+{
+    for (uint16_t i = 0U; i < num_samples; i++)
+    {
+        mag[i] = cir_mag(cir_abs16(samples[2U * i]), cir_abs16(samples[(2U * i) + 1U])) << exponent;
+    }
+}
+
+static uint32_t cir_isqrt(uint64_t x)
+{
+    uint64_t r = 0ULL;
+    uint64_t bit = 1ULL << 62U;
+
+    while (bit > x)
+    {
+        bit >>= 2U;
+    }
+    while (bit != 0ULL)
+    {
+        if (x >= (r + bit))
+        {
+            x -= r + bit;
+            r = (r >> 1U) + bit;
+        }
+        else
+        {
+            r >>= 1U;
+        }
+        bit >>= 2U;
+    }
+    return (uint32_t)r;
+}
+
+int cir_analyse(const uint32_t *mag, uint16_t num_samples, uint16_t sample_offs, const cir_analysis_cfg_t *cfg,
+    cir_analysis_t *result)
+{
+    static const cir_analysis_cfg_t cfg_default = {
+        .noise_len = CIR_ANALYSIS_DEFAULT_NOISE_LEN,
+        .ntm = CIR_ANALYSIS_DEFAULT_NTM,
+        .pmult_q8 = CIR_ANALYSIS_DEFAULT_PMULT_Q8,
+    };
+    uint64_t sum = 0ULL;
+    uint64_t sum_sq = 0ULL;
+    uint64_t mean_sq;
+    uint32_t mean;
+    uint32_t thr;
+    uint32_t peak_thr;
+    uint16_t peak;
+    uint16_t fp;
+    uint16_t i;
+
+    if (cfg == NULL)
+    {
+        cfg = &cfg_default;
+    }
+    if ((mag == NULL) || (result == NULL) || (cfg->noise_len == 0U) || (num_samples <= cfg->noise_len))
+    {
+        return (int)DWT_ERROR;
+    }
+
+    /* Noise floor. */
+    for (i = 0U; i < cfg->noise_len; i++)
+    {
+        sum += mag[i];
+        sum_sq += (uint64_t)mag[i] * mag[i];
+    }
+    mean = (uint32_t)(sum / cfg->noise_len);
+    mean_sq = (uint64_t)mean * mean;
+    sum_sq /= cfg->noise_len;
+    result->noise_mean = mean;
+    result->noise_std = (sum_sq > mean_sq) ? cir_isqrt(sum_sq - mean_sq) : 0UL;
+
+    /* Peak, after the noise part. */
+    peak = cfg->noise_len;
+    for (i = cfg->noise_len + 1U; i < num_samples; i++)
+    {
+        if (mag[i] > mag[peak])
+        {
+            peak = i;
+        }
+    }
+    result->peak_index = sample_offs + peak;
+    result->peak_mag = mag[peak];
+
+    /* Threshold, never above the peak so there always is a first path. */
+    thr = mean + (cfg->ntm * result->noise_std);
+    peak_thr = (uint32_t)(((uint64_t)mag[peak] * cfg->pmult_q8) >> 8U);
+    if (thr < peak_thr)
+    {
+        thr = peak_thr;
+    }
+    if (thr > mag[peak])
+    {
+        thr = mag[peak];
+    }
+    result->threshold = thr;
+
+    /* First path: first sample reaching the threshold. */
+    fp = cfg->noise_len;
+    while ((fp < peak) && (mag[fp] < thr))
+    {
+        fp++;
+    }
+
+    /* Leading edge: interpolate the crossing between fp - 1 and fp. */
+    result->fp_index = (uint16_t)((sample_offs + fp) << 6U);
+    if ((mag[fp] > mag[fp - 1U]) && (mag[fp - 1U] < thr))
+    {
+        uint32_t frac_q6 = ((thr - mag[fp - 1U]) << 6U) / (mag[fp] - mag[fp - 1U]);
+
+        result->fp_index -= (uint16_t)(64U - frac_q6);
+    }
+
+    /* First path amplitude at its local maximum. */
+    while ((fp < peak) && (mag[fp + 1U] > mag[fp]))
+    {
+        fp++;
+    }
+    result->fp_mag = mag[fp];
+
+    if ((result->fp_mag == 0UL) || (result->fp_mag == result->peak_mag))
+    {
+        result->fp_to_peak_q8 = (result->fp_mag == 0UL) ? (int16_t)SHRT_MIN : 0;
+    }
+    else
+    {
+        int32_t diff_q15 = (int32_t)log2_lut_fast(result->fp_mag) - (int32_t)log2_lut_fast(result->peak_mag);
+        int64_t db_q8 = (((int64_t)diff_q15 * LOG2_TO_DB20_Q8_Q32) + (1LL << 31U)) >> 32U;
+
+        result->fp_to_peak_q8 = (db_q8 < SHRT_MIN) ? (int16_t)SHRT_MIN : (int16_t)db_q8;
+    }
+
+    return (int)DWT_SUCCESS;
+}
@@ -0,0 +1,100 @@
+/**
+ * @file:     deca_cir.h
+ *
+ * @brief     CIR analysis: magnitude, noise floor, peak and first path search
+ *
+ */
+#ifndef DECA_CIR_H_
+#define DECA_CIR_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Defaults for cir_analysis_cfg_t */
+#define CIR_ANALYSIS_DEFAULT_NOISE_LEN 16U
+#define CIR_ANALYSIS_DEFAULT_NTM       6U
+#define CIR_ANALYSIS_DEFAULT_PMULT_Q8  16U
+
+typedef struct
+{
+    uint16_t noise_len; //!< Samples at the start of the window used for the noise floor, before the first path
+    uint8_t ntm;        //!< Noise threshold multiplier: the first path threshold is mean + ntm * standard deviation of the noise
+    uint8_t pmult_q8;   //!< The threshold is at least the peak magnitude * pmult_q8 / 256
+} cir_analysis_cfg_t;
+
+typedef struct
+{
+    uint32_t noise_mean;   //!< Mean magnitude of the noise
+    uint32_t noise_std;    //!< Standard deviation of the noise magnitude
+    uint32_t threshold;    //!< First path threshold used
+    uint32_t peak_mag;     //!< Magnitude of the peak sample
+    uint16_t peak_index;   //!< Index of the peak sample in the accumulator
+    uint16_t fp_index;     //!< First path index in the accumulator (Q10.6 format, as FpIndex of dwt_cirdiags_t)
+    uint32_t fp_mag;       //!< Magnitude of the first path, the local maximum after the threshold crossing
+    int16_t fp_to_peak_q8; //!< First path to peak ratio 20*log10(fp_mag/peak_mag) in dB, Q8.8, 0 or negative
+} cir_analysis_t;
+
+/*! ---------------------------------------------------------------------------------------------------
+ * @brief Magnitudes of 48-bit complex CIR samples
+ *
+ * For the samples of dwt_readcir() with DWT_CIR_READ_FULL, dwt_readcir_48b() and DWT_CIR_PACK_48B
+ * chunks of dwt_readcir_stream(): 3 bytes real, 3 bytes imaginary, 24 bit two's complement with
+ * 18 bits dynamic, LSB first.
+ * The magnitude is approximated as alpha max plus beta min (max(hi, 29/32 hi + 61/128 lo))
+ * without a square root, within 2.4% (0.21 dB) of the exact value.
+ *
+ * input parameters
+ * @param samples complex samples, 6 bytes each
+ * @param num_samples number of samples
+ *
+ * output parameters
+ * @param mag magnitude of each sample
+ *
+ * return: None
+ */
+void cir_magnitude_48b(const uint8_t *samples, uint16_t num_samples, uint32_t *mag);
+
+/*! ---------------------------------------------------------------------------------------------------
+ * @brief Magnitudes of 16-bit complex CIR samples
+ *
+ * For the samples of dwt_readcir() with DWT_CIR_READ_LO/MID/HI and DWT_CIR_PACK_BFP16 chunks of
+ * dwt_readcir_stream(): 16 bits real followed by 16 bits imaginary. The magnitudes are shifted left
+ * by exponent, so chunks with a different block exponent (or the read modes) can be compared.
+ * Same approximation as cir_magnitude_48b().
+ *
+ * input parameters
+ * @param samples complex samples, 2 int16_t each
+ * @param num_samples number of samples
+ * @param exponent left shift of the magnitudes, 0 to 2 for the read modes, the chunk exponent for BFP16
+ *
+ * output parameters
+ * @param mag magnitude of each sample
+ *
+ * return: None
+ */
+void cir_magnitude_16b(const int16_t *samples, uint16_t num_samples, uint8_t exponent, uint32_t *mag);
+
+/*! ---------------------------------------------------------------------------------------------------
+ * @brief Estimate noise floor, peak and first path of a CIR window
+ *
+ * The noise mean and standard deviation are estimated on the first cfg->noise_len samples, so the
+ * window has to start that many samples before the first path, e.g. at (FpIndex >> 6) - 32 as read
+ * with dwt_readcir_stream(). The first path is the first sample from the end of the noise part up to
+ * the peak which reaches the threshold. Its index is refined to the linear interpolated threshold
+ * crossing between that sample and the one before (leading edge).
+ *
+ * input parameters
+ * @param mag magnitudes of the window (see cir_magnitude_48b(), cir_magnitude_16b())
+ * @param num_samples number of samples in the window
+ * @param sample_offs accumulator index of the first sample, added to the indexes of the result
+ * @param cfg analysis parameters, NULL for the defaults
+ *
+ * output parameters
+ * @param result noise floor, peak, first path and first path to peak ratio
+ *
+ * return: DWT_SUCCESS, or DWT_ERROR for invalid parameters (no samples after the noise part)
+ */
+int cir_analyse(const uint32_t *mag, uint16_t num_samples, uint16_t sample_offs, const cir_analysis_cfg_t *cfg,
+    cir_analysis_t *result);
+
+#endif /* DECA_CIR_H_ */
@@ -0,0 +1,197 @@
+/**
+ * @file:     deca_clktrack.c
+ *
+ * @brief     Clock tracking of a reference device, e.g. for TDoA anchor synchronisation
+ *
+ * The state is the reference time at the last sync and the skew s of the
+ * reference clock. A local interval dl is dl * (1 + s) in reference time,
+ * the difference between the reference timestamp of a sync and this
+ * prediction (innovation e) corrects the reference time by alpha * e and
+ * the skew by beta * e / dl.
+ */
+#include <stdint.h>
+#include "deca_device_api.h"
+#include "deca_clktrack.h"
+
+#define CLKTRACK_TS_MASK 0xFFFFFFFFFFULL
+#define CLKTRACK_TS_SIGN 0x8000000000ULL
+#define CLKTRACK_TS_WRAP (1LL << 40U)
+
+/* Limit of the skew (about 3900 ppm), so that dl * skew fits in 64 bits */
+#define CLKTRACK_MAX_SKEW_Q32 (1LL << 24U)
+
+/* Carrier clock offset s[-15:-26] to Q32 */
+#define CLKTRACK_CLOCK_OFFSET_SHIFT 6U
+
+/* Largest innovation, so that e << 32 fits in 64 bits */
+#define CLKTRACK_MAX_INNOVATION 0x7FFFFFFFUL
+
+static const clktrack_cfg_t cfg_default = {
+    .alpha_q8 = CLKTRACK_DEFAULT_ALPHA_Q8,
+    .beta_q8 = CLKTRACK_DEFAULT_BETA_Q8,
+    .gamma_q8 = CLKTRACK_DEFAULT_GAMMA_Q8,
+    .max_outliers = CLKTRACK_DEFAULT_MAX_OUTLIERS,
+    .max_innovation = CLKTRACK_DEFAULT_MAX_INNOVATION,
+    .max_interval = CLKTRACK_DEFAULT_MAX_INTERVAL,
+};
+
+/* a - b of 40 bit timestamps, in the range -2^39 to 2^39 - 1 */
+static int64_t clktrack_ts_diff(uint64_t a, uint64_t b)
+{
+    uint64_t d = (a - b) & CLKTRACK_TS_MASK;
+
+    return ((d & CLKTRACK_TS_SIGN) != 0ULL) ? ((int64_t)d - CLKTRACK_TS_WRAP) : (int64_t)d;
+}
+
+/* (v * factor) >> shift, rounded half away from zero */
+static int64_t clktrack_mul_shift(int64_t v, int64_t factor, uint8_t shift)
+{
+    int64_t p = v * factor;
+    int64_t half = 1LL << (shift - 1U);
+
+    return (p >= 0) ? ((p + half) >> shift) : -((-p + half) >> shift);
+}
+
+static int64_t clktrack_clamp_skew(int64_t skew_q32)
+{
+    if (skew_q32 > CLKTRACK_MAX_SKEW_Q32)
+    {
+        return CLKTRACK_MAX_SKEW_Q32;
+    }
+    if (skew_q32 < -CLKTRACK_MAX_SKEW_Q32)
+    {
+        return -CLKTRACK_MAX_SKEW_Q32;
+    }
+    return skew_q32;
+}
+
+void clktrack_reset(clktrack_t *t)
+{
+    t->local_ts = 0ULL;
+    t->ref_ts = 0ULL;
+    t->skew_q32 = 0;
+    t->last_innovation = 0;
+    t->valid = 0U;
+    t->synced = 0U;
+    t->outliers = 0U;
+}
+
+static int clktrack_start(clktrack_t *t, const clktrack_cfg_t *cfg, uint64_t ref_ts, uint64_t local_ts, int16_t clock_offset)
+{
+    clktrack_reset(t);
+    t->local_ts = local_ts;
+    t->ref_ts = ref_ts;
+    if (cfg->gamma_q8 != 0U)
+    {
+        t->skew_q32 = (int64_t)clock_offset * (1LL << CLKTRACK_CLOCK_OFFSET_SHIFT);
+    }
+    t->valid = 1U;
+    return CLKTRACK_INIT;
+}
+
+int clktrack_update(clktrack_t *t, const clktrack_cfg_t *cfg, uint64_t ref_ts, uint64_t local_ts, int16_t clock_offset)
+{
+    uint32_t max_innovation;
+    uint64_t pred;
+    int64_t rate_q32;
+    int64_t dl;
+    int64_t e;
+
+    if (cfg == NULL)
+    {
+        cfg = &cfg_default;
+    }
+    ref_ts &= CLKTRACK_TS_MASK;
+    local_ts &= CLKTRACK_TS_MASK;
+
+    if (t->valid == 0U)
+    {
+        return clktrack_start(t, cfg, ref_ts, local_ts, clock_offset);
+    }
+
+    dl = clktrack_ts_diff(local_ts, t->local_ts);
+    if ((dl <= 0) || ((uint64_t)dl > cfg->max_interval))
+    {
+        return clktrack_start(t, cfg, ref_ts, local_ts, clock_offset);
+    }
+
+    /* predicted reference time of the sync */
+    pred = (t->ref_ts + (uint64_t)dl + (uint64_t)clktrack_mul_shift(dl, t->skew_q32, 32U)) & CLKTRACK_TS_MASK;
+    e = clktrack_ts_diff(ref_ts, pred);
+
+    max_innovation = (cfg->max_innovation < CLKTRACK_MAX_INNOVATION) ? cfg->max_innovation : CLKTRACK_MAX_INNOVATION;
+    if ((t->synced != 0U) && ((e > (int64_t)max_innovation) || (e < -(int64_t)max_innovation)))
+    {
+        t->outliers++;
+        if (t->outliers < cfg->max_outliers)
+        {
+            return CLKTRACK_OUTLIER;
+        }
+        return clktrack_start(t, cfg, ref_ts, local_ts, clock_offset);
+    }
+    if ((e > (int64_t)CLKTRACK_MAX_INNOVATION) || (e < -(int64_t)CLKTRACK_MAX_INNOVATION))
+    {
+        /* second sync way off the first one */
+        return clktrack_start(t, cfg, ref_ts, local_ts, clock_offset);
+    }
+
+    /* skew residual e / dl (Q32) */
+    rate_q32 = clktrack_clamp_skew((e * (1LL << 32U)) / dl);
+
+    t->outliers = 0U;
+    t->local_ts = local_ts;
+    t->last_innovation = (int32_t)e;
+    if (t->synced == 0U)
+    {
+        /* the second sync measures the skew */
+        t->ref_ts = ref_ts;
+        t->skew_q32 += rate_q32;
+        t->synced = 1U;
+    }
+    else
+    {
+        t->ref_ts = (pred + (uint64_t)clktrack_mul_shift(e, cfg->alpha_q8, 8U)) & CLKTRACK_TS_MASK;
+        t->skew_q32 += clktrack_mul_shift(rate_q32, cfg->beta_q8, 8U);
+    }
+    if (cfg->gamma_q8 != 0U)
+    {
+        int64_t skew_cfo = (int64_t)clock_offset * (1LL << CLKTRACK_CLOCK_OFFSET_SHIFT);
+
+        t->skew_q32 += clktrack_mul_shift(skew_cfo - t->skew_q32, cfg->gamma_q8, 8U);
+    }
+    t->skew_q32 = clktrack_clamp_skew(t->skew_q32);
+
+    return CLKTRACK_OK;
+}
+
+int clktrack_update_rx(clktrack_t *t, const clktrack_cfg_t *cfg, uint64_t ref_ts, const dwt_rxreport_t *report)
+{
+    uint64_t local_ts = 0ULL;
+
+    for (int i = 4; i >= 0; i--)
+    {
+        local_ts = (local_ts << 8U) | report->rxTime[i];
+    }
+    return clktrack_update(t, cfg, ref_ts, local_ts, report->clockOffset);
+}
+
+uint64_t clktrack_to_ref(const clktrack_t *t, uint64_t local_ts)
+{
+    int64_t dl = clktrack_ts_diff(local_ts, t->local_ts);
+
+    return (t->ref_ts + (uint64_t)dl + (uint64_t)clktrack_mul_shift(dl, t->skew_q32, 32U)) & CLKTRACK_TS_MASK;
+}
+
+uint64_t clktrack_to_local(const clktrack_t *t, uint64_t ref_ts)
+{
+    int64_t dr = clktrack_ts_diff(ref_ts, t->ref_ts);
+    /* dl = dr / (1 + s) = dr - dr * s / (1 + s) */
+    int64_t inv_q32 = (t->skew_q32 * (1LL << 32U)) / ((1LL << 32U) + t->skew_q32);
+
+    return (t->local_ts + (uint64_t)dr - (uint64_t)clktrack_mul_shift(dr, inv_q32, 32U)) & CLKTRACK_TS_MASK;
+}
+
+int32_t clktrack_skew_ppm_q16(const clktrack_t *t)
+{
+    return (int32_t)clktrack_mul_shift(t->skew_q32, 1000000LL, 16U);
+}
@@ -0,0 +1,135 @@
+/**
+ * @file:     deca_clktrack.h
+ *
+ * @brief     Clock tracking of a reference device, e.g. for TDoA anchor synchronisation
+ *
+ * A clktrack_t follows the clock of one reference device (e.g. the master
+ * anchor) from sync frames: the reference TX timestamp carried in the frame
+ * and the local RX timestamp. It estimates the offset and the relative rate
+ * (skew) of the reference clock with a steady state Kalman filter (alpha
+ * beta filter), optionally fused with the clock offset the receiver measures
+ * from the carrier. Once synchronised, local timestamps are converted to the
+ * time of the reference and back.
+ *
+ * All timestamps are 40-bit device time units (DWT_TIME_UNITS) and may wrap,
+ * the arithmetic is integer only and each update is O(1), so one clktrack_t
+ * (32 bytes) per reference can be kept for many references.
+ */
+#ifndef DECA_CLKTRACK_H_
+#define DECA_CLKTRACK_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "deca_device_api.h"
+
+/* Defaults for clktrack_cfg_t */
+#define CLKTRACK_DEFAULT_ALPHA_Q8       64U           // offset gain 0.25
+#define CLKTRACK_DEFAULT_BETA_Q8        16U           // skew gain 0.0625
+#define CLKTRACK_DEFAULT_GAMMA_Q8       0U            // carrier clock offset not used
+#define CLKTRACK_DEFAULT_MAX_INNOVATION 6400U         // 100 ns
+#define CLKTRACK_DEFAULT_MAX_OUTLIERS   3U
+#define CLKTRACK_DEFAULT_MAX_INTERVAL   (1ULL << 38U) // about 4.3 s
+
+/* Result of clktrack_update() */
+#define CLKTRACK_INIT    0 // first sync, or restart after outliers or a too long interval
+#define CLKTRACK_OK      1 // sync used to update the estimate
+#define CLKTRACK_OUTLIER 2 // sync rejected, too far from the predicted time
+
+typedef struct
+{
+    uint8_t alpha_q8;        //!< Gain of the offset correction, / 256
+    uint8_t beta_q8;         //!< Gain of the skew correction from the timestamps, / 256
+    uint8_t gamma_q8;        //!< Gain of the skew correction from the carrier clock offset, / 256, 0 to ignore it
+    uint8_t max_outliers;    //!< Consecutive outliers after which tracking restarts
+    uint32_t max_innovation; //!< Largest difference between sync and predicted time accepted, in device time units (below 2^31)
+    uint64_t max_interval;   //!< Longest interval between syncs, in device time units (below 2^39)
+} clktrack_cfg_t;
+
+typedef struct
+{
+    uint64_t local_ts;       //!< Local timestamp of the last sync
+    uint64_t ref_ts;         //!< Estimated reference time at local_ts
+    int64_t skew_q32;        //!< Rate of the reference clock relative to the local one - 1, Q32 (1 ppm = 4295)
+    int32_t last_innovation; //!< Difference between the last sync and its predicted time
+    uint8_t valid;           //!< Set after the first sync
+    uint8_t synced;          //!< Set after the second sync, when the skew is measured
+    uint8_t outliers;        //!< Consecutive outliers
+} clktrack_t;
+
+/*! ---------------------------------------------------------------------------------------------------
+ * @brief Reset the tracking, e.g. when the reference is lost
+ *
+ * input parameters
+ * @param t clock tracking state
+ *
+ * return: None
+ */
+void clktrack_reset(clktrack_t *t);
+
+/*! ---------------------------------------------------------------------------------------------------
+ * @brief Update the tracking with a sync frame
+ *
+ * The first sync sets the offset, and the skew to the carrier clock offset if it is used, later syncs
+ * correct the predicted reference time and the skew by the gains of cfg. A sync which is further than
+ * cfg->max_innovation from the prediction is rejected, after cfg->max_outliers of them in a row (or after an
+ * interval longer than cfg->max_interval) tracking restarts from the sync.
+ *
+ * input parameters
+ * @param t clock tracking state
+ * @param cfg filter parameters, NULL for the defaults
+ * @param ref_ts reference timestamp of the sync (e.g. its TX timestamp, sent in the frame)
+ * @param local_ts local timestamp of the sync (its RX timestamp)
+ * @param clock_offset clock offset of the sync as dwt_readclockoffset(), only used if cfg->gamma_q8 is set
+ *
+ * return: CLKTRACK_INIT, CLKTRACK_OK or CLKTRACK_OUTLIER
+ */
+int clktrack_update(clktrack_t *t, const clktrack_cfg_t *cfg, uint64_t ref_ts, uint64_t local_ts, int16_t clock_offset);
+
+/*! ---------------------------------------------------------------------------------------------------
+ * @brief clktrack_update() with the RX timestamp and clock offset of a RX report (see dwt_readrxreport())
+ *
+ * input parameters
+ * @param t clock tracking state
+ * @param cfg filter parameters, NULL for the defaults
+ * @param ref_ts reference timestamp of the sync
+ * @param report RX report of the sync frame
+ *
+ * return: CLKTRACK_INIT, CLKTRACK_OK or CLKTRACK_OUTLIER
+ */
+int clktrack_update_rx(clktrack_t *t, const clktrack_cfg_t *cfg, uint64_t ref_ts, const dwt_rxreport_t *report);
+
+/*! ---------------------------------------------------------------------------------------------------
+ * @brief Convert a local timestamp to the time of the reference
+ *
+ * input parameters
+ * @param t clock tracking state, valid
+ * @param local_ts local timestamp, less than 2^39 device time units before or after the last sync
+ *
+ * return: reference time (40 bit)
+ */
+uint64_t clktrack_to_ref(const clktrack_t *t, uint64_t local_ts);
+
+/*! ---------------------------------------------------------------------------------------------------
+ * @brief Convert a time of the reference to a local timestamp, the inverse of clktrack_to_ref()
+ *
+ * input parameters
+ * @param t clock tracking state, valid
+ * @param ref_ts reference time, less than 2^39 device time units before or after the last sync
+ *
+ * return: local timestamp (40 bit)
+ */
+uint64_t clktrack_to_local(const clktrack_t *t, uint64_t ref_ts);
+
+/*! ---------------------------------------------------------------------------------------------------
+ * @brief Skew of the reference clock in ppm
+ *
+ * input parameters
+ * @param t clock tracking state
+ *
+ * return: skew in ppm, Q16.16, positive if the reference clock is faster than the local one (as the sign of
+ *         dwt_readclockoffset())
+ */
+int32_t clktrack_skew_ppm_q16(const clktrack_t *t);
+
+#endif /* DECA_CLKTRACK_H_ */
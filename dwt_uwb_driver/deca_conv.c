@@ -0,0 +1,54 @@
+/**
+ * @file:     deca_conv.c
+ *
+ * @brief     Fixed point conversions of temperature, voltage and clock offset
+ *
+ * Each conversion is an exact fraction num / den applied with 64 bit integer
+ * math and rounded half away from zero.
+ */
+#include <stdint.h>
+#include "deca_conv.h"
+
+/* 1.05 in Q8 = 105 * 256 / 100 */
+#define TEMP_NUM_Q8  2688LL
+#define TEMP_DEN     10LL
+
+/* 0.4 * 16 / 255 in Q16 = 4194304 / 2550 */
+#define VOLT_NUM_Q16  4194304LL
+#define VOLT_DEN      2550LL
+#define VOLT_OFFS_Q16 (3L << 16U)
+
+/* 1e6 / 2^26 in Q16 = 15625 / 16 */
+#define CLKOFFS_NUM_Q16 15625LL
+#define CLKOFFS_DEN     16LL
+
+/* 998.4e6 / 2^28 * 1e6 / 6489.6e6 in Q16 = 15625 / 416, for channel 9 with 7987.2e6: 15625 / 512 */
+#define CARRIER_NUM_Q16    15625LL
+#define CARRIER_DEN_CHAN_5 416LL
+#define CARRIER_DEN_CHAN_9 512LL
+
+static int32_t conv_div_round(int64_t num, int64_t den)
+{
+    return (int32_t)((num >= 0) ? ((num + (den / 2)) / den) : -((-num + (den / 2)) / den));
+}
+
+int32_t conv_temperature_q8(uint8_t raw_temp, uint8_t otp_temp, uint8_t otp_temp_c)
+{
+    return conv_div_round(((int64_t)raw_temp - otp_temp) * TEMP_NUM_Q8, TEMP_DEN) + ((int32_t)otp_temp_c << 8U);
+}
+
+int32_t conv_voltage_q16(uint8_t raw_voltage, uint8_t otp_vbat)
+{
+    return conv_div_round(((int64_t)raw_voltage - otp_vbat) * VOLT_NUM_Q16, VOLT_DEN) + VOLT_OFFS_Q16;
+}
+
+int32_t conv_clockoffset_ppm_q16(int16_t clock_offset)
+{
+    return conv_div_round((int64_t)clock_offset * CLKOFFS_NUM_Q16, CLKOFFS_DEN);
+}
+
+int32_t conv_carrierintegrator_ppm_q16(int32_t carrier_integrator, uint8_t chan)
+{
+    /* the sign changes, as HERTZ_TO_PPM_MULTIPLIER_CHAN_5/9 */
+    return conv_div_round(-(int64_t)carrier_integrator * CARRIER_NUM_Q16, (chan == 9U) ? CARRIER_DEN_CHAN_9 : CARRIER_DEN_CHAN_5);
+}
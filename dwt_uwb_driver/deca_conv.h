@@ -0,0 +1,71 @@
+/**
+ * @file:     deca_conv.h
+ *
+ * @brief     Fixed point conversions of temperature, voltage and clock offset
+ *
+ * Integer versions of dwt_convertrawtemperature(), dwt_convertrawvoltage() and
+ * of the ppm conversions of dwt_readclockoffset() and
+ * dwt_readcarrierintegrator() results, for MCUs without FPU. The results are
+ * the exact values rounded to the nearest LSB, they only differ from the float
+ * versions by the rounding error of the float math.
+ */
+#ifndef DECA_CONV_H_
+#define DECA_CONV_H_
+
+#include <stdint.h>
+
+/* temperature of the production reading in OTP, in degree C */
+#define CONV_OTP_TEMP_C_DW3000 22U
+#define CONV_OTP_TEMP_C_DW3720 25U
+
+/*! ---------------------------------------------------------------------------------------------------
+ * @brief Temperature from a raw SAR reading, as dwt_convertrawtemperature()
+ *
+ * (raw_temp - otp_temp) * 1.05 + otp_temp_c
+ *
+ * input parameters
+ * @param raw_temp raw temperature, as read by dwt_readtempvbat() (upper 8 bits) or dwt_readwakeuptemp()
+ * @param otp_temp production reading from OTP, see dwt_geticreftemp()
+ * @param otp_temp_c temperature of the production reading: CONV_OTP_TEMP_C_DW3000 (22 C) or
+ *                   CONV_OTP_TEMP_C_DW3720 (25 C)
+ *
+ * return: temperature in degree C, Q24.8
+ */
+int32_t conv_temperature_q8(uint8_t raw_temp, uint8_t otp_temp, uint8_t otp_temp_c);
+
+/*! ---------------------------------------------------------------------------------------------------
+ * @brief Voltage from a raw SAR reading, as dwt_convertrawvoltage()
+ *
+ * (raw_voltage - otp_vbat) * 0.4 * 16 / 255 + 3.0
+ *
+ * input parameters
+ * @param raw_voltage raw voltage, as read by dwt_readtempvbat() (lower 8 bits) or dwt_readwakeupvbat()
+ * @param otp_vbat production reading at 3.0 V from OTP, see dwt_geticrefvolt()
+ *
+ * return: voltage in V, Q16.16
+ */
+int32_t conv_voltage_q16(uint8_t raw_voltage, uint8_t otp_vbat);
+
+/*! ---------------------------------------------------------------------------------------------------
+ * @brief Clock offset in ppm, as dwt_readclockoffset() * CLOCK_OFFSET_PPM_TO_RATIO * 1e6
+ *
+ * input parameters
+ * @param clock_offset value of dwt_readclockoffset() (s[-15:-26])
+ *
+ * return: clock offset in ppm, Q16.16, positive if the local clock is slower than the remote one
+ */
+int32_t conv_clockoffset_ppm_q16(int16_t clock_offset);
+
+/*! ---------------------------------------------------------------------------------------------------
+ * @brief Clock offset in ppm from the carrier integrator, as
+ *        dwt_readcarrierintegrator() * FREQ_OFFSET_MULTIPLIER * HERTZ_TO_PPM_MULTIPLIER_CHAN_5/9
+ *
+ * input parameters
+ * @param carrier_integrator value of dwt_readcarrierintegrator()
+ * @param chan channel, 5 or 9
+ *
+ * return: clock offset in ppm, Q16.16, positive if the local clock is slower than the remote one
+ */
+int32_t conv_carrierintegrator_ppm_q16(int32_t carrier_integrator, uint8_t chan);
+
+#endif /* DECA_CONV_H_ */
@@ -19,6 +19,10 @@ extern "C"
 
 #include "deca_types.h"
 
+#if CONFIG_DW3000_NUM_INSTANCES
+#define DWT_NUM_DW_DEV CONFIG_DW3000_NUM_INSTANCES
+#endif
+
 #ifndef DWT_NUM_DW_DEV
 #define DWT_NUM_DW_DEV (1)
 #endif
@@ -51,13 +55,54 @@ extern "C"
 
 #define DWT_DW3720_PDOA_DEV_ID   DWT_QM33120_PDOA_DEV_ID   /* Backward compatibility definition of the P/N */
 
-#ifdef AUTO_DW3300Q_DRIVER
+#if defined(AUTO_DW3300Q_DRIVER) || CONFIG_DW3000_AUTO_PLL_CAL
 /* Automotive build: define below to enable hardened PLL calibration for automotive application. */
 #define AUTO_PLL_CAL
 #endif
 
+/* Optional features, the Kconfig options can compile them out to save memory (see CONFIG_DW3000_REDUCED_RAM).
+ * Without Kconfig everything is enabled. */
+#if !defined(CONFIG_DW3000) || CONFIG_DW3000_SPI_CRC
 // Enable CRC functionality. Disable to save space when CRC not required.
 #define DWT_ENABLE_CRC
+#endif
+
+#if !defined(CONFIG_DW3000) || CONFIG_DW3000_CIR
+// CIR read functions (dwt_readcir(), dwt_readcir_48b(), dwt_readcir_stream()) and their buffers. Without it
+// dwt_readcir() and dwt_readcir_48b() are not declared, dwt_readcir_stream() returns DWT_ERROR.
+#define DWT_ENABLE_CIR
+#endif
+
+#if !defined(CONFIG_DW3000) || CONFIG_DW3000_FULL_DIAG
+// All CIA diagnostic logging levels, otherwise dwt_configciadiag() only sets DW_CIA_DIAG_LOG_MIN.
+#define DWT_ENABLE_FULL_DIAG
+#endif
+
+#if !defined(CONFIG_DW3000) || CONFIG_DW3000_AES
+// AES engine (dwt_configure_aes(), dwt_do_aes(), dwt_do_aes_async()). Without it dwt_set_keyreg_128() and
+// dwt_configure_aes() are not declared, the AES job functions return an error.
+#define DWT_ENABLE_AES
+#endif
+
+#if !defined(CONFIG_DW3000) || CONFIG_DW3000_OTP_WRITE
+// OTP programming (dwt_otpwrite(), dwt_otpwriteandverify()).
+#define DWT_ENABLE_OTP_WRITE
+#endif
+
+#if CONFIG_DW3000_BATCH_MAX_XFERS
+// Maximum number of SPI transactions queued in one batch, a full batch is sent before queuing more.
+#define DWT_BATCH_MAX_XFERS ((uint8_t)CONFIG_DW3000_BATCH_MAX_XFERS)
+#endif
+
+#if CONFIG_DW3000_SPI_CRC_SLICE4
+// Calculate the SPI CRC-8 four bytes at a time, needs 768 bytes of additional lookup tables.
+#define DWT_CRC8_SLICE4
+#endif
+
+#if CONFIG_DW3000_REG_CACHE
+// Keep a write-through shadow copy of static configuration registers, so reading them does not need SPI access.
+#define DWT_REG_CACHE
+#endif
 
 #define DWT_DEBUG_PRINT  0 //debug
 #if (DWT_DEBUG_PRINT == 1)
@@ -712,6 +757,7 @@ extern "C"
         uint8_t  rx_flags;   // RX frame flags, see above
         uint8_t  dss_stat;   // Dual SPI status reg 11:38, 2 LSbits relevant : bit0 (DWT_CB_DSS_SPI1_AVAIL) and bit1 (DWT_CB_DSS_SPI2_AVAIL)
         struct dwchip_s *dw;
+        uint32_t rx_finfo;   // initial value of RX_FINFO register as ISR is entered (single RX buffer mode only, else 0)
     } dwt_cb_data_t;
 
     // Call-back type for SPI read error event (if the DW3000 generated CRC does not match the one calculated by the dwt_generatecrc8 function)
@@ -720,6 +766,12 @@ extern "C"
     // Call-back type for all interrupt events
     typedef void (*dwt_cb_t)(const dwt_cb_data_t *cb_data);
 
+    // Call-back type for completion of asynchronous SPI transfers (status is DWT_SUCCESS or DWT_ERROR)
+    typedef void (*dwt_spi_done_cb_t)(int32_t status, void *user_data);
+
+    // Call-back type for completion of asynchronous AES jobs (status is the AES_STS_ID status bits of the job)
+    typedef void (*dwt_aes_done_cb_t)(int8_t status, void *user_data);
+
     typedef struct
     {
         dwt_cb_t cbTxDone;         // Callback for TX confirmation event
@@ -904,6 +956,97 @@ extern "C"
 } dwt_cirdiags_t;
 #endif // WIN32
 
+    // RX report, the per-frame values typically needed after a good RX, see dwt_readrxreport()
+    typedef struct
+    {
+        uint8_t rxTime[5];         //!< Adjusted RX timestamp (as dwt_readrxtimestamp())
+        uint8_t ipatovRxTime[5];   //!< RX timestamp from Ipatov sequence
+        uint8_t stsRxTime[5];      //!< RX timestamp from STS
+        uint8_t dgcDecision;       //!< DGC decision (as dwt_get_dgcdecision())
+        int16_t clockOffset;       //!< Estimated xtal offset of the remote device (as dwt_readclockoffset())
+        int16_t stsQualityIndex;   //!< STS quality index (as dwt_readstsquality())
+        int16_t pdoa;              //!< Phase difference of the 2 POAs (as dwt_readpdoa())
+        uint32_t ipatovPower;      //!< Channel area for the Ipatov sequence, [16:0]
+        uint32_t ipatovF1;         //!< F1 for Ipatov sequence, [21:0]
+        uint32_t ipatovF2;         //!< F2 for Ipatov sequence, [21:0]
+        uint32_t ipatovF3;         //!< F3 for Ipatov sequence, [21:0]
+        uint16_t ipatovAccumCount; //!< Number accumulated symbols for Ipatov sequence, [11:0]
+    } dwt_rxreport_t;
+
+#ifndef DWT_WARM_CONTEXT_MAGIC
+#define DWT_WARM_CONTEXT_MAGIC 0xDECA3C7BUL
+#endif
+
+    // Warm context, the values dwt_initialise() reads from OTP plus the configuration state of the driver, see dwt_savewarmcontext()
+    typedef struct
+    {
+        uint32_t magic;          //!< DWT_WARM_CONTEXT_MAGIC when the context holds saved values
+        uint32_t partID;         //!< IC Part ID
+        uint64_t lotID;          //!< IC Lot ID
+        uint32_t pllCoarseCode;  //!< PLL coarse code (PLL_COARSE_CODE register)
+        uint16_t sleepMode;      //!< Configuration loaded at wake-up (as dwt_configuresleep())
+        uint16_t preambleLength; //!< Current preamble length
+        uint16_t txAntennaDelay; //!< TX antenna delay
+        uint16_t rxAntennaDelay; //!< RX antenna delay
+        int16_t stsThreshold;    //!< Threshold for deciding if received STS is good or bad
+        uint8_t ldoBiasKick;     //!< LDO and BIAS tune are programmed in OTP and have to be kicked
+        uint8_t biasTune;        //!< Bias tune code (DW3000 only)
+        uint8_t dgcOtpSet;       //!< DGC values are programmed in OTP
+        uint8_t vBatP;           //!< IC V bat read during production and stored in OTP
+        uint8_t tempP;           //!< IC temp read during production and stored in OTP
+        int8_t temperature;      //!< Temperature of the chip
+        uint8_t vdddigOtp;       //!< Value of VDDDIG in OTP
+        uint8_t vdddigCurrent;   //!< Value of VDDDIG in AON
+        uint8_t otpRev;          //!< OTP revision number
+        uint8_t initXtrim;       //!< XTAL trim value applied (read from OTP or set with dwt_setxtaltrim())
+        uint8_t channel;         //!< Current channel
+        uint8_t stsConfig;       //!< STS configuration mode
+        uint8_t ciaDiagnostic;   //!< CIA diagnostic logging level
+        uint8_t stsLength;       //!< Current STS length
+        uint8_t longFrames;      //!< Non-standard long frame mode
+        uint8_t disFce;          //!< Cached SYS_CFG_DIS_FCE_BIT
+        uint8_t crc;             //!< CRC-8 of all the fields above (as dwt_generatecrc8())
+
+#ifndef WIN32
+    } __attribute__((packed)) dwt_warm_context_t;
+#else
+} dwt_warm_context_t;
+#endif // WIN32
+
+/* Temperature bins of dwt_pll_cal_cache_t: DWT_PLL_CAL_BIN_WIDTH degrees wide from DWT_PLL_CAL_TEMP_MIN,
+ * temperatures outside are in the first or last bin */
+#define DWT_PLL_CAL_TEMP_MIN   (-40)
+#define DWT_PLL_CAL_BIN_WIDTH  10
+#define DWT_PLL_CAL_NUM_BINS   16
+
+    // PLL calibration cache, the coarse codes of successful PLL locks per channel and temperature bin, see dwt_setpllcalcache()
+    typedef struct
+    {
+        uint32_t partID;                      //!< IC Part ID the codes were calibrated on, the cache is cleared when it does not match
+        uint16_t ch5Valid;                    //!< Bit mask of the bins of ch5Code which hold a code
+        uint16_t ch9Valid;                    //!< Bit mask of the bins of ch9Code which hold a code
+        uint16_t ch5Code[DWT_PLL_CAL_NUM_BINS]; //!< CH5 VCO coarse tune code (PLL_COARSE_CODE[21:8])
+        uint8_t ch9Code[DWT_PLL_CAL_NUM_BINS];  //!< CH9 VCO coarse tune code (PLL_COARSE_CODE[6:0])
+        uint16_t hits;                        //!< Calibrations which locked on the cached code
+        uint16_t misses;                      //!< Calibrations which had to search from the OTP code
+    } dwt_pll_cal_cache_t;
+
+    // TX frame template written to the TX buffer by dwt_writetxtemplate()
+    typedef struct
+    {
+        uint16_t offset;         //!< Offset of the frame in the TX buffer
+        uint16_t length;         //!< Frame length including the 2 byte CRC
+        uint8_t ranging;         //!< 1 if this is a ranging frame, else 0
+    } dwt_txtemplate_t;
+
+    // Byte range of a TX frame template overwritten by dwt_sendtemplate()
+    typedef struct
+    {
+        uint16_t offset;         //!< Offset of the first byte in the frame
+        uint16_t length;         //!< Number of bytes
+        uint8_t *data;           //!< The new bytes, have to stay valid until dwt_sendtemplate() returns
+    } dwt_txpatch_t;
+
     typedef struct
     {
         // all of the below are mapped to a register in DW3000
@@ -1102,6 +1245,8 @@ extern "C"
 #define ERROR_WRONG_MODE     (-2)
 #define ERROR_WRONG_MIC_SIZE (-3)
 #define ERROR_PAYLOAD_SIZE   (-4)
+#define ERROR_AES_BUSY       (-5)
+#define ERROR_AES_IDLE       (-6)
 #define MIC_ERROR            0xFFU
 #define STS_LEN_128BIT       16U
 
@@ -1156,6 +1301,21 @@ extern "C"
         DWT_CIR_READ_HI   = 3, // reduced 32-bit complex samples: bits [17:2] for real/imag parts
     } dwt_cir_read_mode_e;
 
+/* Streamed CIR is read out by chunks of up to 32 complex samples, two chunks are buffered */
+#ifndef CHUNK_CIR_STREAM_NB_SAMP
+#define CHUNK_CIR_STREAM_NB_SAMP 32U
+#endif
+
+    /* This defines the packing of the samples passed to the CIR stream sink, see dwt_readcir_stream() */
+    typedef enum {
+        DWT_CIR_PACK_48B   = 0, // 48-bit complex samples as read from the accumulator (6 bytes per sample)
+        DWT_CIR_PACK_18B   = 1, // 18-bit real/imag parts packed back to back, LSB first (9 bytes per 2 samples)
+        DWT_CIR_PACK_BFP16 = 2, // 16-bit real/imag parts, all shifted right (rounded down) by the chunk exponent (4 bytes per sample)
+    } dwt_cir_pack_e;
+
+    /* CIR stream sink, called with every packed chunk; returning anything but DWT_SUCCESS stops the stream */
+    typedef int32_t (*dwt_cir_sink_cb_t)(const uint8_t *data, uint16_t length, uint16_t num_samples, uint8_t exponent, void *user_data);
+
     //NLOS structs
     typedef struct
     {
@@ -1323,6 +1483,11 @@ extern "C"
         * @brief  Number of availabe DW drivers.
         */
         uint8_t dw_driver_num;
+        /*! ------------------------------------------------------------------------------------------------------------------
+        * @brief  Optional function waiting until DW3000 signals SPIRDY (on the IRQ line) after a wake-up, for at most timeout_us.
+        *         Returns DWT_SUCCESS when ready. If NULL the driver waits for the maximum XTAL startup time instead.
+        */
+        int32_t(*wait_device_ready)(uint32_t timeout_us);
     };
 
     /* Extern definition for the driver descriptors */
@@ -1490,6 +1655,27 @@ extern "C"
     */
     int8_t dwt_getpllcalibrationtemperature(void);
 
+    /*! ------------------------------------------------------------------------------------------------------------------
+    * @brief This function sets a cache of PLL calibration results. With AUTO_PLL_CAL, the PLL calibration of
+    *        dwt_configure() (or a channel change) starts from the coarse code which locked last time on the same
+    *        channel and in the same temperature bin, instead of the OTP code. When nothing has drifted the PLL locks
+    *        on the first check and the step search is skipped. If the cached code does not lock any more it is
+    *        dropped and the search runs from the OTP code, whose result is stored in the cache.
+    *        The temperature is the one read by dwt_configure() or set by dwt_settemperature().
+    *        The cache is owned by the caller, it can be placed in RAM retained over sleep or reset, starting zeroed.
+    *        It remains set over dwt_initialise(). Codes calibrated on another device are cleared.
+    *
+    * input parameters
+    * @param cache - pointer to the cache, NULL to not use a cache
+    *
+    * output parameters none
+    *
+    * returns DWT_SUCCESS, or DWT_ERROR on a device without AUTO_PLL_CAL (DW3000)
+    *
+    * DW3720 ONLY
+    */
+    int32_t dwt_setpllcalcache(dwt_pll_cal_cache_t *cache);
+
     /*! ------------------------------------------------------------------------------------------------------------------
      * @brief This function enables/disables the fine grain TX sequencing (enabled by default).
      *
@@ -1588,6 +1774,45 @@ extern "C"
      */
     int32_t dwt_initialise(int32_t mode);
 
+    /*! ------------------------------------------------------------------------------------------------------------------
+     * @brief This function saves the values dwt_initialise() reads from OTP memory, together with the configuration state
+     * of the driver and the trim and calibration values applied to the device, into a warm context. The context can be
+     * kept in retained RAM or flash and given to dwt_initialise_warm() on the next start.
+     *
+     * NOTES:
+     * 1.this function should be called after dwt_initialise(), dwt_configure() and the antenna delay and XTAL trim setup
+     * 2.the context is only valid for the device it was saved from
+     *
+     * input parameters
+     *
+     * output parameters
+     * @param ctx - pointer to the warm context to fill in
+     *
+     * returns DWT_SUCCESS for success, or DWT_ERROR for error
+     */
+    int32_t dwt_savewarmcontext(dwt_warm_context_t *ctx);
+
+    /*! ------------------------------------------------------------------------------------------------------------------
+     * @brief This function is the fast alternative to dwt_initialise(): it initialises the driver data from a warm context
+     * saved by dwt_savewarmcontext() and applies the saved LDO/BIAS kick, XTAL trim, PLL coarse code and antenna delays,
+     * without any OTP memory reads.
+     *
+     * NOTES:
+     * 1.it is assumed this function is called after a reset or on power up of the DW3xxx transceiver, it should be
+     *   followed by dwt_configure() like dwt_initialise()
+     * 2.when the DW3xxx kept its configuration (e.g. the host restarted while the DW3xxx was in DEEPSLEEP),
+     *   dwt_restoreconfig() can be used after the wake-up instead of dwt_configure()
+     * 3.if DWT_ERROR is returned dwt_initialise() has to be used
+     *
+     * input parameters
+     * @param ctx - pointer to the warm context
+     *
+     * output parameters
+     *
+     * returns DWT_SUCCESS for success, or DWT_ERROR if the context is not valid
+     */
+    int32_t dwt_initialise_warm(const dwt_warm_context_t *ctx);
+
     /*! ------------------------------------------------------------------------------------------------------------------
      * @brief This function can place DW3000 into IDLE/IDLE_PLL or IDLE_RC mode when it is not actively in TX or RX.
      *
@@ -1799,6 +2024,29 @@ extern "C"
      */
     int32_t dwt_writetxdata(uint16_t txDataLength, uint8_t *txDataBytes, uint16_t txBufferOffset);
 
+    /*! ------------------------------------------------------------------------------------------------------------------
+     * @brief This API function starts writing the supplied TX data into the DW IC's TX buffer without waiting for the
+     *        SPI transfer to finish. The data must stay valid until the callback has been called. Only one asynchronous
+     *        transfer can be pending at a time.
+     *
+     *        If the SPI interface does not provide asynchronous functions, or SPI CRC mode is enabled, the data are
+     *        written synchronously and the callback is called before this function returns.
+     *
+     * NOTE: The callback may be called from interrupt context.
+     *
+     * input parameters
+     * @param txDataLength   - This is the total length of data (in bytes) to write to the tx buffer.
+     * @param txDataBytes    - Pointer to the user's buffer containing the data to send.
+     * @param txBufferOffset - This specifies an offset in the DW IC's TX Buffer at which to start writing data.
+     * @param cb             - function called when the transfer has completed (can be NULL)
+     * @param user_data      - pointer passed to the callback
+     *
+     * output parameters
+     *
+     * returns DWT_SUCCESS if the transfer was started, or DWT_ERROR for error
+     */
+    int32_t dwt_writetxdata_async(uint16_t txDataLength, uint8_t *txDataBytes, uint16_t txBufferOffset, dwt_spi_done_cb_t cb, void *user_data);
+
     /*! ------------------------------------------------------------------------------------------------------------------
      * @brief This API function configures the TX frame control register before the transmission of a frame
      *
@@ -1816,6 +2064,47 @@ extern "C"
      */
     void dwt_writetxfctrl(uint16_t txFrameLength, uint16_t txBufferOffset, uint8_t ranging);
 
+    /*! ------------------------------------------------------------------------------------------------------------------
+     * @brief This API function writes a TX frame template into the TX buffer and configures the TX frame control register
+     *        for it (like dwt_writetxdata() and dwt_writetxfctrl()). The frame can then be sent repeatedly with
+     *        dwt_sendtemplate(), which only writes the bytes that change between transmissions.
+     *
+     * NOTE: The TX buffer is not retained in DEEPSLEEP, the template has to be written again after a wake-up.
+     *
+     * input parameters
+     * @param txFrameLength  - length of the frame including the 2 byte CRC, see dwt_writetxfctrl()
+     * @param txFrameBytes   - the frame, the 2 CRC bytes at its end are added by the device and are not written
+     * @param txBufferOffset - offset of the frame in the TX buffer
+     * @param ranging        - 1 if this is a ranging frame, else 0
+     *
+     * output parameters
+     * @param tpl            - template descriptor to fill in
+     *
+     * returns DWT_SUCCESS for success, or DWT_ERROR for error
+     */
+    int32_t dwt_writetxtemplate(dwt_txtemplate_t *tpl, uint16_t txFrameLength, uint8_t *txFrameBytes, uint16_t txBufferOffset, uint8_t ranging);
+
+    /*! ------------------------------------------------------------------------------------------------------------------
+     * @brief This API function patches a TX frame template written with dwt_writetxtemplate() and initiates its transmission
+     *        like dwt_starttx(). The patches, the TX frame control register (only if the frame length differs from the
+     *        value last written) and the TX command are written in one batch of SPI transactions, while holding the SPI
+     *        bus. Use it e.g. to update the sequence number and timestamps of TWR Response/Final messages.
+     *
+     * input parameters
+     * @param tpl            - the template descriptor
+     * @param patches        - array of byte ranges of the frame to overwrite (can be NULL if numPatches is 0), the data has
+     *                         to be in the order it is sent (little endian for timestamps)
+     * @param numPatches     - number of entries in patches
+     * @param txFrameLength  - length of the frame including the 2 byte CRC, or 0 for the length of the template
+     * @param mode           - TX mode, see dwt_starttx()
+     *
+     * output parameters
+     *
+     * returns DWT_SUCCESS for success, or DWT_ERROR for error (a patch outside the frame, or a delayed transmission which
+     * was cancelled because the delayed time has passed)
+     */
+    int32_t dwt_sendtemplate(const dwt_txtemplate_t *tpl, const dwt_txpatch_t *patches, uint8_t numPatches, uint16_t txFrameLength, uint8_t mode);
+
     /*! ------------------------------------------------------------------------------------------------------------------
     * @brief This API function is used to configure frame preamble length, the frame premable length can be
     * configured in steps of 8, from 16 to 2048 symbols. If a non-zero value is configured, then the TXPSR_PE setting is ignored.
@@ -2623,6 +2912,29 @@ extern "C"
      */
     void dwt_readrxdata(uint8_t *buffer, uint16_t length, uint16_t rxBufferOffset);
 
+    /*! ------------------------------------------------------------------------------------------------------------------
+     * @brief This is used to start reading the data from the RX buffer without waiting for the SPI transfer to finish.
+     *        The buffer must stay valid until the callback has been called. Only one asynchronous transfer can be
+     *        pending at a time.
+     *
+     *        If the SPI interface does not provide asynchronous functions, or SPI CRC mode is enabled, the data are
+     *        read synchronously and the callback is called before this function returns.
+     *
+     * NOTE: The callback may be called from interrupt context.
+     *
+     * input parameters
+     * @param buffer - the buffer into which the data will be read
+     * @param length - the length of data to read (in bytes)
+     * @param rxBufferOffset - the offset in the rx buffer from which to read the data
+     * @param cb - function called when the transfer has completed (can be NULL)
+     * @param user_data - pointer passed to the callback
+     *
+     * output parameters
+     *
+     * returns DWT_SUCCESS if the transfer was started, or DWT_ERROR for error (e.g. another transfer is pending)
+     */
+    int32_t dwt_readrxdata_async(uint8_t *buffer, uint16_t length, uint16_t rxBufferOffset, dwt_spi_done_cb_t cb, void *user_data);
+
     /*! ------------------------------------------------------------------------------------------------------------------
      * @brief This is used to write the data from the RX scratch buffer, from an offset location given by offset parameter.
      *
@@ -2700,8 +3012,10 @@ extern "C"
     *
     * @return None
     */
+#ifdef DWT_ENABLE_CIR
     void dwt_readcir(uint32_t *buffer, dwt_acc_idx_e cir_idx, uint16_t sample_offs,
                         uint16_t num_samples, dwt_cir_read_mode_e mode);
+#endif
 
     /*!
      * This function reads the CIR/accumulator data in the compact 48-bit sample mode.
@@ -2717,7 +3031,33 @@ extern "C"
      *
      * @return None
      */
+#ifdef DWT_ENABLE_CIR
     void dwt_readcir_48b(uint8_t *buffer, dwt_acc_idx_e acc_idx, uint16_t sample_offs, uint16_t num_samples);
+#endif
+
+    /*!
+     * This function streams a window of the CIR/accumulator data to a sink, chunk by chunk.
+     *
+     * The window is read in chunks of up to CHUNK_CIR_STREAM_NB_SAMP complex samples. Each chunk is packed as selected
+     * by pack and passed to the sink, while the next chunk is already being read with an asynchronous SPI transfer
+     * (CONFIG_DW3000_SPI_ASYNC). Every chunk starts on a byte boundary. The sink runs while the SPI transfer is in
+     * flight and must not access the DW3000.
+     *
+     * To read a window around the first path, start it at the first path index (FpIndex >> 6 from
+     * dwt_readdiagnostics_acc()) minus the number of samples wanted before the first path.
+     *
+     * @param[in] acc_idx      Index of the accumulator to read data from
+     * @param[in] sample_offs  The sample index offset within the selected accumulator to start reading from
+     * @param[in] num_samples  The number of complex samples to stream
+     * @param[in] pack         Packing of the samples passed to the sink, see dwt_cir_pack_e
+     * @param[in] sink         Function called with every packed chunk
+     * @param[in] user_data    Pointer passed to sink
+     *
+     * @return DWT_SUCCESS, or DWT_ERROR for invalid parameters, if an asynchronous SPI transfer is pending or if a
+     *         chunk transfer failed
+     */
+    int32_t dwt_readcir_stream(dwt_acc_idx_e acc_idx, uint16_t sample_offs, uint16_t num_samples, dwt_cir_pack_e pack,
+        dwt_cir_sink_cb_t sink, void *user_data);
 
     /*! ------------------------------------------------------------------------------------------------------------------
      * @brief This is used to read the crystal offset (relating to the frequency offset of the far DW3000 device compared to this one)
@@ -2796,6 +3136,23 @@ extern "C"
      */
     void dwt_readdiagnostics(dwt_rxdiag_t *diagnostics);
 
+    /*! ------------------------------------------------------------------------------------------------------------------
+     * @brief this function reads the per-frame RX report: the RX timestamps, clock offset, STS quality, PDOA and the
+     *        Ipatov first path power inputs (for dwt_calculate_first_path_power()). All values are read in one SPI
+     *        batch, which is cheaper than calling dwt_readrxtimestamp(), dwt_readclockoffset(), dwt_readstsquality(),
+     *        dwt_readpdoa() and dwt_readdiagnostics() one after another.
+     *
+     * NOTE: In double buffer mode only the values in the configured CIA diagnostic set are returned, the other fields
+     *       are zero. Otherwise the power and F1-F3 values need DW_CIA_DIAG_LOG_ALL, else they read as 0.
+     *
+     * input parameters
+     * @param report - RX report structure pointer, this will contain the data read from the DW3000
+     *
+     * output parameters
+     * return value - >=0 for good and < 0 if bad STS quality.
+     */
+    int32_t dwt_readrxreport(dwt_rxreport_t *report);
+
     /*! ------------------------------------------------------------------------------------------------------------------
      * @brief This is used to enable/disable the event counter in the IC
      *
@@ -3043,6 +3400,30 @@ extern "C"
      */
     float dwt_convertrawvoltage(uint8_t raw_voltage);
 
+    /*! ------------------------------------------------------------------------------------------------------------------
+     * @brief fixed point version of dwt_convertrawtemperature(), without float math (see conv_temperature_q8())
+     *
+     * input parameters:
+     * @param raw_temp - this is the 8-bit raw temperature value as read by dwt_readtempvbat
+     *
+     * output parameters:
+     *
+     * returns: temperature in degree C, Q24.8
+     */
+    int32_t dwt_convertrawtemperature_q8(uint8_t raw_temp);
+
+    /*! ------------------------------------------------------------------------------------------------------------------
+     * @brief fixed point version of dwt_convertrawvoltage(), without float math (see conv_voltage_q16())
+     *
+     * input parameters:
+     * @param raw_voltage - this is the 8-bit raw voltage value as read by dwt_readtempvbat
+     *
+     * output parameters:
+     *
+     * returns: voltage in V, Q16.16
+     */
+    int32_t dwt_convertrawvoltage_q16(uint8_t raw_voltage);
+
     /*! ------------------------------------------------------------------------------------------------------------------
      * @brief this function reads the temperature of the DW3000 that was sampled
      * on waking from Sleep/Deepsleep. They are not current values, but read on last
@@ -3124,7 +3505,9 @@ extern "C"
      *
      * no return value
      */
+#ifdef DWT_ENABLE_AES
     void dwt_set_keyreg_128(dwt_aes_key_t *key);
+#endif
 
     /*! ------------------------------------------------------------------------------------------------------------------
      * @brief   This function provides the API for the configuration of the AES block before its first usage.
@@ -3136,7 +3519,9 @@ extern "C"
      *
      * no return value
      */
+#ifdef DWT_ENABLE_AES
     void dwt_configure_aes(dwt_aes_config_t *pCfg);
+#endif
 
     /*! ------------------------------------------------------------------------------------------------------------------
     * @brief   This gets mic size in bytes and convert it to value to write in AES_CFG
@@ -3164,6 +3549,37 @@ extern "C"
      */
     int8_t dwt_do_aes(dwt_aes_job_t *job, dwt_aes_core_type_e core_type);
 
+    /*! ------------------------------------------------------------------------------------------------------------------
+     * @brief   This function starts an AES job like dwt_do_aes(), but returns without waiting for the AES block. The
+     *          completion is reported by cb, from dwt_isr() on the AES_DONE/AES_ERR interrupt (which is enabled while
+     *          the job is pending) or from dwt_aes_poll().
+     *
+     *          The job and its header/payload buffers have to stay valid until the job has completed. Only one job can
+     *          be pending, and the RX/TX buffer used by the job must not be changed until then. A received frame can be
+     *          decrypted in place from cbRxOk with src_port and dst_port set to the RX buffer and header/payload set to
+     *          NULL, the decrypted frame is then read with dwt_readrxdata() in cb. The receiver must not be re-enabled
+     *          before.
+     *
+     * @param job - pointer to AES job, contains data info and encryption info.
+     * @param core_type - Core type
+     * @param cb - function called with the AES_STS_ID status bits when the job has completed (can be NULL if the job is
+     *             polled with dwt_aes_poll())
+     * @param user_data - pointer passed to cb
+     *
+     * @return  0 when the job was started, ERROR_AES_BUSY if another job is pending, or a negative error code
+     */
+    int8_t dwt_do_aes_async(dwt_aes_job_t *job, dwt_aes_core_type_e core_type, dwt_aes_done_cb_t cb, void *user_data);
+
+    /*! ------------------------------------------------------------------------------------------------------------------
+     * @brief   This function checks with a single SPI read if the job started by dwt_do_aes_async() has completed. When
+     *          polling, increase the interval between the calls (the AES block needs several us per 16 byte block) to
+     *          keep the SPI bus free for other transfers.
+     *
+     * @return  0 while the job is running, the AES_STS_ID status bits when it has completed (after cb was called), or
+     *          ERROR_AES_IDLE if no job is pending
+     */
+    int8_t dwt_aes_poll(void);
+
     /****************************************************************************************************************************************************
      *
      * Declaration of platform-dependent lower level functions.
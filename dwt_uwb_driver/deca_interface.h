@@ -458,6 +458,19 @@ struct dwt_readdiagnostics_acc_s
 struct dwchip_s;
 struct dw_rx_s;
 
+/*! ------------------------------------------------------------------------------------------------------------------
+    * @brief The dwt_spi_xfer_s structure describes one SPI transaction (header + body) of a batch, see xferbatch
+*/
+struct dwt_spi_xfer_s
+{
+    uint8_t header[2];     // transaction header as composed by the driver
+    uint16_t headerLength; // number of header bytes (1 or 2)
+    uint16_t length;       // number of body bytes
+    uint8_t *buffer;       // body data to write or buffer for data read
+    uint8_t read;          // 1 for reads, 0 for writes
+    uint8_t chained;       // 1 if the body continues the previous transaction, at the address following its body
+};
+
 /*! ------------------------------------------------------------------------------------------------------------------
     * @brief The dwt_spi_s structure is a structure assembling all the SPI functions that must be defined externally
     * NB: In porting this to a particular microprocessor, the implementer needs to define the low
@@ -532,6 +545,86 @@ struct dwt_spi_s
      *
      */
     void (*setfastrate)(void);
+
+    /*! ------------------------------------------------------------------------------------------------------------------
+     * @brief readfromspi_async
+     * Optional low level abstract function to start a read from the SPI and return before it has completed
+     * Same as readfromspi, but the header and read buffers must stay valid until cb is called
+     * input parameters:
+     * @param cb         - function to call when the transfer has completed (may be called from interrupt context)
+     * @param user_data  - pointer passed to cb
+     *
+     * output parameters:
+     * returns DWT_SUCCESS if the transfer was started, or DWT_ERROR for error
+     */
+    int32_t (*readfromspi_async)(uint16_t headerLength, uint8_t *headerBuffer, uint16_t readlength, uint8_t *readBuffer,
+                                 dwt_spi_done_cb_t cb, void *user_data);
+
+    /*! ------------------------------------------------------------------------------------------------------------------
+     * @brief writetospi_async
+     * Optional low level abstract function to start a write to the SPI and return before it has completed
+     * Same as writetospi, but the header and body buffers must stay valid until cb is called
+     * input parameters:
+     * @param cb         - function to call when the transfer has completed (may be called from interrupt context)
+     * @param user_data  - pointer passed to cb
+     *
+     * output parameters:
+     * returns DWT_SUCCESS if the transfer was started, or DWT_ERROR for error
+     */
+    int32_t (*writetospi_async)(uint16_t headerLength, const uint8_t *headerBuffer, uint16_t bodyLength, const uint8_t *bodyBuffer,
+                                dwt_spi_done_cb_t cb, void *user_data);
+
+    /*! ------------------------------------------------------------------------------------------------------------------
+     * @brief waitasync
+     * Optional low level abstract function to block until the transfer started last by readfromspi_async or
+     * writetospi_async has completed and its cb has returned, e.g. on a semaphore given after cb. If not provided, the
+     * driver polls for the completion
+     * input parameters:
+     *
+     * output parameters:
+     * returns DWT_SUCCESS when the transfer has completed, or DWT_ERROR for error
+     */
+    int32_t (*waitasync)(void);
+
+    /*! ------------------------------------------------------------------------------------------------------------------
+     * @brief xferbatch
+     * Optional low level abstract function to execute a sequence of SPI transactions back to back
+     * Every transaction has to be framed by its own chip select assertion, as the DW IC interprets the header per frame,
+     * except a chained one: its body may be sent in the frame of the previous transaction, without its header, as the
+     * DW IC increments the address during a frame. Chained transactions still have a valid header, so they may also be
+     * executed on their own. If not provided, the driver issues the transactions one by one using readfromspi and
+     * writetospi
+     * input parameters:
+     * @param xfers  - array of transactions, executed in order
+     * @param count  - number of transactions
+     *
+     * output parameters:
+     * returns DWT_SUCCESS for success, or DWT_ERROR for error
+     */
+    int32_t (*xferbatch)(const struct dwt_spi_xfer_s *xfers, uint16_t count);
+
+    /*! ------------------------------------------------------------------------------------------------------------------
+     * @brief lockbus
+     * Optional low level abstract function to hold the SPI bus for this device until unlockbus is called, so that a
+     * sequence of transactions is not interleaved with transfers to other devices on the same bus. Calls can be nested.
+     *
+     * input parameters:
+     *
+     * output parameters
+     *
+     */
+    void (*lockbus)(void);
+
+    /*! ------------------------------------------------------------------------------------------------------------------
+     * @brief unlockbus
+     * Optional low level abstract function to release the SPI bus held with lockbus
+     *
+     * input parameters:
+     *
+     * output parameters
+     *
+     */
+    void (*unlockbus)(void);
 };
 
 struct rxtx_configure_s
@@ -574,6 +667,7 @@ struct dwchip_s
     /*HAL*/
     struct dwt_spi_s *SPI; // first
     void(*wakeup_device_with_io)(void);
+    int32_t(*wait_device_ready)(uint32_t timeout_us);
 
     /*Driver*/
     struct dwt_driver_s *dwt_driver;
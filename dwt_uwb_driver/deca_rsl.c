@@ -21,6 +21,9 @@
 #define Q8_OFFSET 256UL
 #define Q8_SHIFT 8UL
 
+/* Q8_OFFSET / LOG2_10_SHIFTED in Q32, rounded. */
+#define LOG2_TO_DB_Q8_Q32 101011634LL
+
 /**
  * rsl_calculate() - Estimate the signal power in dBm
  *
@@ -135,3 +138,90 @@ int16_t rsl_calculate_first_path_power(
 
     return rsl_calculate(channel_area, preamble_accumulation_count, 0, dgc_decision, rx_pcode, is_sts);
 }
+
+/* log2 of a 64 bit value shifted by LUT_LOG_SHIFT, x must not be 0. */
+static uint32_t rsl_log2_u64(uint64_t x)
+{
+    uint32_t hi = (uint32_t)(x >> 32U);
+    uint32_t shift = 0U;
+
+    if (hi != 0UL)
+    {
+        shift = 32U - (uint32_t)__builtin_clz(hi);
+    }
+    return log2_lut_fast((uint32_t)(x >> shift)) + (shift << LUT_LOG_SHIFT);
+}
+
+/* 10*log10() in q8.8 of a log2 shifted by LUT_LOG_SHIFT, plus the offset. */
+static int16_t rsl_log2_to_dbm(int32_t log2_q15, int32_t offset_q8)
+{
+    int64_t dbm_q8 = (((int64_t)log2_q15 * LOG2_TO_DB_Q8_Q32) + (1LL << 31U)) >> 32U;
+
+    dbm_q8 += offset_q8;
+    if (dbm_q8 < SHRT_MIN)
+    {
+        return (int16_t)SHRT_MIN;
+    }
+    if (dbm_q8 > SHRT_MAX)
+    {
+        return (int16_t)SHRT_MAX;
+    }
+    return (int16_t)dbm_q8;
+}
+
+void rsl_calculate_batch(
+    const dwt_rxreport_t *reports,
+    uint16_t count,
+    uint8_t quantization_factor,
+    uint8_t rx_pcode,
+    int16_t *rsl,
+    int16_t *fsl
+) {
+    int32_t alpha_q8 = (PCODE_PRF64_START <= rx_pcode) ? ALPHA_IP_PRF_64_Q8 : ALPHA_IP_PRF_16_Q8;
+    int32_t pow2_q15 = (int32_t)((uint32_t)quantization_factor << LUT_LOG_SHIFT);
+    uint16_t last_n = 0U;
+    int32_t log2_n2 = 0;
+
+    for (uint16_t i = 0U; i < count; i++)
+    {
+        const dwt_rxreport_t *r = &reports[i];
+        uint16_t n = r->ipatovAccumCount;
+        int32_t offset_q8 = ((int32_t)r->dgcDecision * 6 * (int32_t)Q8_OFFSET) - alpha_q8;
+
+        /* Consecutive frames usually have the same accumulation count. */
+        if ((n != last_n) && (n != 0U))
+        {
+            log2_n2 = (int32_t)(log2_lut_fast(n) << 1U);
+            last_n = n;
+        }
+
+        if (rsl != NULL)
+        {
+            if ((r->ipatovPower == 0UL) || (n == 0U))
+            {
+                rsl[i] = (int16_t)SHRT_MIN;
+            }
+            else
+            {
+                rsl[i] = rsl_log2_to_dbm(pow2_q15 + (int32_t)log2_lut_fast(r->ipatovPower) - log2_n2, offset_q8);
+            }
+        }
+
+        if (fsl != NULL)
+        {
+            uint64_t f1 = r->ipatovF1 / 4UL;
+            uint64_t f2 = r->ipatovF2 / 4UL;
+            uint64_t f3 = r->ipatovF3 / 4UL;
+            uint64_t area = (f1 * f1) + (f2 * f2) + (f3 * f3);
+
+            if ((area == 0ULL) || (n == 0U))
+            {
+                fsl[i] = (int16_t)SHRT_MIN;
+            }
+            else
+            {
+                fsl[i] = rsl_log2_to_dbm((int32_t)rsl_log2_u64(area) - log2_n2, offset_q8);
+            }
+        }
+    }
+}
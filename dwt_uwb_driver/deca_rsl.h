@@ -15,6 +15,12 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+#include "deca_device_api.h"
+
+/* Power of two multiplied to the Channel Impulse Response Power value */
+#define RSL_QUANTIZATION_FACTOR_DW3000 21U
+#define RSL_QUANTIZATION_FACTOR_DW3720 17U
+
 /*! ---------------------------------------------------------------------------------------------------
  * @brief Estimate signal power as described in DW3000 Datasheet using fixed point math
  * 
@@ -67,4 +73,35 @@ int16_t rsl_calculate_first_path_power(
     bool is_sts
 );
 
+/*! ---------------------------------------------------------------------------------------------------
+ * @brief Estimate the signal power and the first path signal power of many received frames
+ *
+ * Same estimates as rsl_calculate_signal_power() and rsl_calculate_first_path_power() on the
+ * Ipatov values of the RX reports (see dwt_readrxreport()), but with log2_lut_fast(), a
+ * multiplication instead of the division and the offsets and log2(n) reused between frames.
+ * The results are within 0.05 dBm of the exact values. Unlike the single frame functions,
+ * powers below the noise floor (power * 2^pow2 < n²) give a valid negative estimate and first
+ * path amplitudes over the full 22 bit range are handled.
+ *
+ * input parameters
+ * @param reports RX reports of the frames
+ * @param count number of reports
+ * @param quantization_factor power of two multiplied to C (RSL_QUANTIZATION_FACTOR_DW3000 or _DW3720)
+ * @param rx_pcode RX code, used to know which PRF is used
+ *
+ * output parameters
+ * @param rsl signal power of each frame in Q8.8 format, or SHRT_MIN on error, may be NULL
+ * @param fsl first path signal power of each frame in Q8.8 format, or SHRT_MIN on error, may be NULL
+ *
+ * return: None
+ */
+void rsl_calculate_batch(
+    const dwt_rxreport_t *reports,
+    uint16_t count,
+    uint8_t quantization_factor,
+    uint8_t rx_pcode,
+    int16_t *rsl,
+    int16_t *fsl
+);
+
 #endif /* _DECA_RSL_H_ */
@@ -27,6 +27,17 @@
 #define DWT_API_ERROR_CHECK  /* API checks config input parameters */
 #endif
 
+#ifndef DWT_BATCH_MAX_XFERS
+#define DWT_BATCH_MAX_XFERS (8U) /* Maximum number of SPI transactions queued in one batch */
+#endif
+#define DIAG_MIN_BUF_LEN (CIA_DIAG_1_ID + CIA_DIAG_1_LEN - IP_TOA_LO_ID) /* IP_TOA_LO to CIA_DIAG_1, minimal diagnostics */
+#define ISR_STATUS_BURST_LEN (12U) /* SYS_STATUS, SYS_STATUS_HI and RX_FINFO read at ISR entry */
+#define DWT_REG_CACHE_NUM (6U) /* Number of registers in the shadow cache */
+#define RXREPORT_CIA_LEN (IP_DIAG_12_ID + IP_DIAG_12_LEN - IP_TOA_LO_ID) /* IP_TOA_LO to IP_DIAG_12, in the 0xC0000 space */
+#define RXREPORT_DB_MAX_LEN (BUF0_IP_DIAG_4 + 4UL - BUF0_RX_FINFO) /* RX_FINFO to IP_DIAG_4, in the swinging set */
+#define RXREPORT_BLOCK_LEN (RXREPORT_CIA_LEN)
+#define RXREPORT_ZERO_OFFSET (RXREPORT_BLOCK_LEN - 12UL) /* RX report values not read, always zero */
+
 // -------------------------------------------------------------------------------------------------------------------
 // Device Data for DW3720 Transceiver control
 //
@@ -54,8 +65,40 @@ typedef struct
     uint8_t sys_cfg_dis_fce_bit_flag; // Cached value of the SYS_CFG_DIS_FCE_BIT in the SYS_CFG_ID register
     dwt_sts_lengths_e stsLength;       // Current STS length
     uint16_t preamble_len;             // Current preamble length
+    uint8_t async_header[2];           // SPI header of the pending asynchronous transfer
+    volatile uint8_t async_busy;       // Flag set while an asynchronous SPI transfer is pending
+    volatile int32_t async_status;     // Status of the last completed asynchronous SPI transfer
+    dwt_spi_done_cb_t async_cb;        // Completion callback of the pending asynchronous transfer
+    void *async_user_data;             // User data passed to async_cb
+    uint32_t tx_fctrl;                                    // TXFLEN, TR and TXB_OFFSET value last written to TX_FCTRL, UINT32_MAX if not known
+#ifdef DWT_ENABLE_AES
+    dwt_aes_job_t *aes_job;            // AES job started by ull_do_aes_async() which has not completed
+    dwt_aes_done_cb_t aes_cb;          // Completion callback of aes_job
+    void *aes_user_data;               // User data passed to aes_cb
+#endif
+#ifdef AUTO_PLL_CAL
+    dwt_pll_cal_cache_t *pll_cal_cache; // PLL calibration cache set by ull_setpllcalcache(), not cleared by dwt_initialise()
+#endif
+#ifdef DWT_REG_CACHE
+    uint8_t reg_cache[DWT_REG_CACHE_NUM][4];             // Shadow copies of the registers in dwt_regcache_ids
+    uint8_t reg_cache_valid[DWT_REG_CACHE_NUM];           // Bit mask of the valid bytes of each shadow copy
+#endif
 } dwt_local_data_t;
 
+// SPI transactions queued by dwt_batch_add(). Each batch is kept in the stack frame of the function building it, so
+// dwt_isr() preempting a batch of the application can not commit or drop its transactions.
+typedef struct
+{
+    struct dwt_spi_xfer_s xfers[DWT_BATCH_MAX_XFERS]; // Queued SPI transactions
+    uint8_t data[DWT_BATCH_MAX_XFERS][9];             // Copies of the values written by queued transactions, and their SPI CRC
+    uint8_t cnt;                                      // Number of queued SPI transactions
+    uint8_t crc_check;                                // Bit mask of the queued reads followed by a read of their SPI CRC
+    uint32_t next_reg;                                // Address following the last queued transaction, if it can be chained
+#ifdef DWT_REG_CACHE
+    uint32_t reg[DWT_BATCH_MAX_XFERS];                // Address of each queued transaction, to update the cache after reads
+#endif
+} dwt_batch_t;
+
 // -------------------------------------------------------------------------------------------------------------------
 // Module Macro definitions and enumerations
 
@@ -332,7 +375,9 @@ static const uint8_t dwt_txp_lut_p0_b7_c9[] = {
 #define GET_MAX_INDEX_SOC(chan, pa, bias) (MAX_IDX_P## pa ## _B ## bias ## _C ## chan ## _SOC)
 
 /* the CIR accumulator offset to read from*/
+#ifdef DWT_ENABLE_CIR
 static const uint16_t dwt_cir_acc_offset[NUM_OF_DWT_ACC_IDX] = { 0x0U, 0x400U, 0x600U};
+#endif
 
 // -------------------------------------------------------------------------------------------------------------------
 // Internal functions prototypes for controlling and configuring the device
@@ -341,7 +386,9 @@ uint32_t dwt_read32bitoffsetreg(dwchip_t *dw, uint32_t regFileID, uint16_t regOf
 static uint8_t dwt_read8bitoffsetreg(dwchip_t *dw, uint32_t regFileID, uint16_t regOffset);
 static void dwt_write8bitoffsetreg(dwchip_t *dw, uint32_t regFileID, uint16_t regOffset, uint8_t regval);
 static uint32_t dwt_otpreadpintoparams(dwchip_t *dw, uint16_t address);
+#ifdef DWT_ENABLE_OTP_WRITE
 static void dwt_otpprogword32(dwchip_t *dw, uint32_t data, uint16_t address);
+#endif
 static void ull_force_clocks(dwchip_t *dw, int32_t clocks);
 uint8_t ull_calcbandwidthadj(dwchip_t *dw, uint16_t target_count);
 int32_t ull_run_pgfcal(dwchip_t *dw);
@@ -350,6 +397,7 @@ static uint8_t calc_new_th(uint8_t th, uint32_t iq_n, int16_t dec_step);
 static int32_t check_updated_th(uint32_t iq_, uint32_t iq_p, int16_t *best_diff);
 void ull_setplenfine(dwchip_t *dw, uint8_t preambleLength);
 uint16_t ull_getframelength(dwchip_t *dw, uint8_t *rng_bit);
+static uint16_t ull_decodeframelength(dwchip_t *dw, uint16_t finfo16, uint8_t *rng_bit);
 int32_t ull_check_dev_id(dwchip_t *dw);
 static int32_t ull_adcoffsetscalibration(dwchip_t *dw);
 static void ull_enable_disable_eq(dwchip_t *dw, uint8_t en);
@@ -363,6 +411,9 @@ static void ull_aon_write(dwchip_t *dw, uint16_t aon_address, uint8_t aon_write_
 uint8_t ull_aon_read(dwchip_t *dw, uint16_t aon_address);
 float ull_convertrawtemperature(dwchip_t *dw, uint8_t raw_temp);
 uint16_t ull_readtempvbat(dwchip_t *dw);
+#ifdef DWT_ENABLE_AES
+int8_t ull_aes_poll(dwchip_t *dw);
+#endif
 static uint16_t ull_readsar(dwchip_t *dw, uint8_t input_mux, uint8_t attn);
 static uint8_t ull_pll_ch5_auto_cal(dwchip_t *dw, uint32_t coarse_code, uint16_t sleep_us, uint8_t steps, uint8_t *p_num_steps_lock, int8_t temperature);
 static uint8_t ull_pll_ch9_auto_cal(dwchip_t *dw, uint32_t coarse_code, uint16_t sleep_us, uint8_t steps, uint8_t *p_num_steps_lock);
@@ -438,31 +489,176 @@ static void ull_wakeup_ic(dwchip_t *dw)
 #endif
 }
 
+#ifdef DWT_REG_CACHE
+/* Static configuration registers which are only changed by the host, these are kept in a write-through shadow cache */
+static const uint32_t dwt_regcache_ids[DWT_REG_CACHE_NUM] = { SYS_CFG_ID, TX_FCTRL_ID, TX_FCTRL_HI_ID, CHAN_CTRL_ID, TX_POWER_ID, DGC_CFG_ID };
+
 /*! ------------------------------------------------------------------------------------------------------------------
- * @brief  this function is used to read/write to the DW3720 device registers
+ * @brief  this function invalidates the shadow copies of all cached registers, it has to be called whenever the
+ *         device registers may have been changed without the driver (reset, sleep without configuration restore)
  *
  * input parameters:
- * @param dw            - DW3720 chip descriptor handler.
- * @param regFileID     - ID of register file or buffer being accessed
- * @param index         - byte index into register file or buffer being accessed
- * @param length        - number of bytes being written
- * @param buffer        - pointer to buffer containing the 'length' bytes to be written
- * @param mode          - DW3000_SPI_WR_BIT/DW3000_SPI_RD_BIT
+ * @param data       - pointer to the local device data
+ *
+ * output parameters
  *
  * no return value
  */
-static void dwt_xfer3xxx(dwchip_t *dw,
-    uint32_t regFileID, // 0x0, 0x04-0x7F; 0x10000, 0x10004, 0x10008-0x1007F; 0x20000 etc.
-    uint16_t index,      // sub-index, calculated from regFileID 0..0x7F
-    uint16_t length, uint8_t *buffer, const spi_modes_e mode)
+static void dwt_regcache_invalidate(dwt_local_data_t *data)
+{
+    for (uint8_t i = 0U; i < DWT_REG_CACHE_NUM; i++)
+    {
+        data->reg_cache_valid[i] = 0U;
+    }
+}
+
+/*! ------------------------------------------------------------------------------------------------------------------
+ * @brief  this function serves a register read from the shadow cache, if the read is within one cached register and
+ *         all bytes are valid
+ *
+ * input parameters:
+ * @param dw         - DW3720 chip descriptor handler.
+ * @param addr       - address of the first byte (register file ID + index)
+ * @param length     - number of bytes to read
+ *
+ * output parameters
+ * @param buffer     - buffer the cached bytes are copied to
+ *
+ * returns true if the read was served from the cache, false if it has to be done on the device
+ */
+static bool dwt_regcache_read(dwchip_t *dw, uint32_t addr, uint16_t length, uint8_t *buffer)
+{
+    uint32_t base;
+    uint8_t offset;
+    uint8_t mask;
+
+    for (uint8_t i = 0U; i < DWT_REG_CACHE_NUM; i++)
+    {
+        base = dwt_regcache_ids[i];
+        if ((length > 0U) && (addr >= base) && ((addr + length) <= (base + 4UL)))
+        {
+            offset = (uint8_t)(addr - base);
+            mask = (uint8_t)(((1U << length) - 1U) << offset);
+            if ((LOCAL_DATA(dw)->reg_cache_valid[i] & mask) != mask)
+            {
+                return false;
+            }
+            for (uint16_t j = 0U; j < length; j++)
+            {
+                buffer[j] = LOCAL_DATA(dw)->reg_cache[i][offset + j];
+            }
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*! ------------------------------------------------------------------------------------------------------------------
+ * @brief  this function updates the shadow cache with the data of a register read, write or AND/OR operation. For
+ *         AND/OR operations only bytes which are already valid are updated.
+ *
+ * input parameters:
+ * @param dw         - DW3720 chip descriptor handler.
+ * @param addr       - address of the first byte (register file ID + index)
+ * @param length     - number of bytes of the transaction
+ * @param buffer     - data read or written, or AND and OR masks
+ * @param mode       - type of the SPI transaction
+ *
+ * output parameters
+ *
+ * no return value
+ */
+static void dwt_regcache_update(dwchip_t *dw, uint32_t addr, uint16_t length, const uint8_t *buffer, const spi_modes_e mode)
+{
+    uint16_t datalen = length;
+    bool and_or = (mode == DW3000_SPI_AND_OR_8) || (mode == DW3000_SPI_AND_OR_16) || (mode == DW3000_SPI_AND_OR_32);
+    uint32_t base;
+    uint32_t start;
+    uint32_t end;
+    uint8_t b;
+    uint16_t k;
+
+    if (and_or)
+    {
+        datalen = length / 2U; // AND mask followed by OR mask
+    }
+    else if ((mode != DW3000_SPI_RD_BIT) && (mode != DW3000_SPI_WR_BIT))
+    {
+        return; // fast commands
+    }
+    else
+    {
+        // read or write
+    }
+
+    for (uint8_t i = 0U; i < DWT_REG_CACHE_NUM; i++)
+    {
+        base = dwt_regcache_ids[i];
+        start = (addr > base) ? addr : base;
+        end = ((addr + datalen) < (base + 4UL)) ? (addr + datalen) : (base + 4UL);
+
+        for (uint32_t a = start; a < end; a++)
+        {
+            b = (uint8_t)(a - base);
+            k = (uint16_t)(a - addr);
+            if (!and_or)
+            {
+                LOCAL_DATA(dw)->reg_cache[i][b] = buffer[k];
+                LOCAL_DATA(dw)->reg_cache_valid[i] |= (uint8_t)(1U << b);
+            }
+            else if ((LOCAL_DATA(dw)->reg_cache_valid[i] & (uint8_t)(1U << b)) != 0U)
+            {
+                LOCAL_DATA(dw)->reg_cache[i][b] = (LOCAL_DATA(dw)->reg_cache[i][b] & buffer[k]) | buffer[datalen + k];
+            }
+            else
+            {
+                // unknown value stays invalid
+            }
+        }
+    }
+}
+
+/*! ------------------------------------------------------------------------------------------------------------------
+ * @brief  this function invalidates the shadow cache before the device enters sleep, unless the configuration is
+ *         restored from the AON memory on wake up
+ *
+ * input parameters:
+ * @param dw         - DW3720 chip descriptor handler.
+ *
+ * output parameters
+ *
+ * no return value
+ */
+static void dwt_regcache_sleep(dwchip_t *dw)
+{
+    if ((LOCAL_DATA(dw)->sleep_mode & (uint16_t)DWT_CONFIG) == 0U)
+    {
+        dwt_regcache_invalidate(LOCAL_DATA(dw));
+    }
+}
+#endif
+
+/*! ------------------------------------------------------------------------------------------------------------------
+ * @brief  this function composes the SPI transaction header for an access to the DW3720 device registers
+ *
+ * input parameters:
+ * @param regFileID  - ID of register file or buffer being accessed
+ * @param index      - byte index into register file or buffer being accessed
+ * @param length     - number of bytes being written or read
+ * @param mode       - type of the SPI transaction
+ *
+ * output parameters
+ * @param header     - buffer of at least 2 bytes the header is composed in
+ *
+ * returns the number of header bytes (1 or 2)
+ */
+static uint16_t dwt_xfer3xxx_header(uint32_t regFileID, uint16_t index, uint16_t length, const spi_modes_e mode, uint8_t *header)
 {
-    uint8_t header[2]; // Buffer to compose header in
     uint16_t cnt = 1U;  // Counter for length of a header
     uint16_t reg_file;
     uint16_t reg_offset;
     uint16_t addr;
-    uint8_t crc8, dwcrc8;
-    bool fatal_error_occurred = false;
 
     bool length_is_correct = length < DWT_REG_DATA_MAX_LENGTH;
     assert(length_is_correct);
@@ -488,6 +684,41 @@ static void dwt_xfer3xxx(dwchip_t *dw,
         }
     }
 
+    return cnt;
+}
+
+/*! ------------------------------------------------------------------------------------------------------------------
+ * @brief  this function is used to read/write to the DW3720 device registers
+ *
+ * input parameters:
+ * @param dw            - DW3720 chip descriptor handler.
+ * @param regFileID     - ID of register file or buffer being accessed
+ * @param index         - byte index into register file or buffer being accessed
+ * @param length        - number of bytes being written
+ * @param buffer        - pointer to buffer containing the 'length' bytes to be written
+ * @param mode          - DW3000_SPI_WR_BIT/DW3000_SPI_RD_BIT
+ *
+ * no return value
+ */
+static void dwt_xfer3xxx(dwchip_t *dw,
+    uint32_t regFileID, // 0x0, 0x04-0x7F; 0x10000, 0x10004, 0x10008-0x1007F; 0x20000 etc.
+    uint16_t index,      // sub-index, calculated from regFileID 0..0x7F
+    uint16_t length, uint8_t *buffer, const spi_modes_e mode)
+{
+    uint8_t header[2]; // Buffer to compose header in
+    uint16_t cnt;       // Counter for length of a header
+    uint8_t crc8, dwcrc8;
+    bool fatal_error_occurred = false;
+
+#ifdef DWT_REG_CACHE
+    if ((mode == DW3000_SPI_RD_BIT) && dwt_regcache_read(dw, regFileID + index, length, buffer))
+    {
+        return;
+    }
+#endif
+
+    cnt = dwt_xfer3xxx_header(regFileID, index, length, mode, header);
+
     switch (mode)
     {
     case DW3000_SPI_AND_OR_8:
@@ -515,19 +746,41 @@ static void dwt_xfer3xxx(dwchip_t *dw,
     case DW3000_SPI_RD_BIT:
     case DW3000_SPI_RD_FAST_CMD:
     {
-        (void)dw->SPI->readfromspi(cnt, header, length, buffer);
-
         // check that the SPI read has correct CRC-8 byte
-        // also don't do for SPICRC_CFG_ID register itself to prevent infinite recursion
+        // also don't do for SPI_RD_CRC_ID register itself to prevent infinite recursion
         if ((LOCAL_DATA(dw)->spicrc == DWT_SPI_CRC_MODE_WRRD) && (regFileID != SPI_RD_CRC_ID))
         {
+            struct dwt_spi_xfer_s xfers[2];
+
+            // read the data and the CRC that was generated in the DW3720 for the read transaction back to back,
+            // these are still two SPI transactions, the CRC can only be read from its own register
+            xfers[0].headerLength = cnt;
+            xfers[0].header[0] = header[0];
+            xfers[0].header[1] = header[1];
+            xfers[0].length = length;
+            xfers[0].buffer = buffer;
+            xfers[0].read = 1U;
+            xfers[0].chained = 0U;
+            xfers[1].headerLength = dwt_xfer3xxx_header(SPI_RD_CRC_ID, 0U, 1U, DW3000_SPI_RD_BIT, xfers[1].header);
+            xfers[1].length = 1U;
+            xfers[1].buffer = &dwcrc8;
+            xfers[1].read = 1U;
+            xfers[1].chained = 0U;
+
+            if (dw->SPI->xferbatch != NULL)
+            {
+                (void)dw->SPI->xferbatch(xfers, 2U);
+            }
+            else
+            {
+                (void)dw->SPI->readfromspi(cnt, header, length, buffer);
+                (void)dw->SPI->readfromspi(xfers[1].headerLength, xfers[1].header, 1U, &dwcrc8);
+            }
+
             // generate 8 bit CRC from the read data
             crc8 = dwt_generatecrc8(header, cnt, 0U);
             crc8 = dwt_generatecrc8(buffer, length, crc8);
 
-            // read the CRC that was generated in the DW3720 for the read transaction
-            dwcrc8 = dwt_read8bitoffsetreg(dw, SPI_RD_CRC_ID, 0U);
-
             // if the two CRC don't match report SPI read error
             // potential problem in callback if it will try to read/write SPI with CRC again.
             if (crc8 != dwcrc8)
@@ -538,6 +791,10 @@ static void dwt_xfer3xxx(dwchip_t *dw,
                 }
             }
         }
+        else
+        {
+            (void)dw->SPI->readfromspi(cnt, header, length, buffer);
+        }
         break;
     }
     default:
@@ -545,6 +802,10 @@ static void dwt_xfer3xxx(dwchip_t *dw,
         break;
     }
 
+#ifdef DWT_REG_CACHE
+    dwt_regcache_update(dw, regFileID + index, length, buffer, mode);
+#endif
+
     if(fatal_error_occurred)
     {
         while(true){ /* Forever loop */ }
@@ -552,6 +813,474 @@ static void dwt_xfer3xxx(dwchip_t *dw,
 
 } // end dwt_xfer3xxx()
 
+/*! ------------------------------------------------------------------------------------------------------------------
+ * @brief  completion handler of asynchronous SPI transfers, releases the transfer and calls the user callback
+ *
+ * input parameters:
+ * @param status     - DWT_SUCCESS or DWT_ERROR as reported by the SPI interface
+ * @param user_data  - DW3720 chip descriptor handler
+ *
+ * output parameters
+ *
+ * no return value
+ */
+static void dwt_xfer3xxx_async_done(int32_t status, void *user_data)
+{
+    dwchip_t *dw = (dwchip_t *)user_data;
+    dwt_spi_done_cb_t cb = LOCAL_DATA(dw)->async_cb;
+    void *cb_user_data = LOCAL_DATA(dw)->async_user_data;
+
+    LOCAL_DATA(dw)->async_status = status;
+    LOCAL_DATA(dw)->async_busy = 0U;
+
+    if (cb != NULL)
+    {
+        cb(status, cb_user_data);
+    }
+}
+
+/*! ------------------------------------------------------------------------------------------------------------------
+ * @brief  this function starts a read or write of the DW3720 device registers or buffers without waiting for the
+ *         SPI transfer to complete. If the SPI interface has no asynchronous functions or SPI CRC mode is enabled,
+ *         the transfer is done synchronously and the callback is called before returning.
+ *
+ * input parameters:
+ * @param dw         - DW3720 chip descriptor handler.
+ * @param regFileID  - ID of register file or buffer being accessed
+ * @param index      - byte index into register file or buffer being accessed
+ * @param length     - number of bytes being written or read
+ * @param buffer     - pointer to buffer containing the 'length' bytes to be written or read, must stay valid until cb
+ * @param mode       - DW3000_SPI_WR_BIT or DW3000_SPI_RD_BIT
+ * @param cb         - function called when the transfer has completed (can be NULL)
+ * @param user_data  - pointer passed to cb
+ *
+ * output parameters
+ *
+ * returns DWT_SUCCESS if the transfer was started, or DWT_ERROR for error
+ */
+static int32_t dwt_xfer3xxx_async(dwchip_t *dw, uint32_t regFileID, uint16_t index, uint16_t length, uint8_t *buffer,
+    const spi_modes_e mode, dwt_spi_done_cb_t cb, void *user_data)
+{
+    int32_t ret;
+    uint16_t cnt;
+
+    assert(mode == DW3000_SPI_WR_BIT || mode == DW3000_SPI_RD_BIT);
+
+    if (LOCAL_DATA(dw)->async_busy != 0U)
+    {
+        return (int32_t)DWT_ERROR;
+    }
+
+    if ((LOCAL_DATA(dw)->spicrc != DWT_SPI_CRC_MODE_NO)
+        || ((mode == DW3000_SPI_RD_BIT) && (dw->SPI->readfromspi_async == NULL))
+        || ((mode == DW3000_SPI_WR_BIT) && (dw->SPI->writetospi_async == NULL)))
+    {
+        // CRC handling needs the data, fall back to blocking transfer
+        LOCAL_DATA(dw)->async_status = (int32_t)DWT_SUCCESS;
+        dwt_xfer3xxx(dw, regFileID,  index, length, buffer, mode);
+        if (cb != NULL)
+        {
+            cb((int32_t)DWT_SUCCESS, user_data);
+        }
+        return (int32_t)DWT_SUCCESS;
+    }
+
+    LOCAL_DATA(dw)->async_busy = 1U;
+    LOCAL_DATA(dw)->async_cb = cb;
+    LOCAL_DATA(dw)->async_user_data = user_data;
+
+    // the header has to stay valid until the transfer completes
+    cnt = dwt_xfer3xxx_header(regFileID, index, length, mode, LOCAL_DATA(dw)->async_header);
+
+    if (mode == DW3000_SPI_RD_BIT)
+    {
+        ret = dw->SPI->readfromspi_async(cnt, LOCAL_DATA(dw)->async_header, length, buffer, dwt_xfer3xxx_async_done, dw);
+    }
+    else
+    {
+        ret = dw->SPI->writetospi_async(cnt, LOCAL_DATA(dw)->async_header, length, buffer, dwt_xfer3xxx_async_done, dw);
+    }
+
+    if (ret != (int32_t)DWT_SUCCESS)
+    {
+        LOCAL_DATA(dw)->async_status = ret;
+        LOCAL_DATA(dw)->async_busy = 0U;
+    }
+
+    return ret;
+} // end dwt_xfer3xxx_async()
+
+#ifdef DWT_ENABLE_CIR
+/*! ------------------------------------------------------------------------------------------------------------------
+ * @brief  this function waits until the asynchronous SPI transfer started last has completed, blocking in the
+ *         waitasync function of the SPI interface if available, else polling for the completion
+ *
+ * input parameters:
+ * @param dw         - DW3720 chip descriptor handler.
+ *
+ * output parameters
+ *
+ * returns the status of the transfer, DWT_SUCCESS or DWT_ERROR
+ */
+static int32_t dwt_xfer3xxx_async_wait(dwchip_t *dw)
+{
+    if ((LOCAL_DATA(dw)->async_busy != 0U) && (dw->SPI->waitasync != NULL))
+    {
+        (void)dw->SPI->waitasync();
+    }
+
+    while (LOCAL_DATA(dw)->async_busy != 0U)
+    {
+        // wait for the transfer to complete
+    }
+
+    return LOCAL_DATA(dw)->async_status;
+}
+#endif
+
+/*! ------------------------------------------------------------------------------------------------------------------
+ * @brief  this function holds the SPI bus for the following transactions until dwt_unlockbus(), if the platform supports
+ *         it (lockbus in dwt_spi_s). It is used around sequences of transactions which should not be interleaved with
+ *         transfers to other devices on the same bus. Calls can be nested.
+ *
+ * input parameters:
+ * @param dw         - DW3720 chip descriptor handler.
+ *
+ * output parameters
+ *
+ * no return value
+ */
+static void dwt_lockbus(dwchip_t *dw)
+{
+    if (dw->SPI->lockbus != NULL)
+    {
+        dw->SPI->lockbus();
+    }
+}
+
+/*! ------------------------------------------------------------------------------------------------------------------
+ * @brief  this function releases the SPI bus held with dwt_lockbus().
+ *
+ * input parameters:
+ * @param dw         - DW3720 chip descriptor handler.
+ *
+ * output parameters
+ *
+ * no return value
+ */
+static void dwt_unlockbus(dwchip_t *dw)
+{
+    if (dw->SPI->unlockbus != NULL)
+    {
+        dw->SPI->unlockbus();
+    }
+}
+
+/*! ------------------------------------------------------------------------------------------------------------------
+ * @brief  this function starts a new batch of SPI transactions. Transactions added with dwt_batch_read(),
+ *         dwt_batch_write() and dwt_batch_fastcmd() are only executed in dwt_batch_commit(), in the order they were
+ *         added. Read buffers must stay valid until the batch is committed.
+ *
+ * input parameters:
+ * @param dw         - DW3720 chip descriptor handler.
+ * @param batch      - the batch, in the stack frame of the caller
+ *
+ * output parameters
+ *
+ * no return value
+ */
+static void dwt_batch_begin(dwchip_t *dw, dwt_batch_t *batch)
+{
+    batch->cnt = 0U;
+    batch->crc_check = 0U;
+}
+
+/*! ------------------------------------------------------------------------------------------------------------------
+ * @brief  this function executes all queued SPI transactions of the current batch, with the xferbatch function of
+ *         the SPI interface if available. With DWT_SPI_CRC_MODE_WRRD the CRC of all queued reads is verified after
+ *         the batch, and cbSPIRDErr is called once if any of them does not match.
+ *
+ * input parameters:
+ * @param dw         - DW3720 chip descriptor handler.
+ * @param batch      - the batch, in the stack frame of the caller
+ *
+ * output parameters
+ *
+ * no return value
+ */
+static void dwt_batch_commit(dwchip_t *dw, dwt_batch_t *batch)
+{
+    struct dwt_spi_xfer_s *xfer;
+    uint8_t crc8;
+    bool crc_error = false;
+
+    if (batch->cnt == 0U)
+    {
+        return;
+    }
+
+    if (dw->SPI->xferbatch != NULL)
+    {
+        (void)dw->SPI->xferbatch(batch->xfers, batch->cnt);
+    }
+    else
+    {
+        for (uint8_t i = 0U; i < batch->cnt; i++)
+        {
+            xfer = &batch->xfers[i];
+            if (xfer->read != 0U)
+            {
+                (void)dw->SPI->readfromspi(xfer->headerLength, xfer->header, xfer->length, xfer->buffer);
+            }
+            else
+            {
+                (void)dw->SPI->writetospi(xfer->headerLength, xfer->header, xfer->length, xfer->buffer);
+            }
+        }
+    }
+
+#ifdef DWT_REG_CACHE
+    // the data of the queued reads is only known now
+    for (uint8_t i = 0U; i < batch->cnt; i++)
+    {
+        xfer = &batch->xfers[i];
+        if ((xfer->read != 0U) && (batch->reg[i] != UINT32_MAX))
+        {
+            dwt_regcache_update(dw, batch->reg[i], xfer->length, xfer->buffer, DW3000_SPI_RD_BIT);
+        }
+    }
+#endif
+
+    // the read of the device CRC is always queued right after the read it belongs to
+    for (uint8_t i = 0U; (batch->crc_check != 0U) && (i < batch->cnt); i++)
+    {
+        if ((batch->crc_check & (1U << i)) != 0U)
+        {
+            xfer = &batch->xfers[i];
+            crc8 = dwt_generatecrc8(xfer->header, xfer->headerLength, 0U);
+            crc8 = dwt_generatecrc8(xfer->buffer, xfer->length, crc8);
+            if (crc8 != batch->xfers[i + 1U].buffer[0])
+            {
+                crc_error = true;
+            }
+        }
+    }
+
+    batch->cnt = 0U;
+    batch->crc_check = 0U;
+
+    // potential problem in callback if it will try to read/write SPI with CRC again.
+    if (crc_error && (dw->callbacks.cbSPIRDErr != NULL))
+    {
+        dw->callbacks.cbSPIRDErr();
+    }
+}
+
+/*! ------------------------------------------------------------------------------------------------------------------
+ * @brief  this function adds a SPI transaction to the current batch. When the batch is full, the queued transactions
+ *         are committed first. Without SPI CRC, a read or write of the address following the previous transaction of the
+ *         same direction is marked as chained to it, so xferbatch can send both in one SPI frame. With SPI CRC enabled,
+ *         the CRC byte is appended to the copied write data, and with DWT_SPI_CRC_MODE_WRRD a read of the device CRC is
+ *         queued after each read, as its own SPI transaction (the device only provides it in a separate read), and all
+ *         of them are verified together in dwt_batch_commit(). Writes of data which is not copied into the batch are executed immediately in SPI CRC mode, after the
+ *         already queued transactions.
+ *
+ * input parameters:
+ * @param dw         - DW3720 chip descriptor handler.
+ * @param batch      - the batch, in the stack frame of the caller
+ * @param regFileID  - ID of register file or buffer being accessed
+ * @param index      - byte index into register file or buffer being accessed
+ * @param length     - number of bytes being written or read
+ * @param buffer     - pointer to the data to write or buffer to read into
+ * @param mode       - type of the SPI transaction
+ *
+ * output parameters
+ *
+ * no return value
+ */
+static void dwt_batch_add(dwchip_t *dw, dwt_batch_t *batch, uint32_t regFileID, uint16_t index, uint16_t length, uint8_t *buffer, const spi_modes_e mode)
+{
+    struct dwt_spi_xfer_s *xfer;
+    uint8_t *data = batch->data[batch->cnt];
+    uint8_t read = (uint8_t)(((mode == DW3000_SPI_RD_BIT) || (mode == DW3000_SPI_RD_FAST_CMD)) ? 1U : 0U);
+    bool crc_wr = (LOCAL_DATA(dw)->spicrc != DWT_SPI_CRC_MODE_NO) && (read == 0U);
+    bool crc_rd = (LOCAL_DATA(dw)->spicrc == DWT_SPI_CRC_MODE_WRRD) && (read != 0U) && (regFileID != SPI_RD_CRC_ID);
+    uint8_t slots = crc_rd ? 2U : 1U;
+    // plain reads and writes can continue the previous transaction in the same SPI frame
+    bool plain = ((mode == DW3000_SPI_RD_BIT) || (mode == DW3000_SPI_WR_BIT)) && (length != 0U) && (LOCAL_DATA(dw)->spicrc == DWT_SPI_CRC_MODE_NO);
+
+    // the CRC byte has to follow the write data, only possible when it was copied by dwt_batch_write()
+    if (crc_wr && (length != 0U) && (buffer != data))
+    {
+        dwt_batch_commit(dw, batch);
+        dwt_xfer3xxx(dw, regFileID, index, length, buffer, mode);
+        return;
+    }
+
+#ifdef DWT_REG_CACHE
+    if ((mode == DW3000_SPI_RD_BIT) && dwt_regcache_read(dw, regFileID + index, length, buffer))
+    {
+        return;
+    }
+    // reads update the cache in dwt_batch_commit(), when their data has been received
+    if (mode != DW3000_SPI_RD_BIT)
+    {
+        dwt_regcache_update(dw, regFileID + index, length, buffer, mode);
+    }
+#endif
+
+    if ((batch->cnt + slots) > DWT_BATCH_MAX_XFERS)
+    {
+        dwt_batch_commit(dw, batch);
+    }
+
+    xfer = &batch->xfers[batch->cnt];
+#ifdef DWT_REG_CACHE
+    batch->reg[batch->cnt] = (mode == DW3000_SPI_RD_BIT) ? (regFileID + index) : UINT32_MAX;
+#endif
+    xfer->headerLength = dwt_xfer3xxx_header(regFileID, index, length, mode, xfer->header);
+    xfer->length = length;
+    xfer->buffer = buffer;
+    xfer->read = read;
+    xfer->chained = (uint8_t)((plain && (batch->cnt != 0U) && ((regFileID + index) == batch->next_reg)
+                               && (batch->xfers[batch->cnt - 1U].read == read)) ? 1U : 0U);
+    batch->next_reg = plain ? (regFileID + index + length) : UINT32_MAX;
+    if (crc_wr)
+    {
+        // this slot's data either holds the value copied by dwt_batch_write() or is unused (no data)
+        data = batch->data[batch->cnt];
+        data[length] = dwt_generatecrc8(xfer->header, xfer->headerLength, 0U);
+        data[length] = dwt_generatecrc8(buffer, length, data[length]);
+        xfer->buffer = data;
+        xfer->length = length + 1U;
+    }
+    batch->cnt++;
+
+    if (crc_rd)
+    {
+        batch->crc_check |= (uint8_t)(1U << (batch->cnt - 1U));
+        xfer = &batch->xfers[batch->cnt];
+#ifdef DWT_REG_CACHE
+        batch->reg[batch->cnt] = SPI_RD_CRC_ID;
+#endif
+        xfer->headerLength = dwt_xfer3xxx_header(SPI_RD_CRC_ID, 0U, 1U, DW3000_SPI_RD_BIT, xfer->header);
+        xfer->length = 1U;
+        xfer->buffer = batch->data[batch->cnt];
+        xfer->read = 1U;
+        xfer->chained = 0U;
+        batch->cnt++;
+    }
+}
+
+/*! ------------------------------------------------------------------------------------------------------------------
+ * @brief  this function queues a read of the device registers in the current batch
+ *
+ * input parameters:
+ * @param dw         - DW3720 chip descriptor handler.
+ * @param batch      - the batch, in the stack frame of the caller
+ * @param regFileID  - ID of register file or buffer being accessed
+ * @param regOffset  - the index into register file or buffer being accessed
+ * @param length     - number of bytes to read
+ * @param buffer     - buffer the data is read into, valid after dwt_batch_commit()
+ *
+ * output parameters
+ *
+ * no return value
+ */
+static void dwt_batch_read(dwchip_t *dw, dwt_batch_t *batch, uint32_t regFileID, uint16_t regOffset, uint16_t length, uint8_t *buffer)
+{
+    dwt_batch_add(dw, batch, regFileID, regOffset, length, buffer, DW3000_SPI_RD_BIT);
+}
+
+/*! ------------------------------------------------------------------------------------------------------------------
+ * @brief  this function queues a write of an up to 32-bit value to the device registers in the current batch
+ *
+ * input parameters:
+ * @param dw         - DW3720 chip descriptor handler.
+ * @param batch      - the batch, in the stack frame of the caller
+ * @param regFileID  - ID of register file or buffer being accessed
+ * @param regOffset  - the index into register file or buffer being accessed
+ * @param length     - number of bytes to write (1, 2 or 4)
+ * @param regval     - the value to write, it is copied so it does not need to stay valid
+ *
+ * output parameters
+ *
+ * no return value
+ */
+static void dwt_batch_write(dwchip_t *dw, dwt_batch_t *batch, uint32_t regFileID, uint16_t regOffset, uint16_t length, uint32_t regval)
+{
+    uint8_t *data;
+
+    assert(length <= 4U);
+
+    if (batch->cnt >= DWT_BATCH_MAX_XFERS)
+    {
+        dwt_batch_commit(dw, batch);
+    }
+
+    data = batch->data[batch->cnt];
+    for (uint16_t j = 0U; j < length; j++)
+    {
+        data[j] = (uint8_t)regval;
+        regval >>= 8U;
+    }
+
+    dwt_batch_add(dw, batch, regFileID, regOffset, length, data, DW3000_SPI_WR_BIT);
+}
+
+/*! ------------------------------------------------------------------------------------------------------------------
+ * @brief  this function queues a fast command in the current batch
+ *
+ * input parameters:
+ * @param dw         - DW3720 chip descriptor handler.
+ * @param batch      - the batch, in the stack frame of the caller
+ * @param cmd        - fast command to send
+ *
+ * output parameters
+ *
+ * no return value
+ */
+static void dwt_batch_fastcmd(dwchip_t *dw, dwt_batch_t *batch, uint32_t cmd)
+{
+    dwt_batch_add(dw, batch, cmd, 0U, 0U, NULL, DW3000_SPI_WR_FAST_CMD);
+}
+
+/*! ------------------------------------------------------------------------------------------------------------------
+ * @brief  this function queues an AND/OR modification of a 32-bit value in the device registers in the current batch
+ *
+ * input parameters:
+ * @param dw         - DW3720 chip descriptor handler.
+ * @param batch      - the batch, in the stack frame of the caller
+ * @param regFileID  - ID of register file or buffer being accessed
+ * @param regOffset  - the index into register file or buffer being accessed
+ * @param and_value  - the value to AND to register
+ * @param or_value   - the value to OR to register
+ *
+ * output parameters
+ *
+ * no return value
+ */
+static void dwt_batch_modify32(dwchip_t *dw, dwt_batch_t *batch, uint32_t regFileID, uint16_t regOffset, uint32_t and_value, uint32_t or_value)
+{
+    uint8_t *data;
+
+    if (batch->cnt >= DWT_BATCH_MAX_XFERS)
+    {
+        dwt_batch_commit(dw, batch);
+    }
+
+    data = batch->data[batch->cnt];
+    for (uint16_t j = 0U; j < 4U; j++)
+    {
+        data[j] = (uint8_t)and_value;
+        data[j + 4U] = (uint8_t)or_value;
+        and_value >>= 8U;
+        or_value >>= 8U;
+    }
+
+    dwt_batch_add(dw, batch, regFileID, regOffset, 8U, data, DW3000_SPI_AND_OR_32);
+}
+
 /*! ------------------------------------------------------------------------------------------------------------------
  * @brief  this function is used to write to the DW3000 device registers
  *
@@ -836,6 +1565,9 @@ static void dwt_modify8bitoffsetreg(dwchip_t *dw, const uint32_t regFileID, cons
  */
 void ull_enablespicrccheck(dwchip_t *dw, dwt_spi_crc_mode_e crc_mode, dwt_spierrcb_t spireaderr_cb)
 {
+#ifndef DWT_ENABLE_CRC
+    crc_mode = DWT_SPI_CRC_MODE_NO; // the CRC calculation is compiled out
+#endif
     // enable CRC check in DW3000
     if (crc_mode != DWT_SPI_CRC_MODE_NO)
     {
@@ -867,6 +1599,13 @@ static void dwt_localstruct_init(dwt_local_data_t *data)
     data->vBatP = 0U;
     data->tempP = 0U;
     data->sys_cfg_dis_fce_bit_flag = 0U;
+    data->tx_fctrl = UINT32_MAX;
+#ifdef DWT_ENABLE_AES
+    data->aes_job = NULL;
+#endif
+#ifdef DWT_REG_CACHE
+    dwt_regcache_invalidate(data);
+#endif
 }
 
 #ifdef AUTO_PLL_CAL
@@ -939,13 +1678,51 @@ static int32_t ull_set_vdddig_mv(dwchip_t *dw,  dwt_vdddig_mv_t vdddig)
     }
     LOCAL_DATA(dw)->vdddig_current = vdddig_coarse << 4U | vdddig_fine;
 
-    dwt_aon_write(AON_VDD_DIG, LOCAL_DATA(dw)->vdddig_current);
-    return (int32_t)DWT_SUCCESS;
+    dwt_aon_write(AON_VDD_DIG, LOCAL_DATA(dw)->vdddig_current);
+    return (int32_t)DWT_SUCCESS;
+}
+#endif
+
+/** @note one instance of local driver data per DW chip, see DWT_NUM_DW_DEV */
+static dwt_local_data_t dwt_local_data[DWT_NUM_DW_DEV];
+static dwchip_t *dwt_local_data_owner[DWT_NUM_DW_DEV];
+
+/*! ------------------------------------------------------------------------------------------------------------------
+ * @brief This function returns the local driver data of the chip descriptor, it assigns a free one to a chip
+ *        descriptor used for the first time.
+ *
+ * input parameters
+ * @param dw - DW3720 chip descriptor handler.
+ *
+ * output parameters
+ *
+ * returns pointer to the local driver data, or NULL if DWT_NUM_DW_DEV chips are already in use
+ */
+static dwt_local_data_t *dwt_local_data_get(dwchip_t *dw)
+{
+    uint8_t i;
+    uint8_t free_idx = (uint8_t)DWT_NUM_DW_DEV;
+
+    for (i = 0U; i < (uint8_t)DWT_NUM_DW_DEV; i++)
+    {
+        if (dwt_local_data_owner[i] == dw)
+        {
+            return &dwt_local_data[i];
+        }
+        if ((dwt_local_data_owner[i] == NULL) && (free_idx == (uint8_t)DWT_NUM_DW_DEV))
+        {
+            free_idx = i;
+        }
+    }
+
+    if (free_idx == (uint8_t)DWT_NUM_DW_DEV)
+    {
+        return NULL;
+    }
+
+    dwt_local_data_owner[free_idx] = dw;
+    return &dwt_local_data[free_idx];
 }
-#endif
-
-/** @note unique instance of local driver data */
-static dwt_local_data_t dwt_local_data;
 
 /*! ------------------------------------------------------------------------------------------------------------------
  * @brief This function initialises the DW3720 transceiver:
@@ -973,7 +1750,11 @@ static int32_t ull_initialise(dwchip_t *dw, int32_t mode)
     uint16_t bias_tune;
     uint32_t pll_coarse_code;
 
-    dw->priv = &dwt_local_data;
+    dw->priv = dwt_local_data_get(dw);
+    if (dw->priv == NULL)
+    {
+        return (int32_t)DWT_ERROR;
+    }
     dwt_local_data_t *pdw3000local = (dwt_local_data_t *)dw->priv;
 
     dwt_localstruct_init(pdw3000local);
@@ -1087,6 +1868,141 @@ static int32_t ull_initialise(dwchip_t *dw, int32_t mode)
     return (int32_t)DWT_SUCCESS;
 } // end dwt_initialise()
 
+/*! ------------------------------------------------------------------------------------------------------------------
+ * @brief This function saves the values ull_initialise() reads from OTP memory, the configuration state of the driver
+ * and the XTAL trim, PLL coarse code and antenna delays applied to the device into a warm context, see ull_initialise_warm().
+ *
+ * input parameters
+ * @param dw - DW3720 chip descriptor handler.
+ *
+ * output parameters
+ * @param ctx - pointer to the warm context to fill in
+ *
+ * returns DWT_SUCCESS for success, or DWT_ERROR for error
+ */
+int32_t ull_savewarmcontext(dwchip_t *dw, dwt_warm_context_t *ctx)
+{
+    dwt_local_data_t *pdw3000local = LOCAL_DATA(dw);
+
+    if ((ctx == NULL) || (dw->priv == NULL))
+    {
+        return (int32_t)DWT_ERROR;
+    }
+
+    ctx->magic = DWT_WARM_CONTEXT_MAGIC;
+    ctx->partID = pdw3000local->partID;
+    ctx->lotID = pdw3000local->lotID;
+    ctx->sleepMode = pdw3000local->sleep_mode;
+    ctx->preambleLength = pdw3000local->preamble_len;
+    ctx->stsThreshold = pdw3000local->ststhreshold;
+    ctx->biasTune = 0U;
+    ctx->dgcOtpSet = (uint8_t)pdw3000local->dgc_otp_set;
+    ctx->vBatP = pdw3000local->vBatP;
+    ctx->tempP = pdw3000local->tempP;
+    ctx->temperature = pdw3000local->temperature;
+    ctx->vdddigOtp = pdw3000local->vdddig_otp;
+    ctx->vdddigCurrent = pdw3000local->vdddig_current;
+    ctx->otpRev = pdw3000local->otprev;
+    ctx->initXtrim = pdw3000local->init_xtrim;
+    ctx->channel = pdw3000local->channel;
+    ctx->stsConfig = pdw3000local->stsconfig;
+    ctx->ciaDiagnostic = pdw3000local->cia_diagnostic;
+    ctx->stsLength = (uint8_t)pdw3000local->stsLength;
+    ctx->longFrames = pdw3000local->longFrames;
+    ctx->disFce = pdw3000local->sys_cfg_dis_fce_bit_flag;
+    ctx->ldoBiasKick = 0U;
+
+    // ull_initialise() saves the LDO and BIAS kicks for the on-wake configuration, when they are programmed in OTP
+    if ((pdw3000local->sleep_mode & ((uint16_t)DWT_LOADLDO | (uint16_t)DWT_LOADBIAS)) != 0U)
+    {
+        ctx->ldoBiasKick = 1U;
+    }
+
+    // Values the device holds in registers
+    ctx->pllCoarseCode = dwt_read32bitoffsetreg(dw, PLL_COARSE_CODE_ID, 0U);
+    ctx->txAntennaDelay = dwt_read16bitoffsetreg(dw, TX_ANTD_ID, 0U);
+    ctx->rxAntennaDelay = dwt_read16bitoffsetreg(dw, CIA_CONF_ID, 0U);
+
+    ctx->crc = dwt_generatecrc8((const uint8_t *)ctx, (uint32_t)sizeof(dwt_warm_context_t) - 1UL, 0U);
+
+    return (int32_t)DWT_SUCCESS;
+}
+
+/*! ------------------------------------------------------------------------------------------------------------------
+ * @brief This function initialises the DW3720 transceiver from a warm context saved by ull_savewarmcontext():
+ * it does the same once only device configurations as ull_initialise(), taking the values from the context
+ * instead of reading them from OTP memory.
+ *
+ * NOTES:
+ * 1.it is assumed this function is called after a reset or on power up of the DW3720
+ *
+ * input parameters
+ * @param dw - DW3720 chip descriptor handler.
+ * @param ctx - pointer to the warm context.
+ *
+ * output parameters
+ *
+ * returns DWT_SUCCESS for success, or DWT_ERROR if the context is not valid
+ */
+int32_t ull_initialise_warm(dwchip_t *dw, const dwt_warm_context_t *ctx)
+{
+    if ((ctx == NULL) || (ctx->magic != DWT_WARM_CONTEXT_MAGIC)
+        || (dwt_generatecrc8((const uint8_t *)ctx, (uint32_t)sizeof(dwt_warm_context_t) - 1UL, 0U) != ctx->crc))
+    {
+        return (int32_t)DWT_ERROR;
+    }
+
+    dw->priv = dwt_local_data_get(dw);
+    if (dw->priv == NULL)
+    {
+        return (int32_t)DWT_ERROR;
+    }
+    dwt_local_data_t *pdw3000local = (dwt_local_data_t *)dw->priv;
+
+    dwt_localstruct_init(pdw3000local);
+
+    pdw3000local->partID = ctx->partID;
+    pdw3000local->lotID = ctx->lotID;
+    pdw3000local->sleep_mode = ctx->sleepMode;
+    pdw3000local->preamble_len = ctx->preambleLength;
+    pdw3000local->ststhreshold = ctx->stsThreshold;
+    pdw3000local->dgc_otp_set = ctx->dgcOtpSet;
+    pdw3000local->vBatP = ctx->vBatP;
+    pdw3000local->tempP = ctx->tempP;
+    pdw3000local->temperature = ctx->temperature;
+    pdw3000local->vdddig_otp = ctx->vdddigOtp;
+    pdw3000local->vdddig_current = ctx->vdddigCurrent;
+    pdw3000local->otprev = ctx->otpRev;
+    pdw3000local->init_xtrim = ctx->initXtrim;
+    pdw3000local->channel = ctx->channel;
+    pdw3000local->stsconfig = ctx->stsConfig;
+    pdw3000local->cia_diagnostic = ctx->ciaDiagnostic;
+    pdw3000local->stsLength = (dwt_sts_lengths_e)ctx->stsLength;
+    pdw3000local->longFrames = ctx->longFrames;
+    pdw3000local->sys_cfg_dis_fce_bit_flag = ctx->disFce;
+
+    if (ctx->ldoBiasKick != 0U)
+    {
+        dwt_or16bitoffsetreg(dw, OTP_CFG_ID, 0U, LDO_BIAS_KICK_E0);
+        pdw3000local->sleep_mode |= (uint16_t)DWT_LOADLDO | (uint16_t)DWT_LOADBIAS; // save the kicks for the on-wake configuration
+    }
+
+#ifdef AUTO_PLL_CAL
+    ull_set_vdddig_mv(dw, VDDDIG_88mV);
+#endif
+
+    dwt_write8bitoffsetreg(dw, XTAL_ID, 0U, pdw3000local->init_xtrim);
+    if (ctx->pllCoarseCode != 0UL)
+    {
+        dwt_write32bitoffsetreg(dw, PLL_COARSE_CODE_ID, 0U, ctx->pllCoarseCode);
+    }
+    dwt_write32bitreg(dw, TX_CTRL_LO_ID, TX_CTRL_LO_DEF);
+    dwt_write16bitoffsetreg(dw, TX_ANTD_ID, 0U, ctx->txAntennaDelay);
+    dwt_write16bitoffsetreg(dw, CIA_CONF_ID, 0U, ctx->rxAntennaDelay);
+
+    return (int32_t)DWT_SUCCESS;
+} // end ull_initialise_warm()
+
 /*! ------------------------------------------------------------------------------------------------------------------
  * @brief
  * This function checks if PLL is locked or not.
@@ -1344,6 +2260,31 @@ int8_t ull_getpllcaltemperature(dwchip_t *dw)
     return LOCAL_DATA(dw)->temperature;
 }
 
+/*! ------------------------------------------------------------------------------------------------------------------
+ * @brief This function sets a cache of PLL calibration results. The automotive PLL calibration then starts from the
+ *        coarse code which locked last time on the same channel in the same temperature bin, and stores the coarse
+ *        code it locked on.
+ *
+ * input parameters
+ * @param dw - DW3720 chip descriptor handler.
+ * @param cache - pointer to the cache owned by the caller, NULL to not use a cache
+ *
+ * output parameters none
+ *
+ * returns DWT_SUCCESS, or DWT_ERROR if AUTO_PLL_CAL is not defined
+ */
+int32_t ull_setpllcalcache(dwchip_t *dw, dwt_pll_cal_cache_t *cache)
+{
+#ifdef AUTO_PLL_CAL
+    LOCAL_DATA(dw)->pll_cal_cache = cache;
+    return (int32_t)DWT_SUCCESS;
+#else
+    (void)dw;
+    (void)cache;
+    return (int32_t)DWT_ERROR;
+#endif
+}
+
 /*! ------------------------------------------------------------------------------------------------------------------
  * @brief Returns the PG delay value of the TX
  *
@@ -2523,6 +3464,48 @@ int32_t ull_writetxdata(dwchip_t *dw, uint16_t txDataLength, uint8_t *txDataByte
     }
 } // end ull_writetxdata()
 
+/*! ------------------------------------------------------------------------------------------------------------------
+ * @brief This API function starts writing the supplied TX data into the DW IC's TX buffer without waiting for the
+ *        SPI transfer to complete, see ull_writetxdata().
+ *
+ * input parameters
+ * @param dw - DW3720 chip descriptor handler.
+ * @param txDataLength   - This is the total length of data (in bytes) to write to the tx buffer.
+ * @param txDataBytes    - Pointer to the user's buffer containing the data to send, must stay valid until cb is called
+ * @param txBufferOffset - This specifies an offset in the DW IC's TX Buffer at which to start writing data.
+ * @param cb             - function called when the transfer has completed (can be NULL)
+ * @param user_data      - pointer passed to cb
+ *
+ * output parameters
+ *
+ * returns DWT_SUCCESS if the transfer was started, or DWT_ERROR for error
+ */
+int32_t ull_writetxdata_async(dwchip_t *dw, uint16_t txDataLength, uint8_t *txDataBytes, uint16_t txBufferOffset,
+    dwt_spi_done_cb_t cb, void *user_data)
+{
+    int32_t retVal = (int32_t)DWT_ERROR;
+
+    if ((LOCAL_DATA(dw)->async_busy == 0U) && ((txBufferOffset + txDataLength) < TX_BUFFER_MAX_LEN))
+    {
+        if (txBufferOffset <= REG_DIRECT_OFFSET_MAX_LEN)
+        {
+            /* Directly write the data to the IC TX buffer */
+            retVal = dwt_xfer3xxx_async(dw, TX_BUFFER_ID, txBufferOffset, txDataLength, txDataBytes, DW3000_SPI_WR_BIT, cb, user_data);
+        }
+        else
+        {
+            /* Program the indirect offset register A for specified offset to TX buffer */
+            dwt_write32bitreg(dw, INDIRECT_ADDR_A_ID, (TX_BUFFER_ID >> 16UL));
+            dwt_write32bitreg(dw, ADDR_OFFSET_A_ID, txBufferOffset);
+
+            /* Indirectly write the data to the IC TX buffer */
+            retVal = dwt_xfer3xxx_async(dw, INDIRECT_POINTER_A_ID, 0U, txDataLength, txDataBytes, DW3000_SPI_WR_BIT, cb, user_data);
+        }
+    }
+
+    return retVal;
+} // end ull_writetxdata_async()
+
 /*! ------------------------------------------------------------------------------------------------------------------
  * @brief This API function configures the TX frame control register before the transmission of a frame
  *
@@ -2551,6 +3534,7 @@ void ull_writetxfctrl(dwchip_t *dw, uint16_t txFrameLength, uint16_t txBufferOff
         // Write the frame length to the TX frame control register
         reg32 = txFrameLength | ((uint32_t)(txBufferOffset) << TX_FCTRL_TXB_OFFSET_BIT_OFFSET) | ((uint32_t)ranging << TX_FCTRL_TR_BIT_OFFSET);
         dwt_modify32bitoffsetreg(dw, TX_FCTRL_ID, 0U, ~(TX_FCTRL_TXB_OFFSET_BIT_MASK | TX_FCTRL_TR_BIT_MASK | TX_FCTRL_TXFLEN_BIT_MASK), reg32);
+        LOCAL_DATA(dw)->tx_fctrl = reg32;
     }
     else
     {
@@ -2558,6 +3542,7 @@ void ull_writetxfctrl(dwchip_t *dw, uint16_t txFrameLength, uint16_t txBufferOff
         reg32 = txFrameLength | ((uint32_t)(txBufferOffset + DWT_TX_BUFF_OFFSET_ADJUST) << TX_FCTRL_TXB_OFFSET_BIT_OFFSET)
                 | ((uint32_t)ranging << TX_FCTRL_TR_BIT_OFFSET);
         dwt_modify32bitoffsetreg(dw, TX_FCTRL_ID, 0U, ~(TX_FCTRL_TXB_OFFSET_BIT_MASK | TX_FCTRL_TR_BIT_MASK | TX_FCTRL_TXFLEN_BIT_MASK), reg32);
+        LOCAL_DATA(dw)->tx_fctrl = reg32;
     }
 
 } // end ull_writetxfctrl()
@@ -2674,6 +3659,58 @@ void ull_readrxdata(dwchip_t *dw, uint8_t *buffer, uint16_t length, uint16_t rxB
     }
 }
 
+/*! ------------------------------------------------------------------------------------------------------------------
+ * @brief This is used to start reading the data from the RX buffer without waiting for the SPI transfer to complete,
+ *        see ull_readrxdata().
+ *
+ * input parameters
+ * @param dw - DW3720 chip descriptor handler.
+ * @param buffer - the buffer into which the data will be read, must stay valid until cb is called
+ * @param length - the length of data to read (in bytes)
+ * @param rxBufferOffset - the offset in the rx buffer from which to read the data
+ * @param cb - function called when the transfer has completed (can be NULL)
+ * @param user_data - pointer passed to cb
+ *
+ * output parameters
+ *
+ * returns DWT_SUCCESS if the transfer was started, or DWT_ERROR for error
+ */
+int32_t ull_readrxdata_async(dwchip_t *dw, uint8_t *buffer, uint16_t length, uint16_t rxBufferOffset,
+    dwt_spi_done_cb_t cb, void *user_data)
+{
+    int32_t retVal = (int32_t)DWT_ERROR;
+    uint32_t rx_buff_addr;
+
+    if (LOCAL_DATA(dw)->dblbuffon == (uint8_t)DBL_BUFF_ACCESS_BUFFER_1) // if the flag is 0x3 we are reading from RX_BUFFER_1
+    {
+        rx_buff_addr = RX_BUFFER_1_ID;
+    }
+    else // reading from RX_BUFFER_0 - also when non-double buffer mode
+    {
+        rx_buff_addr = RX_BUFFER_0_ID;
+    }
+
+    if ((LOCAL_DATA(dw)->async_busy == 0U) && ((rxBufferOffset + length) <= RX_BUFFER_MAX_LEN))
+    {
+        if (rxBufferOffset <= REG_DIRECT_OFFSET_MAX_LEN)
+        {
+            /* Directly read data from the IC to the buffer */
+            retVal = dwt_xfer3xxx_async(dw, rx_buff_addr, rxBufferOffset, length, buffer, DW3000_SPI_RD_BIT, cb, user_data);
+        }
+        else
+        {
+            /* Program the indirect offset registers B for specified offset to RX buffer */
+            dwt_write32bitreg(dw, INDIRECT_ADDR_A_ID, (rx_buff_addr >> 16UL));
+            dwt_write32bitreg(dw, ADDR_OFFSET_A_ID, (uint32_t)rxBufferOffset);
+
+            /* Indirectly read data from the IC to the buffer */
+            retVal = dwt_xfer3xxx_async(dw, INDIRECT_POINTER_A_ID, 0U, length, buffer, DW3000_SPI_RD_BIT, cb, user_data);
+        }
+    }
+
+    return retVal;
+}
+
 /*! ------------------------------------------------------------------------------------------------------------------
  * @brief This is used to read the 18 bit data from the Accumulator buffer, from an offset location give by offset parameter
  *        for 18 bit complex samples, each sample is 6 bytes (3 real and 3 imaginary)
@@ -2727,6 +3764,15 @@ static void ull_readaccdata(dwchip_t *dw, uint8_t *buffer, uint16_t length, uint
     dwt_and16bitoffsetreg(dw, CLK_CTRL_ID, 0x0U, (uint16_t) ~(CLK_CTRL_ACC_MCLK_EN_BIT_MASK | CLK_CTRL_ACC_CLK_EN_BIT_MASK));
 }
 
+#ifdef DWT_ENABLE_CIR
+/* Buffers of the CIR read functions, which do not run at the same time. The leading byte is unused when reading
+ * from the accumulator */
+static union
+{
+    uint8_t cir[1U + (6U * CHUNK_CIR_NB_SAMP)];
+    uint8_t stream[2][1U + (6U * CHUNK_CIR_STREAM_NB_SAMP)];
+} dwt_cir_scratch;
+
 /*!
  * This is used to read complex samples from the CIR/Accumulator buffer specifying the read mode.
  *
@@ -2756,7 +3802,7 @@ static void ull_readaccdata(dwchip_t *dw, uint8_t *buffer, uint16_t length, uint
 static void ull_readcir(dwchip_t *dw, uint32_t *buffer, dwt_acc_idx_e cir_idx, uint16_t sample_offs,
                     uint16_t num_samples, dwt_cir_read_mode_e mode)
 {
-    static uint8_t buf_read[ 1U + (6U * CHUNK_CIR_NB_SAMP)];/* +1 as one leading byte unused when reading from Accumulator */
+    uint8_t *buf_read = dwt_cir_scratch.cir;
     uint16_t accOffset;
     uint16_t nb_samp_out = 0U, samp_to_read;
     uint8_t *p_wr = (uint8_t*)buffer;
@@ -2852,49 +3898,242 @@ static void ull_readcir(dwchip_t *dw, uint32_t *buffer, dwt_acc_idx_e cir_idx, u
                 // Extend the sign in the 32bit sample
                 current_sample_32bit = (current_sample_24bit & DWT_CIR_VALUE_NO_SIGN_18BIT_MASK) | sign_extended_32bit;
 
-                // Shift as follow:
-                // Reduced 32-bit complex samples: bits [15:0] for real/imag parts if DWT_CIR_READ_LO, no shift
-                // Reduced 32-bit complex samples: bits [16:1] for real/imag parts if DWT_CIR_READ_MID, shift by 1
-                // Reduced 32-bit complex samples: bits [17:2] for real/imag parts if DWT_CIR_READ_HI, shift by 2
-                if(mode == DWT_CIR_READ_MID)
-                {
-                    current_sample_32bit = (current_sample_32bit >> 1UL) | sign_extended_32bit; // Keep sign extension
-                }else if(mode == DWT_CIR_READ_HI)
-                {
-                    current_sample_32bit = (current_sample_32bit >> 2UL) | sign_extended_32bit; // Keep sign extension
-                }
-                else
-                {
-                    // Do nothing
-                }
-                
-                current_sample_signed = (int32_t)current_sample_32bit;
+                // Shift as follow:
+                // Reduced 32-bit complex samples: bits [15:0] for real/imag parts if DWT_CIR_READ_LO, no shift
+                // Reduced 32-bit complex samples: bits [16:1] for real/imag parts if DWT_CIR_READ_MID, shift by 1
+                // Reduced 32-bit complex samples: bits [17:2] for real/imag parts if DWT_CIR_READ_HI, shift by 2
+                if(mode == DWT_CIR_READ_MID)
+                {
+                    current_sample_32bit = (current_sample_32bit >> 1UL) | sign_extended_32bit; // Keep sign extension
+                }else if(mode == DWT_CIR_READ_HI)
+                {
+                    current_sample_32bit = (current_sample_32bit >> 2UL) | sign_extended_32bit; // Keep sign extension
+                }
+                else
+                {
+                    // Do nothing
+                }
+                
+                current_sample_signed = (int32_t)current_sample_32bit;
+
+                /* Check for saturation */
+                if(current_sample_signed > 32767)
+                {
+                    current_sample_signed = 32767;
+                }
+                else if(current_sample_signed < -32768)
+                {
+                    current_sample_signed = -32768;
+                }   
+                else
+                {
+                    // Do nothing
+                }
+
+                // Convert into 16 bits and output the data
+                p_wr_s16[(2U * nb_samp_out) + k ] = (int16_t)current_sample_signed;
+                p_rd += 3U; /*  CIR samples real/imag are read as 24 bits long from HW CIR */
+            }
+        }
+
+        nb_samp_out += samp_to_read;
+    }
+    // Revert clocks back
+    dwt_and16bitoffsetreg(dw, CLK_CTRL_ID, 0x0U, (uint16_t) ~(CLK_CTRL_ACC_MCLK_EN_BIT_MASK | CLK_CTRL_ACC_CLK_EN_BIT_MASK));
+}
+
+/*! ------------------------------------------------------------------------------------------------------------------
+ * @brief This is used to pack the samples of one streamed CIR chunk in place, see dwt_cir_pack_e
+ *
+ * input parameters
+ * @param data - the chunk, num_samples 48-bit complex samples as read from the accumulator
+ * @param num_samples - the number of complex samples in the chunk
+ * @param pack - the packing format
+ *
+ * output parameters
+ * @param exponent - the right shift applied to all samples for DWT_CIR_PACK_BFP16, else 0
+ *
+ * return value - the number of bytes of packed data at the start of data
+ */
+static uint16_t ull_cir_pack_chunk(uint8_t *data, uint16_t num_samples, dwt_cir_pack_e pack, uint8_t *exponent)
+{
+    uint16_t out = 0U;
+    uint32_t sample;
+    uint32_t sign;
+    uint32_t bits = 0UL;
+    uint8_t nbits = 0U;
+    uint32_t max_mag = 0UL;
+
+    *exponent = 0U;
+
+    switch (pack)
+    {
+    case DWT_CIR_PACK_18B:
+        // 18 bit two's complement parts back to back, LSB first; the output never overtakes the 3 byte input parts
+        for (uint16_t k = 0U; k < (2U * num_samples); k++)
+        {
+            sample = (uint32_t)data[3U * k] | ((uint32_t)data[(3U * k) + 1U] << 8UL) | ((uint32_t)data[(3U * k) + 2U] << 16UL);
+            bits |= (sample & DWT_CIR_VALUE_NO_SIGN_18BIT_MASK) << nbits;
+            nbits += 18U;
+            while (nbits >= 8U)
+            {
+                data[out++] = (uint8_t)bits;
+                bits >>= 8UL;
+                nbits -= 8U;
+            }
+        }
+        if (nbits != 0U)
+        {
+            data[out++] = (uint8_t)bits; // odd number of samples, pad the last byte
+        }
+        break;
+
+    case DWT_CIR_PACK_BFP16:
+        // find the largest magnitude in the chunk to select the common exponent (0..2 for 18 bit parts)
+        for (uint16_t k = 0U; k < (2U * num_samples); k++)
+        {
+            sample = ((uint32_t)data[3U * k] | ((uint32_t)data[(3U * k) + 1U] << 8UL) | ((uint32_t)data[(3U * k) + 2U] << 16UL))
+                     & DWT_CIR_VALUE_NO_SIGN_18BIT_MASK;
+            if ((sample & 0x20000UL) != 0UL)
+            {
+                sample = ~sample & DWT_CIR_VALUE_NO_SIGN_18BIT_MASK; // -x - 1, so that -32768 still fits with exponent 0
+            }
+            if (sample > max_mag)
+            {
+                max_mag = sample;
+            }
+        }
+        while ((max_mag >> *exponent) > 0x7FFFUL)
+        {
+            (*exponent)++;
+        }
+
+        for (uint16_t k = 0U; k < (2U * num_samples); k++)
+        {
+            sample = ((uint32_t)data[3U * k] | ((uint32_t)data[(3U * k) + 1U] << 8UL) | ((uint32_t)data[(3U * k) + 2U] << 16UL))
+                     & DWT_CIR_VALUE_NO_SIGN_18BIT_MASK;
+            sign = ((sample & 0x20000UL) != 0UL) ? DWT_CIR_SIGN_24BIT_EXTEND_32BIT_MASK : 0UL;
+            sample = ((sample | sign) >> *exponent) | sign; // keep sign extension
+            data[out++] = (uint8_t)sample;
+            data[out++] = (uint8_t)(sample >> 8UL);
+        }
+        break;
+
+    default: // DWT_CIR_PACK_48B, nothing to do
+        out = 6U * num_samples;
+        break;
+    }
+
+    return out;
+}
+
+/*! ------------------------------------------------------------------------------------------------------------------
+ * @brief This is used to stream a window of the CIR/Accumulator buffer to a sink, in chunks of up to
+ *        CHUNK_CIR_STREAM_NB_SAMP complex samples. While a chunk is packed and passed to the sink, the next chunk is
+ *        already read with an asynchronous SPI transfer (if the SPI interface supports it).
+ *
+ * NOTE: The sink is called while the next chunk transfer is in flight, so it must not access the DW3720. To read a
+ *       window around the first path, use the first path index from dwt_readdiagnostics_acc() (FpIndex >> 6) minus
+ *       the number of samples wanted before it as sample_offs.
+ *
+ * input parameters
+ * @param dw - DW3720 chip descriptor handler.
+ * @param acc_idx - accumulator index (dwt_acc_idx_e)
+ * @param sample_offs - the sample index offset within the selected accumulator to start reading from
+ * @param num_samples - the number of complex samples to read
+ * @param pack - packing of the samples passed to the sink, see dwt_cir_pack_e
+ * @param sink - function called with every packed chunk, a return value other than DWT_SUCCESS stops the stream
+ * @param user_data - pointer passed to sink
+ *
+ * output parameters
+ *
+ * return value - DWT_SUCCESS, or DWT_ERROR for invalid parameters, if an asynchronous SPI transfer is pending or if a
+ *                chunk transfer failed
+ */
+int32_t ull_readcir_stream(dwchip_t *dw, dwt_acc_idx_e acc_idx, uint16_t sample_offs, uint16_t num_samples,
+    dwt_cir_pack_e pack, dwt_cir_sink_cb_t sink, void *user_data)
+{
+    uint8_t (*buf_read)[1U + (6U * CHUNK_CIR_STREAM_NB_SAMP)] = dwt_cir_scratch.stream;
+    uint16_t accOffset;
+    uint16_t nb_samp_out = 0U;
+    uint16_t nb_samp_next;
+    uint16_t nb_samp_left;
+    uint16_t samp_in_buf[2];
+    uint8_t cur = 0U;
+    uint8_t exponent;
+    uint16_t length;
+    int32_t ret;
+
+    if ((acc_idx > DWT_ACC_IDX_STS1_M) || (sink == NULL))
+    {
+        return (int32_t)DWT_ERROR;
+    }
+
+    accOffset = dwt_cir_acc_offset[acc_idx] + sample_offs;
+    if ((accOffset + num_samples) > ACC_BUFFER_MAX_LEN)
+    {
+        num_samples = (accOffset < ACC_BUFFER_MAX_LEN) ? (uint16_t)(ACC_BUFFER_MAX_LEN - accOffset) : 0U;
+    }
+
+    if (num_samples == 0U)
+    {
+        return (int32_t)DWT_SUCCESS;
+    }
+
+    // Force on the ACC clocks if we are sequenced
+    dwt_or16bitoffsetreg(dw, CLK_CTRL_ID, 0x0U, CLK_CTRL_ACC_MCLK_EN_BIT_MASK | CLK_CTRL_ACC_CLK_EN_BIT_MASK);
+    dwt_write32bitreg(dw, INDIRECT_ADDR_A_ID, (ACC_MEM_ID >> 16UL));
+
+    // start reading the first chunk
+    samp_in_buf[0] = (num_samples >= CHUNK_CIR_STREAM_NB_SAMP) ? CHUNK_CIR_STREAM_NB_SAMP : num_samples;
+    samp_in_buf[1] = 0U;
+    dwt_write32bitreg(dw, ADDR_OFFSET_A_ID, (uint32_t)accOffset);
+    ret = dwt_xfer3xxx_async(dw, INDIRECT_POINTER_A_ID, 0U, 1U + (6U * samp_in_buf[0]), buf_read[0], DW3000_SPI_RD_BIT, NULL, NULL);
+    nb_samp_next = samp_in_buf[0];
+
+    while ((ret == (int32_t)DWT_SUCCESS) && (nb_samp_out < num_samples))
+    {
+        // wait for the chunk transfer to complete
+        ret = dwt_xfer3xxx_async_wait(dw);
+        if (ret != (int32_t)DWT_SUCCESS)
+        {
+            break;
+        }
 
-                /* Check for saturation */
-                if(current_sample_signed > 32767)
-                {
-                    current_sample_signed = 32767;
-                }
-                else if(current_sample_signed < -32768)
-                {
-                    current_sample_signed = -32768;
-                }   
-                else
-                {
-                    // Do nothing
-                }
+        // start reading the next chunk while this one is packed and passed to the sink
+        if (nb_samp_next < num_samples)
+        {
+            nb_samp_left = (uint16_t)(num_samples - nb_samp_next);
+            samp_in_buf[cur ^ 1U] = (nb_samp_left >= CHUNK_CIR_STREAM_NB_SAMP) ? CHUNK_CIR_STREAM_NB_SAMP : nb_samp_left;
+            dwt_write32bitreg(dw, ADDR_OFFSET_A_ID, (uint32_t)accOffset + (uint32_t)nb_samp_next);
+            ret = dwt_xfer3xxx_async(dw, INDIRECT_POINTER_A_ID, 0U, 1U + (6U * samp_in_buf[cur ^ 1U]), buf_read[cur ^ 1U],
+                DW3000_SPI_RD_BIT, NULL, NULL);
+            nb_samp_next += samp_in_buf[cur ^ 1U];
+        }
 
-                // Convert into 16 bits and output the data
-                p_wr_s16[(2U * nb_samp_out) + k ] = (int16_t)current_sample_signed;
-                p_rd += 3U; /*  CIR samples real/imag are read as 24 bits long from HW CIR */
-            }
+        /* 1st byte shall be ignored when reading from Accumulator */
+        length = ull_cir_pack_chunk(&buf_read[cur][1], samp_in_buf[cur], pack, &exponent);
+        nb_samp_out += samp_in_buf[cur];
+        if (sink(&buf_read[cur][1], length, samp_in_buf[cur], exponent, user_data) != (int32_t)DWT_SUCCESS)
+        {
+            break; // stopped by the sink, only wait for the chunk in flight
         }
 
-        nb_samp_out += samp_to_read;
+        cur ^= 1U;
+    }
+
+    // wait for a chunk transfer still in flight
+    if (dwt_xfer3xxx_async_wait(dw) != (int32_t)DWT_SUCCESS)
+    {
+        ret = (int32_t)DWT_ERROR;
     }
+
     // Revert clocks back
     dwt_and16bitoffsetreg(dw, CLK_CTRL_ID, 0x0U, (uint16_t) ~(CLK_CTRL_ACC_MCLK_EN_BIT_MASK | CLK_CTRL_ACC_CLK_EN_BIT_MASK));
+
+    return ret;
 }
+#endif // DWT_ENABLE_CIR
 
 /*! ------------------------------------------------------------------------------------------------------------------
  * @brief This is used to read the crystal offset (relating to the frequency offset of the far UWB radio device compared to this one)
@@ -3062,7 +4301,13 @@ void ull_readdiagnostics(dwchip_t *dw, dwt_rxdiag_t *diagnostics)
     uint16_t ip_length_min = IP_TOA_LO_IP_TOA_BIT_LEN + (IP_TOA_LO_LEN * 2U);
     uint32_t offset_buff = BUF0_RX_FINFO;
     // address from 0xC0000 to 0xD0068 (108*2 bytes) - when using normal mode, or 232 length for max logging when in Double Buffer mode
+#ifdef DWT_ENABLE_FULL_DIAG
     uint8_t temp[DB_MAX_DIAG_SIZE];
+    uint8_t cia_diag = LOCAL_DATA(dw)->cia_diagnostic;
+#else
+    uint8_t temp[DIAG_MIN_BUF_LEN];
+    uint8_t cia_diag = (uint8_t)DW_CIA_DIAG_LOG_MIN; // the read is bounded to the minimal diagnostics
+#endif
     // minimal diagnostics - 40 bytes
 
     switch ((dwt_dbl_buff_conf_e)LOCAL_DATA(dw)->dblbuffon)
@@ -3076,11 +4321,11 @@ void ull_readdiagnostics(dwchip_t *dw, dwt_rxdiag_t *diagnostics)
             /* Program the indirect offset registers B for specified offset to swinging set buffer B */
             //!!! Assumes that Indirect pointer register B was already set. This is done in the dwt_setdblrxbuffmode when mode is enabled.
             /* Indirectly read data from the IC to the buffer */
-            if ((LOCAL_DATA(dw)->cia_diagnostic & (uint8_t)DW_CIA_DIAG_LOG_MAX) != 0U)
+            if ((cia_diag & (uint8_t)DW_CIA_DIAG_LOG_MAX) != 0U)
             {
                 ull_readfromdevice(dw, INDIRECT_POINTER_B_ID, 0U, DB_MAX_DIAG_SIZE, temp);
             }
-            else if ((LOCAL_DATA(dw)->cia_diagnostic & (uint8_t)DW_CIA_DIAG_LOG_MID) != 0U)
+            else if ((cia_diag & (uint8_t)DW_CIA_DIAG_LOG_MID) != 0U)
             {
                 ull_readfromdevice(dw, INDIRECT_POINTER_B_ID, 0U, DB_MID_DIAG_SIZE, temp);
             }
@@ -3091,11 +4336,11 @@ void ull_readdiagnostics(dwchip_t *dw, dwt_rxdiag_t *diagnostics)
         }
         else
         {
-            if ((LOCAL_DATA(dw)->cia_diagnostic & (uint8_t)DW_CIA_DIAG_LOG_MAX) != 0U)
+            if ((cia_diag & (uint8_t)DW_CIA_DIAG_LOG_MAX) != 0U)
             {
                 ull_readfromdevice(dw, offset_buff, 0U, DB_MAX_DIAG_SIZE, temp);
             }
-            else if ((LOCAL_DATA(dw)->cia_diagnostic & (uint8_t)DW_CIA_DIAG_LOG_MID) != 0U)
+            else if ((cia_diag & (uint8_t)DW_CIA_DIAG_LOG_MID) != 0U)
             {
                 ull_readfromdevice(dw, offset_buff, 0U, DB_MID_DIAG_SIZE, temp);
             }
@@ -3129,7 +4374,7 @@ void ull_readdiagnostics(dwchip_t *dw, dwt_rxdiag_t *diagnostics)
         diagnostics->ipatovAccumCount = ((((uint16_t)temp[BUF0_IP_DIAG_12 - BUF0_RX_FINFO + 1UL] << 8U) |
                                            (uint16_t)temp[BUF0_IP_DIAG_12 - BUF0_RX_FINFO]) & 0xFFFU);
 
-        if ((LOCAL_DATA(dw)->cia_diagnostic & (uint8_t)DW_CIA_DIAG_LOG_MIN) != 0U)
+        if ((cia_diag & (uint8_t)DW_CIA_DIAG_LOG_MIN) != 0U)
         {
             break;
         }
@@ -3163,7 +4408,7 @@ void ull_readdiagnostics(dwchip_t *dw, dwt_rxdiag_t *diagnostics)
         diagnostics->sts2POA = (((uint16_t)temp[BUF0_STS1_TS - BUF0_RX_FINFO + 2UL] << 8U) |
                                  (uint16_t)temp[BUF0_STS1_TS - BUF0_RX_FINFO + 1UL]);
 
-        if ((LOCAL_DATA(dw)->cia_diagnostic & (uint8_t)DW_CIA_DIAG_LOG_MID) != 0U)
+        if ((cia_diag & (uint8_t)DW_CIA_DIAG_LOG_MID) != 0U)
         {
             break;
         }
@@ -3284,7 +4529,7 @@ void ull_readdiagnostics(dwchip_t *dw, dwt_rxdiag_t *diagnostics)
 
     default: // double buffer is off
 
-        if ((LOCAL_DATA(dw)->cia_diagnostic & (uint8_t)DW_CIA_DIAG_LOG_ALL) != 0U)
+        if ((cia_diag & (uint8_t)DW_CIA_DIAG_LOG_ALL) != 0U)
         {
             ull_readfromdevice(dw, IP_TOA_LO_ID, 0U, (uint16_t)offset_0xd, temp);        // read form 0xC0000 space  (108 bytes)
             ull_readfromdevice(dw, STS_DIAG_4_ID, 0U, (uint16_t)offset_0xd, &temp[offset_0xd]); // read from 0xD0000 space  (108 bytes)
@@ -3350,7 +4595,7 @@ void ull_readdiagnostics(dwchip_t *dw, dwt_rxdiag_t *diagnostics)
                                    (uint32_t)temp[CIA_DIAG_1_ID - IP_TOA_LO_ID])
                                   & 0x1FFFFFFFUL);
 
-        if ((LOCAL_DATA(dw)->cia_diagnostic & (uint8_t)DW_CIA_DIAG_LOG_ALL) == 0U)
+        if ((cia_diag & (uint8_t)DW_CIA_DIAG_LOG_ALL) == 0U)
         {
             break; // break here is only logging minimal diagnostics
         }
@@ -3475,6 +4720,157 @@ void ull_readdiagnostics(dwchip_t *dw, dwt_rxdiag_t *diagnostics)
     diagnostics->tdoa[5] &= 0x01U; // TDoA is 41-bits
 }
 
+/*! ------------------------------------------------------------------------------------------------------------------
+ * @brief this function reads the per-frame RX report: the RX timestamps, clock offset, STS quality, PDOA and the
+ *        Ipatov first path power inputs. The register blocks holding these values are fetched in one SPI batch,
+ *        instead of the separate transactions issued by dwt_readrxtimestamp(), dwt_readclockoffset(),
+ *        dwt_readstsquality(), dwt_readpdoa() and dwt_readdiagnostics().
+ *
+ * NOTE: In double buffer mode only the values copied to the swinging set are available (DW_CIA_DIAG_LOG_MIN: RX
+ *       timestamp, clock offset, PDOA and accumulation count, DW_CIA_DIAG_LOG_MID: + Ipatov and STS timestamps,
+ *       DW_CIA_DIAG_LOG_MAX: + power and F1-F3), the other fields are set to zero.
+ *       In single buffer mode the power and F1-F3 values need DW_CIA_DIAG_LOG_ALL, else they read as 0.
+ *
+ * input parameters
+ * @param dw - DW3720 chip descriptor handler.
+ * @param report - RX report structure pointer, this will contain the data read from the DW3720
+ *
+ * output parameters
+ * return value - >=0 for good and < 0 if bad STS quality (see dwt_readstsquality()).
+ */
+int32_t ull_readrxreport(dwchip_t *dw, dwt_rxreport_t *report)
+{
+    dwt_batch_t batch;
+    uint8_t temp[RXREPORT_BLOCK_LEN];
+    uint8_t rx_time[RX_TIME_RX_STAMP_LEN];
+    uint8_t sts_qual[2];
+    uint8_t dgc_dbg;
+    uint16_t length;
+    uint16_t regval;
+    int32_t sts_qual_diff;
+    uint32_t o_rx_time, o_ip_ts, o_sts_ts, o_cia_diag_0, o_pdoa, o_accum, o_power, o_f1;
+    uint8_t *rx_time_buf;
+    dwt_dbl_buff_conf_e dblbuffon = (dwt_dbl_buff_conf_e)LOCAL_DATA(dw)->dblbuffon;
+
+    for (uint32_t i = 0UL; i < RXREPORT_BLOCK_LEN; i++)
+    {
+        temp[i] = 0U;
+    }
+
+    dwt_batch_begin(dw, &batch);
+
+    if ((dblbuffon == DBL_BUFF_ACCESS_BUFFER_0) || (dblbuffon == DBL_BUFF_ACCESS_BUFFER_1))
+    {
+        // the swinging set holds everything from RX_FINFO onwards, only read what the CIA was asked to copy there
+        if ((LOCAL_DATA(dw)->cia_diagnostic & (uint8_t)DW_CIA_DIAG_LOG_MAX) != 0U)
+        {
+            length = (uint16_t)RXREPORT_DB_MAX_LEN;
+        }
+        else if ((LOCAL_DATA(dw)->cia_diagnostic & (uint8_t)DW_CIA_DIAG_LOG_MID) != 0U)
+        {
+            length = DB_MID_DIAG_SIZE;
+        }
+        else
+        {
+            length = DB_MIN_DIAG_SIZE;
+        }
+
+        //!!! Assumes that Indirect pointer register B was already set. This is done in the dwt_setdblrxbuffmode when mode is enabled.
+        dwt_batch_read(dw, &batch, (dblbuffon == DBL_BUFF_ACCESS_BUFFER_1) ? INDIRECT_POINTER_B_ID : BUF0_RX_FINFO, 0U, length, temp);
+
+        rx_time_buf = temp;
+        o_rx_time = BUF0_RX_TIME - BUF0_RX_FINFO;
+        o_ip_ts = (length >= DB_MID_DIAG_SIZE) ? (BUF0_IP_TS - BUF0_RX_FINFO) : RXREPORT_ZERO_OFFSET;
+        o_sts_ts = (length >= DB_MID_DIAG_SIZE) ? (BUF0_STS_TS - BUF0_RX_FINFO) : RXREPORT_ZERO_OFFSET;
+        o_cia_diag_0 = BUF0_CIA_DIAG_0 - BUF0_RX_FINFO;
+        o_pdoa = BUF0_PDOA - BUF0_RX_FINFO;
+        o_accum = BUF0_IP_DIAG_12 - BUF0_RX_FINFO;
+        o_power = (length == RXREPORT_DB_MAX_LEN) ? (BUF0_IP_DIAG_1 - BUF0_RX_FINFO) : RXREPORT_ZERO_OFFSET;
+        o_f1 = (length == RXREPORT_DB_MAX_LEN) ? (BUF0_IP_DIAG_2 - BUF0_RX_FINFO) : RXREPORT_ZERO_OFFSET;
+    }
+    else
+    {
+        // Ipatov/STS timestamps, PDOA, clock offset and the Ipatov diagnostics are contiguous in the 0xC0000 space
+        dwt_batch_read(dw, &batch, (uint32_t)RX_TIME_0_ID, 0U, RX_TIME_RX_STAMP_LEN, rx_time);
+        dwt_batch_read(dw, &batch, IP_TOA_LO_ID, 0U, (uint16_t)RXREPORT_CIA_LEN, temp);
+
+        rx_time_buf = rx_time;
+        o_rx_time = 0UL;
+        o_ip_ts = 0UL;
+        o_sts_ts = STS_TOA_LO_ID - IP_TOA_LO_ID;
+        o_cia_diag_0 = CIA_DIAG_0_ID - IP_TOA_LO_ID;
+        o_pdoa = CIA_TDOA_1_PDOA_ID - IP_TOA_LO_ID;
+        o_accum = IP_DIAG_12_ID - IP_TOA_LO_ID;
+        o_power = IP_DIAG_1_ID - IP_TOA_LO_ID;
+        o_f1 = IP_DIAG_2_ID - IP_TOA_LO_ID;
+    }
+
+    dwt_batch_read(dw, &batch, STS_STS_ID, 0U, 2U, sts_qual);
+    dwt_batch_read(dw, &batch, DGC_DBG_ID, 3U, 1U, &dgc_dbg);
+    dwt_batch_commit(dw, &batch);
+
+    for (uint32_t i = 0UL; i < RX_TIME_RX_STAMP_LEN; i++)
+    {
+        report->rxTime[i] = rx_time_buf[i + o_rx_time];
+        report->ipatovRxTime[i] = temp[i + o_ip_ts];
+        report->stsRxTime[i] = temp[i + o_sts_ts];
+    }
+
+    // Estimated xtal offset of remote device, bit 12 is sign
+    regval = (((uint16_t)temp[o_cia_diag_0 + 1UL] << 8U) | (uint16_t)temp[o_cia_diag_0]) & CIA_DIAG_0_COE_PPM_BIT_MASK;
+    if ((regval & B12_U16_SIGN_EXTEND_TEST) != 0U)
+    {
+        regval |= B12_U16_SIGN_EXTEND_MASK;
+    }
+    report->clockOffset = (int16_t)regval;
+
+    // phase difference of the 2 POAs
+    regval = (((uint16_t)temp[o_pdoa + 3UL] << 8U) | (uint16_t)temp[o_pdoa + 2UL]) & (uint16_t)(CIA_TDOA_1_PDOA_PDOA_BIT_MASK >> 16UL);
+    if ((regval & B12_SIGN_EXTEND_TEST) != 0U)
+    {
+        regval |= (uint16_t)B12_SIGN_EXTEND_MASK;
+    }
+    report->pdoa = (int16_t)regval;
+
+    // STS preamble count value
+    regval = (((uint16_t)sts_qual[1] << 8U) | (uint16_t)sts_qual[0]) & STS_STS_ACC_QUAL_BIT_MASK;
+    if ((regval & STS_ACC_CP_QUAL_SIGNTST) != 0U)
+    {
+        regval |= STS_ACC_CP_QUAL_SIGNEXT;
+    }
+    report->stsQualityIndex = (int16_t)regval;
+    sts_qual_diff = (int32_t)report->stsQualityIndex - (int32_t)LOCAL_DATA(dw)->ststhreshold;
+
+    report->dgcDecision = (dgc_dbg & 0x70U) >> 4U;
+
+    // Ipatov first path power inputs, see dwt_calculate_first_path_power()
+    report->ipatovPower = ((((uint32_t)temp[o_power + 3UL] << 24UL) |
+                            ((uint32_t)temp[o_power + 2UL] << 16UL) |
+                            ((uint32_t)temp[o_power + 1UL] << 8UL) |
+                             (uint32_t)temp[o_power])
+                           & 0x1FFFFUL);
+    report->ipatovF1 = ((((uint32_t)temp[o_f1 + 3UL] << 24UL) |
+                         ((uint32_t)temp[o_f1 + 2UL] << 16UL) |
+                         ((uint32_t)temp[o_f1 + 1UL] << 8UL) |
+                          (uint32_t)temp[o_f1])
+                        & 0x3FFFFFUL);
+    report->ipatovF2 = ((((uint32_t)temp[o_f1 + 7UL] << 24UL) |
+                         ((uint32_t)temp[o_f1 + 6UL] << 16UL) |
+                         ((uint32_t)temp[o_f1 + 5UL] << 8UL) |
+                          (uint32_t)temp[o_f1 + 4UL])
+                        & 0x3FFFFFUL);
+    report->ipatovF3 = ((((uint32_t)temp[o_f1 + 11UL] << 24UL) |
+                         ((uint32_t)temp[o_f1 + 10UL] << 16UL) |
+                         ((uint32_t)temp[o_f1 + 9UL] << 8UL) |
+                          (uint32_t)temp[o_f1 + 8UL])
+                        & 0x3FFFFFUL);
+    // Number accumulated symbols [11:0] for Ipatov sequence
+    report->ipatovAccumCount = ((((uint16_t)temp[o_accum + 1UL] << 8U) | (uint16_t)temp[o_accum]) & 0xFFFU);
+
+    // determine if the STS Rx quality is good or bad (return >=0 for good and < 0 if bad)
+    return sts_qual_diff;
+}
+
 /*!
  * This function reads the CIA diagnostics for an individual accumulator.
  *
@@ -4164,6 +5560,7 @@ static uint32_t dwt_otpreadpintoparams(dwchip_t *dw, uint16_t address)
     return ret_data;
 }
 
+#ifdef DWT_ENABLE_OTP_WRITE
 /*! ------------------------------------------------------------------------------------------------------------------
  * @brief For each value to send to OTP bloc, following two register writes are required as shown below
  *
@@ -4346,6 +5743,7 @@ int32_t ull_otpwrite(dwchip_t *dw, uint32_t value, uint16_t address)
 
     return (int32_t)DWT_SUCCESS;
 }
+#endif // DWT_ENABLE_OTP_WRITE
 
 /*! ------------------------------------------------------------------------------------------------------------------
  * @brief This function puts the device into deep sleep or sleep. dwt_configuresleep() should be called first
@@ -4362,6 +5760,10 @@ int32_t ull_otpwrite(dwchip_t *dw, uint32_t value, uint16_t address)
  */
 void ull_entersleep(dwchip_t *dw, int32_t idle_rc)
 {
+#ifdef DWT_REG_CACHE
+    dwt_regcache_sleep(dw);
+#endif
+
     // OTP low power mode
     ull_dis_otp_ips(dw, 1);
 
@@ -4551,6 +5953,10 @@ void ull_clearaonconfig(dwchip_t *dw)
  */
 void ull_entersleepaftertx(dwchip_t *dw, int32_t enable)
 {
+#ifdef DWT_REG_CACHE
+    dwt_regcache_sleep(dw);
+#endif
+
     // OTP low power mode
     ull_dis_otp_ips(dw, 1);
 
@@ -4588,6 +5994,10 @@ void ull_entersleepafter(dwchip_t *dw, int32_t event_mask)
     uint16_t seq_ctrl_or = 0U;
     uint16_t seq_ctrl_and = 0xFFFFU;
 
+#ifdef DWT_REG_CACHE
+    dwt_regcache_sleep(dw);
+#endif
+
     // OTP low power mode
     ull_dis_otp_ips(dw, 1);
 
@@ -4645,7 +6055,15 @@ static int32_t ull_spicswakeup(dwchip_t *dw, uint8_t *buff, uint16_t length)
         ull_readfromdevice(dw, 0x0U, 0x0U, length, buff); // Do a long read to wake up the chip (hold the chip select low)
         // Need 5ms for XTAL to start and stabilize (could wait for PLL lock IRQ status bit !!!)
         // NOTE: Polling of the STATUS register is not possible unless frequency is < 3MHz
-        deca_sleep(5U);
+        if (dw->wait_device_ready != NULL)
+        {
+            // The platform waits for SPIRDY on the IRQ line, at most 5ms
+            (void)dw->wait_device_ready(5000UL);
+        }
+        else
+        {
+            deca_sleep(5U);
+        }
     }
     else
     {
@@ -4707,6 +6125,9 @@ int32_t ull_check_dev_id(dwchip_t *dw)
  */
 void ull_configciadiag(dwchip_t *dw, uint8_t enable_mask)
 {
+#ifndef DWT_ENABLE_FULL_DIAG
+    enable_mask &= (uint8_t)DW_CIA_DIAG_LOG_MIN;
+#endif
     if ((enable_mask & (uint8_t)DW_CIA_DIAG_LOG_ALL) != 0U)
     {
         dwt_and8bitoffsetreg(dw, CIA_CONF_ID, 2U, (uint8_t)(~CIA_DIAGNOSTIC_OFF));
@@ -4934,6 +6355,7 @@ static void ull_clear_cbData(dwt_cb_data_t* cbData)
     cbData->rx_flags = 0U;
     cbData->status = 0UL;
     cbData->status_hi = 0U;
+    cbData->rx_finfo = 0UL;
     cbData->dss_stat = 0U;
     cbData->dw = NULL;
 }
@@ -4965,16 +6387,49 @@ static void ull_clear_cbData(dwt_cb_data_t* cbData)
  */
 static void ull_isr(dwchip_t *dw)
 {
-    // Read Fast Status register
-    uint8_t fstat = dwt_read8bitoffsetreg(dw, FINT_STAT_ID, 0U);
-    uint32_t status = dwt_read32bitreg(dw, SYS_STATUS_ID); // Read status register low 32bits
+    dwt_batch_t batch;
+    uint8_t fstat;
+    uint32_t status;
     uint8_t statusDB = 0U;
-    uint16_t datalength = ull_getframelength(dw, &LOCAL_DATA(dw)->cbData.rx_flags); // Save previous frame data length
-    ull_clear_cbData(&LOCAL_DATA(dw)->cbData);
-    LOCAL_DATA(dw)->cbData.dw = dw;
+    uint16_t datalength;
+    uint16_t status_hi = 0U;
+    uint32_t finfo = 0UL;
+    bool fast_path = (LOCAL_DATA(dw)->dblbuffon == (uint8_t)DBL_BUFF_OFF);
     bool rx_ok_event;
     bool rxfce_error_event_no_payload;
 
+    if (fast_path)
+    {
+        // SYS_STATUS, SYS_STATUS_HI and RX_FINFO are contiguous: read them in one burst together with
+        // the Fast Status register, the values are cached in cbData so they do not need to be read again
+        uint8_t regs[ISR_STATUS_BURST_LEN];
+
+        dwt_batch_begin(dw, &batch);
+        dwt_batch_read(dw, &batch, FINT_STAT_ID, 0U, 1U, &fstat);
+        dwt_batch_read(dw, &batch, SYS_STATUS_ID, 0U, ISR_STATUS_BURST_LEN, regs);
+        dwt_batch_commit(dw, &batch);
+
+        status = ((uint32_t)regs[3] << 24UL) | ((uint32_t)regs[2] << 16UL) | ((uint32_t)regs[1] << 8UL) | (uint32_t)regs[0];
+        status_hi = (uint16_t)(((uint16_t)regs[SYS_STATUS_HI_ID - SYS_STATUS_ID + 1UL] << 8U) | (uint16_t)regs[SYS_STATUS_HI_ID - SYS_STATUS_ID]);
+        for (int32_t j = 3; j >= 0; j--)
+        {
+            finfo = (finfo << 8U) + regs[(RX_FINFO_ID - SYS_STATUS_ID) + (uint32_t)j];
+        }
+        datalength = ull_decodeframelength(dw, (uint16_t)finfo, &LOCAL_DATA(dw)->cbData.rx_flags); // Save previous frame data length
+    }
+    else
+    {
+        // Read Fast Status register
+        fstat = dwt_read8bitoffsetreg(dw, FINT_STAT_ID, 0U);
+        status = dwt_read32bitreg(dw, SYS_STATUS_ID); // Read status register low 32bits
+        datalength = ull_getframelength(dw, &LOCAL_DATA(dw)->cbData.rx_flags); // Save previous frame data length
+    }
+
+    ull_clear_cbData(&LOCAL_DATA(dw)->cbData);
+    LOCAL_DATA(dw)->cbData.dw = dw;
+    LOCAL_DATA(dw)->cbData.status_hi = status_hi;
+    LOCAL_DATA(dw)->cbData.rx_finfo = finfo;
+
     if (LOCAL_DATA(dw)->dblbuffon != 0U) // if in double buffer mode
     {
         statusDB = dwt_read8bitoffsetreg(dw, RDB_STATUS_ID, 0U);
@@ -5012,16 +6467,22 @@ static void ull_isr(dwchip_t *dw)
     // AES_ERR|SPICRCERR|BRNOUT|SPI_UNF|SPI_OVR|CMD_ERR|SPI_COLLISION|PLLHILO
     if ((fstat & FINT_STAT_SYS_PANIC_BIT_MASK) != 0U)
     {
-        LOCAL_DATA(dw)->cbData.status_hi = dwt_read16bitoffsetreg(dw, SYS_STATUS_HI_ID, 0U);
+        if (!fast_path)
+        {
+            LOCAL_DATA(dw)->cbData.status_hi = dwt_read16bitoffsetreg(dw, SYS_STATUS_HI_ID, 0U);
+        }
 
         // Handle SPI CRC error event, which was due to an SPI write CRC error
         // Handle SPI error events (if this has happened, the last SPI transaction has not completed correctly, the device should be reset)
         if (((LOCAL_DATA(dw)->spicrc != DWT_SPI_CRC_MODE_NO) && ((LOCAL_DATA(dw)->cbData.status & SYS_STATUS_SPICRCE_BIT_MASK) != 0UL)) ||
             ((LOCAL_DATA(dw)->cbData.status_hi & (SYS_STATUS_HI_SPIERR_BIT_MASK | SYS_STATUS_HI_SPI_UNF_BIT_MASK | SYS_STATUS_HI_SPI_OVF_BIT_MASK)) != 0U))
         {
-            dwt_write8bitoffsetreg(dw, SYS_STATUS_ID, 0U, SYS_STATUS_SPICRCE_BIT_MASK);
+            dwt_batch_begin(dw, &batch);
+            // all of SYS_STATUS is written (zero bits are not cleared), so the write to SYS_STATUS_HI is chained to it
+            dwt_batch_write(dw, &batch, SYS_STATUS_ID, 0U, 4U, SYS_STATUS_SPICRCE_BIT_MASK);
             // Clear SPI error event bits
-            dwt_write16bitoffsetreg(dw, SYS_STATUS_HI_ID, 0U, (SYS_STATUS_HI_SPIERR_BIT_MASK | SYS_STATUS_HI_SPI_UNF_BIT_MASK | SYS_STATUS_HI_SPI_OVF_BIT_MASK));
+            dwt_batch_write(dw, &batch, SYS_STATUS_HI_ID, 0U, 2U, (SYS_STATUS_HI_SPIERR_BIT_MASK | SYS_STATUS_HI_SPI_UNF_BIT_MASK | SYS_STATUS_HI_SPI_OVF_BIT_MASK));
+            dwt_batch_commit(dw, &batch);
             // Call the corresponding callback if present
             if (dw->callbacks.cbSPIErr != NULL)
             {
@@ -5049,10 +6510,12 @@ static void ull_isr(dwchip_t *dw)
         // Resetting to PLL_COMMON_CFG to default after a TX to ensure the
         // default bias trim value is used for the following RX
         // (in case DWT_RESPONSE_EXPECTED was set)
-        dwt_write32bitreg(dw, PLL_COMMON_ID, RF_PLL_COMMON);
+        dwt_batch_begin(dw, &batch);
+        dwt_batch_write(dw, &batch, PLL_COMMON_ID, 0U, 4U, RF_PLL_COMMON);
 
         // Clear TX events after the callback - this lets the host schedule another TX/RX inside the callback
-        dwt_write8bitoffsetreg(dw, SYS_STATUS_ID, 0U, SYS_STATUS_ALL_TX); // Clear TX event bits to clear the interrupt
+        dwt_batch_write(dw, &batch, SYS_STATUS_ID, 0U, 1U, SYS_STATUS_ALL_TX); // Clear TX event bits to clear the interrupt
+        dwt_batch_commit(dw, &batch);
 
         // Call the corresponding callback if present
         if (dw->callbacks.cbTxDone != NULL)
@@ -5061,6 +6524,22 @@ static void ull_isr(dwchip_t *dw)
         }
     }
 
+#ifdef DWT_ENABLE_AES
+    // Handle completion of an AES job started with ull_do_aes_async() with a callback, the jobs without one are
+    // completed by their ull_aes_poll() calls
+    if ((LOCAL_DATA(dw)->aes_job != NULL) && (LOCAL_DATA(dw)->aes_cb != NULL))
+    {
+        if (!fast_path)
+        {
+            status_hi = dwt_read16bitoffsetreg(dw, SYS_STATUS_HI_ID, 0U);
+        }
+        if ((status_hi & (SYS_STATUS_HI_AES_DONE_BIT_MASK | SYS_STATUS_HI_AES_ERR_BIT_MASK)) != 0U)
+        {
+            (void)ull_aes_poll(dw);
+        }
+    }
+#endif
+
     // SPI ready and IDLE_RC bit gets set when device powers on, or on wake up
     // TIMER0/1 events will also set the SYS_EVENT bit
     if ((fstat & FINT_STAT_SYS_EVENT_BIT_MASK) != 0U)
@@ -5078,6 +6557,18 @@ static void ull_isr(dwchip_t *dw)
         // VTDET, GPIO, not handled here ...
     }
 
+    // Handle TIMER0/1 expiry, clear the events before the callback so it can restart the timer
+    if ((status & (SYS_STATUS_TIMER0_BIT_MASK | SYS_STATUS_TIMER1_BIT_MASK)) != 0UL)
+    {
+        dwt_write8bitoffsetreg(dw, SYS_STATUS_ID, 3U, (uint8_t)((status & (SYS_STATUS_TIMER0_BIT_MASK | SYS_STATUS_TIMER1_BIT_MASK)) >> 24UL));
+
+        // Call the corresponding callback if present
+        if (dw->callbacks.cbSysEvent != NULL)
+        {
+            dw->callbacks.cbSysEvent(&LOCAL_DATA(dw)->cbData);
+        }
+    }
+
     rx_ok_event = ((fstat & FINT_STAT_RXOK_BIT_MASK) != 0U) || ((LOCAL_DATA(dw)->dblbuffon != 0U) && ((statusDB & RDB_STATUS_RXOK) != 0U));
     rxfce_error_event_no_payload = ((status & SYS_STATUS_RXFCE_BIT_MASK) != 0U) && (datalength == 0U) && (((uint8_t)dw->isrFlags & (uint8_t)DWT_LEN0_RXGOOD) != 0U);
     // Handle RX OK event, and RX FCE error event generated because the received frame has no payload (PEG-2043)
@@ -5122,7 +6613,14 @@ static void ull_isr(dwchip_t *dw)
             if (((status & SYS_STATUS_RXFCG_BIT_MASK) != 0UL) ||
                 (((status & SYS_STATUS_RXFR_BIT_MASK) != 0UL) && (LOCAL_DATA(dw)->sys_cfg_dis_fce_bit_flag == 1U)))
             {
-                (void)ull_getframelength(dw, &LOCAL_DATA(dw)->cbData.rx_flags);
+                if (fast_path)
+                {
+                    (void)ull_decodeframelength(dw, (uint16_t)finfo, &LOCAL_DATA(dw)->cbData.rx_flags);
+                }
+                else
+                {
+                    (void)ull_getframelength(dw, &LOCAL_DATA(dw)->cbData.rx_flags);
+                }
                 // If sys_cfg_dis_fce_bit_flag is set clear also FCE
                 if(LOCAL_DATA(dw)->sys_cfg_dis_fce_bit_flag != 0U)
                 {
@@ -5419,38 +6917,36 @@ static void dwt_adjust_delaytime(dwchip_t *dw, int32_t tx_rx)
 }
 
 /*! ------------------------------------------------------------------------------------------------------------------
- * @brief This call initiates the transmission, input parameter indicates which TX mode is used see below
+ * @brief  this function initiates the transmission like ull_starttx(), the TX command is added to the current batch
+ *         and the batch is committed. The caller has to call dwt_batch_begin() and hold the SPI bus.
  *
  * input parameters:
- * @param dw - DW3720 chip descriptor handler.
- * @param mode - if mode = DWT_START_TX_IMMEDIATE - immediate TX (no response expected)
- *               if mode = DWT_START_TX_DELAYED - delayed TX (no response expected)  at specified time (time in DX_TIME register)
- *               if mode = DWT_START_TX_DLY_REF - delayed TX (no response expected)  at specified time (time in DREF_TIME register + any time in DX_TIME
- * register) if mode = DWT_START_TX_DLY_RS  - delayed TX (no response expected)  at specified time (time in RX_TIME_0 register + any time in DX_TIME register)
- *               if mode = DWT_START_TX_DLY_TS  - delayed TX (no response expected)  at specified time (time in TX_TIME_LO register + any time in DX_TIME
- * register) if mode = DWT_START_TX_IMMEDIATE | DWT_RESPONSE_EXPECTED - immediate TX (response expected - so the receiver will be automatically turned on after
- * TX is done) if mode = DWT_START_TX_DELAYED/DLY_* | DWT_RESPONSE_EXPECTED - delayed TX (response expected - so the receiver will be automatically turned on
- * after TX is done) if mode = DWT_START_TX_CCA - Send the frame if no preamble detected within PTO time if mode = DWT_START_TX_CCA  | DWT_RESPONSE_EXPECTED -
- * Send the frame if no preamble detected within PTO time and then enable RX* output parameters
+ * @param dw         - DW3720 chip descriptor handler.
+ * @param batch      - the batch started by the caller
+ * @param mode       - TX mode, see ull_starttx()
  *
- * @returns DWT_SUCCESS for success, or DWT_ERROR for error (e.g. a delayed transmission will be cancelled if the delayed time has passed)
+ * output parameters
+ *
+ * returns DWT_SUCCESS for success, or DWT_ERROR for error (e.g. a delayed transmission will be cancelled if the delayed time has passed)
  */
-int32_t ull_starttx(dwchip_t *dw, uint8_t mode)
+static int32_t dwt_starttx_batch(dwchip_t *dw, dwt_batch_t *batch, uint8_t mode)
 {
     int32_t retval = (int32_t)DWT_SUCCESS;
-    uint16_t checkTxOK = 0U;
+    uint8_t checkTxOK = 0U;
 
     if (((mode & (uint8_t)DWT_START_TX_DELAYED) != 0U) || ((mode & (uint8_t)DWT_START_TX_DLY_REF)  != 0U) || ((mode & (uint8_t)DWT_START_TX_DLY_RS) != 0U) || ((mode & (uint8_t)DWT_START_TX_DLY_TS) != 0U))
     {
+        uint32_t cmd;
+
         if ((mode & (uint8_t)DWT_START_TX_DELAYED) != 0U) // delayed TX
         {
             if ((mode & (uint8_t)DWT_RESPONSE_EXPECTED) != 0U)
             {
-                dwt_writefastCMD(dw, CMD_DTX_W4R);
+                cmd = CMD_DTX_W4R;
             }
             else
             {
-                dwt_writefastCMD(dw, CMD_DTX);
+                cmd = CMD_DTX;
             }
         }
         else if ((mode & (uint8_t)DWT_START_TX_DLY_RS) != 0U) // delayed TX WRT RX timestamp
@@ -5459,79 +6955,239 @@ int32_t ull_starttx(dwchip_t *dw, uint8_t mode)
 
             if ((mode & (uint8_t)DWT_RESPONSE_EXPECTED) != 0U)
             {
-                dwt_writefastCMD(dw, CMD_DTX_RS_W4R);
+                cmd = CMD_DTX_RS_W4R;
             }
             else
             {
-                dwt_writefastCMD(dw, CMD_DTX_RS);
+                cmd = CMD_DTX_RS;
             }
         }
         else if ((mode & (uint8_t)DWT_START_TX_DLY_TS) != 0U) // delayed TX WRT TX timestamp
         {
             dwt_adjust_delaytime(dw, 1);
 
-            if ((mode & (uint8_t)DWT_RESPONSE_EXPECTED) != 0U)
-            {
-                dwt_writefastCMD(dw, CMD_DTX_TS_W4R);
-            }
-            else
-            {
-                dwt_writefastCMD(dw, CMD_DTX_TS);
-            }
-        }
-        else // delayed TX WRT reference time
-        {
-            if ((mode & (uint8_t)DWT_RESPONSE_EXPECTED) != 0U)
-            {
-                dwt_writefastCMD(dw, CMD_DTX_REF_W4R);
-            }
-            else
-            {
-                dwt_writefastCMD(dw, CMD_DTX_REF);
-            }
-        }
+            if ((mode & (uint8_t)DWT_RESPONSE_EXPECTED) != 0U)
+            {
+                cmd = CMD_DTX_TS_W4R;
+            }
+            else
+            {
+                cmd = CMD_DTX_TS;
+            }
+        }
+        else // delayed TX WRT reference time
+        {
+            if ((mode & (uint8_t)DWT_RESPONSE_EXPECTED) != 0U)
+            {
+                cmd = CMD_DTX_REF_W4R;
+            }
+            else
+            {
+                cmd = CMD_DTX_REF;
+            }
+        }
+
+        // Issue the TX command and read at offset 3 to get the upper 2 bytes out of 5 of the status in one batch
+        dwt_batch_fastcmd(dw, batch, cmd);
+        dwt_batch_read(dw, batch, SYS_STATUS_ID, 3U, 1U, &checkTxOK);
+        dwt_batch_commit(dw, batch);
+
+        if ((checkTxOK & (SYS_STATUS_HPDWARN_BIT_MASK >> 24UL)) == 0U) // Transmit Delayed Send set over Half a Period away.
+        {
+
+            retval = (int32_t)DWT_SUCCESS; // All okay
+        }
+        else
+        {
+            dwt_writefastCMD(dw, CMD_TXRXOFF);
+            retval = (int32_t)DWT_ERROR; // Failed !
+
+            // optionally could return error, and still send the frame at indicated time
+            // then if the application want to cancel the sending this can be done in a separate command.
+        }
+    }
+    else if ((mode & (uint8_t)DWT_START_TX_CCA) != 0U)
+    {
+        if ((mode & (uint8_t)DWT_RESPONSE_EXPECTED) != 0U)
+        {
+            dwt_batch_fastcmd(dw, batch, CMD_CCA_TX_W4R);
+        }
+        else
+        {
+            dwt_batch_fastcmd(dw, batch, CMD_CCA_TX);
+        }
+        dwt_batch_commit(dw, batch);
+    }
+    else
+    {
+        if ((mode & (uint8_t)DWT_RESPONSE_EXPECTED) != 0U)
+        {
+            dwt_batch_fastcmd(dw, batch, CMD_TX_W4R);
+        }
+        else
+        {
+            dwt_batch_fastcmd(dw, batch, CMD_TX);
+        }
+        dwt_batch_commit(dw, batch);
+    }
+
+    return retval;
+}
+
+/*! ------------------------------------------------------------------------------------------------------------------
+ * @brief This call initiates the transmission, input parameter indicates which TX mode is used see below
+ *
+ * input parameters:
+ * @param dw - DW3720 chip descriptor handler.
+ * @param mode - if mode = DWT_START_TX_IMMEDIATE - immediate TX (no response expected)
+ *               if mode = DWT_START_TX_DELAYED - delayed TX (no response expected)  at specified time (time in DX_TIME register)
+ *               if mode = DWT_START_TX_DLY_REF - delayed TX (no response expected)  at specified time (time in DREF_TIME register + any time in DX_TIME
+ * register) if mode = DWT_START_TX_DLY_RS  - delayed TX (no response expected)  at specified time (time in RX_TIME_0 register + any time in DX_TIME register)
+ *               if mode = DWT_START_TX_DLY_TS  - delayed TX (no response expected)  at specified time (time in TX_TIME_LO register + any time in DX_TIME
+ * register) if mode = DWT_START_TX_IMMEDIATE | DWT_RESPONSE_EXPECTED - immediate TX (response expected - so the receiver will be automatically turned on after
+ * TX is done) if mode = DWT_START_TX_DELAYED/DLY_* | DWT_RESPONSE_EXPECTED - delayed TX (response expected - so the receiver will be automatically turned on
+ * after TX is done) if mode = DWT_START_TX_CCA - Send the frame if no preamble detected within PTO time if mode = DWT_START_TX_CCA  | DWT_RESPONSE_EXPECTED -
+ * Send the frame if no preamble detected within PTO time and then enable RX* output parameters
+ *
+ * @returns DWT_SUCCESS for success, or DWT_ERROR for error (e.g. a delayed transmission will be cancelled if the delayed time has passed)
+ */
+int32_t ull_starttx(dwchip_t *dw, uint8_t mode)
+{
+    dwt_batch_t batch;
+    int32_t retval;
+
+    // Hold the SPI bus for the whole TX start sequence
+    dwt_lockbus(dw);
+    dwt_batch_begin(dw, &batch);
+    retval = dwt_starttx_batch(dw, &batch, mode);
+    dwt_unlockbus(dw);
+
+    return retval;
+
+} // end ull_starttx()
+
+/*! ------------------------------------------------------------------------------------------------------------------
+ * @brief This API function writes a TX frame template into the TX buffer and configures the TX frame control register
+ *        for it. The frame can then be sent repeatedly with ull_sendtemplate(), which only writes the bytes which
+ *        change between transmissions.
+ *
+ * input parameters
+ * @param dw - DW3720 chip descriptor handler.
+ * @param txFrameLength  - length of the frame including the 2 byte CRC, see ull_writetxfctrl()
+ * @param txFrameBytes   - the frame, the 2 CRC bytes at its end are added by the device and are not written
+ * @param txBufferOffset - offset of the frame in the TX buffer
+ * @param ranging        - 1 if this is a ranging frame, else 0
+ *
+ * output parameters
+ * @param tpl            - template descriptor to fill in
+ *
+ * returns DWT_SUCCESS for success, or DWT_ERROR for error
+ */
+int32_t ull_writetxtemplate(dwchip_t *dw, dwt_txtemplate_t *tpl, uint16_t txFrameLength, uint8_t *txFrameBytes, uint16_t txBufferOffset, uint8_t ranging)
+{
+    int32_t retVal = (int32_t)DWT_ERROR;
+
+    if (txFrameLength >= FCS_LEN)
+    {
+        retVal = ull_writetxdata(dw, (uint16_t)(txFrameLength - FCS_LEN), txFrameBytes, txBufferOffset);
+    }
+
+    if (retVal == (int32_t)DWT_SUCCESS)
+    {
+        ull_writetxfctrl(dw, txFrameLength, txBufferOffset, ranging);
+        tpl->offset = txBufferOffset;
+        tpl->length = txFrameLength;
+        tpl->ranging = ranging;
+    }
+
+    return retVal;
+}
+
+/*! ------------------------------------------------------------------------------------------------------------------
+ * @brief This API function patches a TX frame template written with ull_writetxtemplate() and initiates its
+ *        transmission. The patches, the TX frame control register (only if the frame length differs from the value
+ *        last written) and the TX command are written in one batch of SPI transactions, while holding the SPI bus.
+ *
+ * input parameters
+ * @param dw - DW3720 chip descriptor handler.
+ * @param tpl            - the template descriptor
+ * @param patches        - array of byte ranges of the frame to overwrite (can be NULL if numPatches is 0), the data has
+ *                         to be in the order it is sent (little endian for timestamps)
+ * @param numPatches     - number of entries in patches
+ * @param txFrameLength  - length of the frame including the 2 byte CRC, or 0 for the length of the template
+ * @param mode           - TX mode, see ull_starttx()
+ *
+ * output parameters
+ *
+ * returns DWT_SUCCESS for success, or DWT_ERROR for error (a patch outside the frame, or a delayed transmission which
+ * was cancelled because the delayed time has passed)
+ */
+int32_t ull_sendtemplate(dwchip_t *dw, const dwt_txtemplate_t *tpl, const dwt_txpatch_t *patches, uint8_t numPatches,
+    uint16_t txFrameLength, uint8_t mode)
+{
+    dwt_batch_t batch;
+    uint32_t reg32;
+    uint16_t addr;
+    int32_t retVal;
 
-        checkTxOK = dwt_read8bitoffsetreg(dw, SYS_STATUS_ID, 3U);    // Read at offset 3 to get the upper 2 bytes out of 5
-        if ((checkTxOK & (SYS_STATUS_HPDWARN_BIT_MASK >> 24UL)) == 0U) // Transmit Delayed Send set over Half a Period away.
-        {
+    if (txFrameLength == 0U)
+    {
+        txFrameLength = tpl->length;
+    }
 
-            retval = (int32_t)DWT_SUCCESS; // All okay
-        }
-        else
-        {
-            dwt_writefastCMD(dw, CMD_TXRXOFF);
-            retval = (int32_t)DWT_ERROR; // Failed !
+    if ((txFrameLength < FCS_LEN) || ((tpl->offset + txFrameLength) > TX_BUFFER_MAX_LEN))
+    {
+        return (int32_t)DWT_ERROR;
+    }
 
-            // optionally could return error, and still send the frame at indicated time
-            // then if the application want to cancel the sending this can be done in a separate command.
+    for (uint8_t i = 0U; i < numPatches; i++)
+    {
+        if (((uint32_t)patches[i].offset + patches[i].length + FCS_LEN) > txFrameLength)
+        {
+            return (int32_t)DWT_ERROR;
         }
     }
-    else if ((mode & (uint8_t)DWT_START_TX_CCA) != 0U)
+
+    // Hold the SPI bus for the whole sequence
+    dwt_lockbus(dw);
+    dwt_batch_begin(dw, &batch);
+
+    for (uint8_t i = 0U; i < numPatches; i++)
     {
-        if ((mode & (uint8_t)DWT_RESPONSE_EXPECTED) != 0U)
+        addr = (uint16_t)(tpl->offset + patches[i].offset);
+        if (addr <= REG_DIRECT_OFFSET_MAX_LEN)
         {
-            dwt_writefastCMD(dw, CMD_CCA_TX_W4R);
+            dwt_batch_add(dw, &batch, TX_BUFFER_ID, addr, patches[i].length, patches[i].data, DW3000_SPI_WR_BIT);
         }
         else
         {
-            dwt_writefastCMD(dw, CMD_CCA_TX);
+            dwt_batch_write(dw, &batch, INDIRECT_ADDR_A_ID, 0U, 4U, (TX_BUFFER_ID >> 16UL));
+            dwt_batch_write(dw, &batch, ADDR_OFFSET_A_ID, 0U, 4U, addr);
+            dwt_batch_add(dw, &batch, INDIRECT_POINTER_A_ID, 0U, patches[i].length, patches[i].data, DW3000_SPI_WR_BIT);
         }
     }
+
+    if (tpl->offset <= 127U)
+    {
+        reg32 = txFrameLength | ((uint32_t)(tpl->offset) << TX_FCTRL_TXB_OFFSET_BIT_OFFSET) | ((uint32_t)tpl->ranging << TX_FCTRL_TR_BIT_OFFSET);
+    }
     else
     {
-        if ((mode & (uint8_t)DWT_RESPONSE_EXPECTED) != 0U)
-        {
-            dwt_writefastCMD(dw, CMD_TX_W4R);
-        }
-        else
-        {
-            dwt_writefastCMD(dw, CMD_TX);
-        }
+        reg32 = txFrameLength | ((uint32_t)(tpl->offset + DWT_TX_BUFF_OFFSET_ADJUST) << TX_FCTRL_TXB_OFFSET_BIT_OFFSET)
+                | ((uint32_t)tpl->ranging << TX_FCTRL_TR_BIT_OFFSET);
     }
 
-    return retval;
+    if (reg32 != LOCAL_DATA(dw)->tx_fctrl)
+    {
+        dwt_batch_modify32(dw, &batch, TX_FCTRL_ID, 0U, ~(TX_FCTRL_TXB_OFFSET_BIT_MASK | TX_FCTRL_TR_BIT_MASK | TX_FCTRL_TXFLEN_BIT_MASK), reg32);
+        LOCAL_DATA(dw)->tx_fctrl = reg32;
+    }
 
-} // end ull_starttx()
+    retVal = dwt_starttx_batch(dw, &batch, mode);
+    dwt_unlockbus(dw);
+
+    return retVal;
+}
 
 /*! ------------------------------------------------------------------------------------------------------------------
  * @brief This is used to turn off the transceiver
@@ -5900,6 +7556,9 @@ void ull_readeventcounters(dwchip_t *dw, dwt_deviceentcnts_t *counters)
 void ull_softreset_fcmd(dwchip_t *dw)
 {
     dwt_writefastCMD(dw, CMD_SEMA_RESET);
+#ifdef DWT_REG_CACHE
+    dwt_regcache_invalidate(LOCAL_DATA(dw));
+#endif
 }
 
 /*! ------------------------------------------------------------------------------------------------------------------
@@ -5916,6 +7575,9 @@ void ull_softreset_fcmd(dwchip_t *dw)
 static void ull_softreset_no_sema_fcmd(dwchip_t *dw)
 {
     dwt_writefastCMD(dw, CMD_SEMA_RESET_NO_SEM);
+#ifdef DWT_REG_CACHE
+    dwt_regcache_invalidate(LOCAL_DATA(dw));
+#endif
 }
 
 /*! ------------------------------------------------------------------------------------------------------------------
@@ -6612,6 +8274,7 @@ void ull_configure_rf_port(dwchip_t *dw, dwt_rf_port_ctrl_e port_control)
 
 /* AES block */
 
+#ifdef DWT_ENABLE_AES
 /*! ------------------------------------------------------------------------------------------------------------------
  * @brief   This function provides the API for the configuration of the AES block before first usage.
  *
@@ -6639,6 +8302,7 @@ void ull_configure_aes(dwchip_t *dw, const dwt_aes_config_t *pCfg)
 
     dwt_write16bitoffsetreg(dw, AES_CFG_ID, 0U, tmp);
 }
+#endif // DWT_ENABLE_AES
 
 /*! ------------------------------------------------------------------------------------------------------------------
  * @brief   This gets mic size in bytes and convert it to value to write in AES_CFG
@@ -6661,6 +8325,7 @@ dwt_mic_size_e ull_mic_size_from_bytes(dwchip_t *dw, uint8_t mic_size_in_bytes)
     return (dwt_mic_size_e)mic_size;
 }
 
+#ifdef DWT_ENABLE_AES
 /*! ------------------------------------------------------------------------------------------------------------------
  * @brief   This function provides the API for the configuration of the AES key before first usage.
  *
@@ -6772,34 +8437,19 @@ static void ull_update_nonce_GCM(dwchip_t *dw, uint8_t *nonce)
 }
 
 /*! ------------------------------------------------------------------------------------------------------------------
- * @brief   This function provides the API for the job of encrypt/decrypt the data block
- *
- *          Prior to calling this function the AES configuration needs to be set via dwt_configure_aes and associated dwt_aes_config_t:
- *          e.g.  .key_load           = AES_KEY_Load,
- *                .key_size           = AES_KEY_128bit,
- *                .key_src            = AES_KEY_Src_RAMorOTP,
- *                .mic                = MIC_8,
- *                .mode               = AES_Encrypt,
- *                .aes_core_type      = AES_core_type_CCM,
- *                .aes_key_otp_type   = AES_key_OTP,
- *                .aes_otp_sel_key_block = AES_key_otp_sel_1st_128,
- *                .key_addr           = 0
- *
- *          packet sizes < 127
- *          note, the "nonce" shall be unique for every transaction
+ * @brief   This function programs the nonce, the data and the DMA ports of an AES job and starts it, see ull_do_aes()
  *
  * input parameters
  * @param dw - DW3720 chip descriptor handler.
- * @param job - pointer to AES job, contains data (source and destination) info and encryption/decryption mode.
- * @param core_type - Core type: CCM* or GCM
+ * @param job - pointer to AES job, contains data info and encryption info.
+ * @param core_type - Core type
  *
- * @return  AES_STS_ID status bits
+ * @return  0 when the job was started, or a negative error code (ERROR_DATA_SIZE etc.)
  */
-int8_t ull_do_aes(dwchip_t *dw, dwt_aes_job_t *job, dwt_aes_core_type_e core_type)
+static int8_t dwt_aes_start(dwchip_t *dw, const dwt_aes_job_t *job, dwt_aes_core_type_e core_type)
 {
     uint32_t tmp, dest_reg;
     uint16_t allow_size;
-    uint8_t ret;
     dwt_aes_src_port_e src_port;
     dwt_aes_dst_port_e dst_port;
 
@@ -6922,8 +8572,22 @@ int8_t ull_do_aes(dwchip_t *dw, dwt_aes_job_t *job, dwt_aes_core_type_e core_typ
 
     /* start AES action encrypt/decrypt */
     dwt_write8bitoffsetreg(dw, AES_START_ID, 0U, AES_START_AES_START_BIT_MASK);
-    ret = ull_wait_aes_poll(dw);
 
+    return 0;
+}
+
+/*! ------------------------------------------------------------------------------------------------------------------
+ * @brief   This function reads the plain header and the decrypted payload of a completed AES decryption job
+ *
+ * input parameters
+ * @param dw - DW3720 chip descriptor handler.
+ * @param job - pointer to the completed AES job
+ * @param ret - AES_STS_ID status bits of the job
+ *
+ * no return value
+ */
+static void dwt_aes_read_result(dwchip_t *dw, const dwt_aes_job_t *job, uint8_t ret)
+{
     /* Read plain header and decrypted payload on correct AES decryption
      * and if instructed to do so, i.e. if job->mode == AES_Decrypt and
      * job->header or job->payload addresses are exist
@@ -6969,9 +8633,151 @@ int8_t ull_do_aes(dwchip_t *dw, dwt_aes_job_t *job, dwt_aes_core_type_e core_typ
             }
         }
     }
-    return (int8_t)ret;
 }
 
+/*! ------------------------------------------------------------------------------------------------------------------
+ * @brief   This function provides the API for the job of encrypt/decrypt the data block
+ *
+ *          Prior to calling this function the AES configuration needs to be set via dwt_configure_aes and associated dwt_aes_config_t:
+ *          e.g.  .key_load           = AES_KEY_Load,
+ *                .key_size           = AES_KEY_128bit,
+ *                .key_src            = AES_KEY_Src_RAMorOTP,
+ *                .mic                = MIC_8,
+ *                .mode               = AES_Encrypt,
+ *                .aes_core_type      = AES_core_type_CCM,
+ *                .aes_key_otp_type   = AES_key_OTP,
+ *                .aes_otp_sel_key_block = AES_key_otp_sel_1st_128,
+ *                .key_addr           = 0
+ *
+ *          packet sizes < 127
+ *          note, the "nonce" shall be unique for every transaction
+ *
+ * input parameters
+ * @param dw - DW3720 chip descriptor handler.
+ * @param job - pointer to AES job, contains data (source and destination) info and encryption/decryption mode.
+ * @param core_type - Core type: CCM* or GCM
+ *
+ * @return  AES_STS_ID status bits
+ */
+int8_t ull_do_aes(dwchip_t *dw, dwt_aes_job_t *job, dwt_aes_core_type_e core_type)
+{
+    int8_t err;
+    uint8_t ret;
+
+    if (LOCAL_DATA(dw)->aes_job != NULL)
+    {
+        return ERROR_AES_BUSY;
+    }
+
+    err = dwt_aes_start(dw, job, core_type);
+    if (err != 0)
+    {
+        return err;
+    }
+
+    ret = ull_wait_aes_poll(dw);
+    dwt_aes_read_result(dw, job, ret);
+
+    return ((int8_t)ret);
+}
+
+/*! ------------------------------------------------------------------------------------------------------------------
+ * @brief   This function starts an AES job like ull_do_aes(), but returns without waiting for its completion. The
+ *          completion is reported by cb, either from ull_isr() when the AES_DONE/AES_ERR interrupt is raised (the
+ *          interrupts are enabled while the job is pending), or from ull_aes_poll().
+ *
+ *          The job and its header/payload buffers have to stay valid until the job has completed. Only one job can be
+ *          pending, and the TX/RX buffer used by the job must not be changed until then.
+ *
+ * input parameters
+ * @param dw - DW3720 chip descriptor handler.
+ * @param job - pointer to AES job, contains data info and encryption info.
+ * @param core_type - Core type
+ * @param cb - function called with the AES_STS_ID status bits when the job has completed (can be NULL if the job is
+ *             polled with ull_aes_poll())
+ * @param user_data - pointer passed to cb
+ *
+ * @return  0 when the job was started, ERROR_AES_BUSY if another job is pending, or a negative error code
+ */
+int8_t ull_do_aes_async(dwchip_t *dw, dwt_aes_job_t *job, dwt_aes_core_type_e core_type, dwt_aes_done_cb_t cb, void *user_data)
+{
+    int8_t err;
+
+    if (LOCAL_DATA(dw)->aes_job != NULL)
+    {
+        return ERROR_AES_BUSY;
+    }
+
+    // Clear the events of previous jobs
+    dwt_write16bitoffsetreg(dw, SYS_STATUS_HI_ID, 0U, (uint16_t)(SYS_STATUS_HI_AES_DONE_BIT_MASK | SYS_STATUS_HI_AES_ERR_BIT_MASK));
+
+    LOCAL_DATA(dw)->aes_job = job;
+    LOCAL_DATA(dw)->aes_cb = cb;
+    LOCAL_DATA(dw)->aes_user_data = user_data;
+
+    err = dwt_aes_start(dw, job, core_type);
+    if (err != 0)
+    {
+        LOCAL_DATA(dw)->aes_job = NULL;
+        return err;
+    }
+
+    if (cb != NULL)
+    {
+        dwt_or16bitoffsetreg(dw, SYS_ENABLE_HI_ID, 0U, (uint16_t)(SYS_ENABLE_HI_AES_DONE_ENABLE_BIT_MASK | SYS_ENABLE_HI_AES_ERR_ENABLE_BIT_MASK));
+    }
+
+    return 0;
+}
+
+/*! ------------------------------------------------------------------------------------------------------------------
+ * @brief   This function checks with a single read of AES_STS if the job started by ull_do_aes_async() has completed.
+ *          On completion the decrypted data are read, the completion callback is called and the status is returned.
+ *
+ * input parameters
+ * @param dw - DW3720 chip descriptor handler.
+ *
+ * @return  0 while the job is running, the AES_STS_ID status bits when it has completed, or ERROR_AES_IDLE if no job
+ *          is pending
+ */
+int8_t ull_aes_poll(dwchip_t *dw)
+{
+    dwt_aes_job_t *job = LOCAL_DATA(dw)->aes_job;
+    dwt_aes_done_cb_t cb = LOCAL_DATA(dw)->aes_cb;
+    uint8_t ret;
+
+    if (job == NULL)
+    {
+        return ERROR_AES_IDLE;
+    }
+
+    ret = dwt_read8bitoffsetreg(dw, AES_STS_ID, 0U);
+    if ((ret & (AES_STS_AES_DONE_BIT_MASK | AES_STS_TRANS_ERR_BIT_MASK)) == 0U)
+    {
+        return 0;
+    }
+
+    dwt_write8bitoffsetreg(dw, AES_STS_ID, 0U, ret); // clear all bits which were set as a result of AES operation
+    ret &= 0x3FU;
+
+    if (cb != NULL)
+    {
+        dwt_and16bitoffsetreg(dw, SYS_ENABLE_HI_ID, 0U, (uint16_t) ~(SYS_ENABLE_HI_AES_DONE_ENABLE_BIT_MASK | SYS_ENABLE_HI_AES_ERR_ENABLE_BIT_MASK));
+    }
+    dwt_write16bitoffsetreg(dw, SYS_STATUS_HI_ID, 0U, (uint16_t)(SYS_STATUS_HI_AES_DONE_BIT_MASK | SYS_STATUS_HI_AES_ERR_BIT_MASK));
+
+    dwt_aes_read_result(dw, job, ret);
+    LOCAL_DATA(dw)->aes_job = NULL;
+
+    if (cb != NULL)
+    {
+        cb((int8_t)ret, LOCAL_DATA(dw)->aes_user_data);
+    }
+
+    return ((int8_t)ret);
+}
+#endif // DWT_ENABLE_AES
+
 /*! ------------------------------------------------------------------------------------------------------------------
  *
  * @brief Request access to the device registers, using the dual SPI semaphore request command. If the semaphore is available,
@@ -7318,6 +9124,24 @@ uint16_t ull_getframelength(dwchip_t *dw, uint8_t *rng_bit)
         break;
     }
 
+    return ull_decodeframelength(dw, finfo16, rng_bit);
+}
+
+/*! ------------------------------------------------------------------------------------------------------------------
+ * @brief This function extracts the frame length and ranging bit from the first two bytes of RX_FINFO and saves the
+ *        length in the callback data
+ *
+ * input parameters
+ * @param dw - DW3720 chip descriptor handler.
+ * @param finfo16 - the first two bytes of the RX frame information register
+ *
+ * output parameters
+ * @param rng_bit - DWT_CB_DATA_RX_FLAG_RNG is set in this flags field if the ranging bit is set
+ *
+ * returns the frame length
+ */
+static uint16_t ull_decodeframelength(dwchip_t *dw, uint16_t finfo16, uint8_t *rng_bit)
+{
     // Report frame length - Standard frame length up to 127, extended frame length up to 1023 bytes
     if (LOCAL_DATA(dw)->longFrames == 0U)
     {
@@ -7948,6 +9772,109 @@ void ull_nlos_ipdiag(dwchip_t *dw, dwt_nlos_ipdiag_t *index)
     index->index_pp_u32 <<= 6UL; // shift left by 6 digits so it compares with first path index, to avoid using double/float
 }
 
+#ifdef AUTO_PLL_CAL
+/* Automotive PLL calibration of channel ch starting from coarse_code */
+static uint8_t ull_pll_auto_cal(dwchip_t *dw, uint8_t ch, uint32_t coarse_code, int8_t temperature, uint8_t *p_num_steps_lock)
+{
+    if (ch == (uint8_t)DWT_CH9)
+    {
+        return ull_pll_ch9_auto_cal(dw, coarse_code, 0U, AUTO_PLL_CAL_STEPS, p_num_steps_lock);
+    }
+    return ull_pll_ch5_auto_cal(dw, coarse_code, 0U, AUTO_PLL_CAL_STEPS, p_num_steps_lock, temperature);
+}
+
+/*
+ * Automotive PLL calibration of channel ch from the OTP coarse code, or from the coarse code in the
+ * PLL calibration cache for the current temperature if there is one. The device has to be in INIT_RC
+ * with SEQ_CTRL FORCE2INIT set.
+ */
+static uint8_t ull_pll_auto_cal_cached(dwchip_t *dw, uint8_t ch, uint8_t *p_num_steps_lock)
+{
+    dwt_pll_cal_cache_t *cache = LOCAL_DATA(dw)->pll_cal_cache;
+    int8_t temperature = LOCAL_DATA(dw)->temperature;
+    uint32_t coarse = dwt_otpreadpintoparams(dw, PLL_CC_ADDRESS);
+    uint16_t *valid;
+    uint16_t bin_mask;
+    int16_t bin;
+    uint8_t err;
+
+    // PLL_COARSE_CODE = 0x0B000000 + [21:8] Ch5 coarse code (Test 8180) + [6:0] Ch9 coarse code (Test 8550)
+    if (ch == (uint8_t)DWT_CH9)
+    {
+        coarse &= PLL_COARSE_CODE_CH9_VCO_COARSE_TUNE_BIT_MASK; // [6:0]
+    }
+    else
+    {
+        coarse = (coarse & PLL_COARSE_CODE_CH5_VCO_COARSE_TUNE_BIT_MASK) >> 8UL; // [21:8]
+    }
+
+    if (cache == NULL)
+    {
+        return ull_pll_auto_cal(dw, ch, coarse, temperature, p_num_steps_lock);
+    }
+
+    if (cache->partID != LOCAL_DATA(dw)->partID)
+    {
+        cache->ch5Valid = 0U;
+        cache->ch9Valid = 0U;
+        cache->hits = 0U;
+        cache->misses = 0U;
+        cache->partID = LOCAL_DATA(dw)->partID;
+    }
+
+    if (temperature == TEMP_INIT) // The bin needs the temperature, read it once here for the CH5 calibration too
+    {
+        uint16_t tempvbat = ull_readtempvbat(dw);
+        temperature = (int8_t)ull_convertrawtemperature(dw, (uint8_t)(tempvbat >> 8U));  // Temperature in upper 8 bits
+    }
+    bin = ((int16_t)temperature - DWT_PLL_CAL_TEMP_MIN) / DWT_PLL_CAL_BIN_WIDTH;
+    if (bin < 0)
+    {
+        bin = 0;
+    }
+    else if (bin >= DWT_PLL_CAL_NUM_BINS)
+    {
+        bin = DWT_PLL_CAL_NUM_BINS - 1;
+    }
+    bin_mask = (uint16_t)(1U << (uint16_t)bin);
+    valid = (ch == (uint8_t)DWT_CH9) ? &cache->ch9Valid : &cache->ch5Valid;
+
+    if ((*valid & bin_mask) != 0U)
+    {
+        uint32_t cached = (ch == (uint8_t)DWT_CH9) ? cache->ch9Code[bin] : cache->ch5Code[bin];
+
+        err = ull_pll_auto_cal(dw, ch, cached, temperature, p_num_steps_lock);
+        if (err == (uint8_t)DWT_SUCCESS)
+        {
+            cache->hits++;
+            return err;
+        }
+
+        // The cached code has drifted, search again from the OTP code
+        *valid &= (uint16_t)~bin_mask;
+        (void)ull_setdwstate(dw, (int32_t)DWT_DW_IDLE_RC);
+        dwt_and_or32bitoffsetreg(dw, SEQ_CTRL_ID, 0U, ~SEQ_CTRL_FORCE2IDLE_BIT_MASK, SEQ_CTRL_FORCE2INIT_BIT_MASK);
+    }
+
+    cache->misses++;
+    err = ull_pll_auto_cal(dw, ch, coarse, temperature, p_num_steps_lock);
+    if (err == (uint8_t)DWT_SUCCESS)
+    {
+        coarse = dwt_read32bitoffsetreg(dw, PLL_COARSE_CODE_ID, 0U);
+        if (ch == (uint8_t)DWT_CH9)
+        {
+            cache->ch9Code[bin] = (uint8_t)(coarse & PLL_COARSE_CODE_CH9_VCO_COARSE_TUNE_BIT_MASK);
+        }
+        else
+        {
+            cache->ch5Code[bin] = (uint16_t)((coarse & PLL_COARSE_CODE_CH5_VCO_COARSE_TUNE_BIT_MASK) >> PLL_COARSE_CODE_CH5_VCO_COARSE_TUNE_BIT_OFFSET);
+        }
+        *valid |= bin_mask;
+    }
+    return err;
+}
+#endif /* AUTO_PLL_CAL */
+
 /*! ------------------------------------------------------------------------------------------------------------------
  * @brief This function will configure the channel number.
  *
@@ -7962,7 +9889,6 @@ static int32_t ull_setchannel(dwchip_t *dw, uint8_t ch)
     uint8_t dw_state;
 
 #ifdef AUTO_PLL_CAL
-    uint32_t coarse;
     uint8_t steps_to_lock;
 #endif
 
@@ -7990,17 +9916,7 @@ static int32_t ull_setchannel(dwchip_t *dw, uint8_t ch)
 #ifdef AUTO_PLL_CAL
         dwt_and_or32bitoffsetreg(dw, SEQ_CTRL_ID, 0U, ~SEQ_CTRL_FORCE2IDLE_BIT_MASK, SEQ_CTRL_FORCE2INIT_BIT_MASK);
 
-        if (ch == (uint8_t)DWT_CH9)
-        {
-            // PLL_COARSE_CODE = 0x0B000000 + [21:8] Ch5 coarse code (Test 8180) + [6:0] Ch9 coarse code (Test 8550)
-            coarse = dwt_otpreadpintoparams(dw, PLL_CC_ADDRESS) & PLL_COARSE_CODE_CH9_VCO_COARSE_TUNE_BIT_MASK;  // [6:0]
-            err = ull_pll_ch9_auto_cal(dw, coarse, 0U, AUTO_PLL_CAL_STEPS, &steps_to_lock );
-        }
-        else //(ch == 5)
-        {
-            coarse = (dwt_otpreadpintoparams(dw, PLL_CC_ADDRESS) & PLL_COARSE_CODE_CH5_VCO_COARSE_TUNE_BIT_MASK) >> 8UL;  // [21:8]
-            err = ull_pll_ch5_auto_cal(dw, coarse, 0U, AUTO_PLL_CAL_STEPS, &steps_to_lock, LOCAL_DATA(dw)->temperature);
-        }
+        err = (int32_t)ull_pll_auto_cal_cached(dw, ch, &steps_to_lock);
 
         if(err == DWT_SUCCESS)
         {
@@ -8019,7 +9935,7 @@ static int32_t ull_setchannel(dwchip_t *dw, uint8_t ch)
          * In such condition the driver falls back to the default PLL calibration.
          */
 #if DWT_DEBUG_PRINT
-        printf("ERROR AUTO PLL failed to lock with OTP coarse = 0x%08x\n" , coarse );
+        printf("ERROR AUTO PLL failed to lock with OTP coarse code\n");
         printf("=> fallback to non-automotive pll calibration\n");
 #endif
         /* switch back to Idle RC before retrying setting channel to Idle PLL */
@@ -9274,9 +11190,11 @@ static int32_t dwt_ioctl(dwchip_t *dw, dwt_ioctl_e fn, int32_t param, void *ptr)
         }
         break;
 
+#ifdef DWT_ENABLE_AES
     case DWT_SETKEYREG128:
         ull_set_keyreg_128(dw, (const dwt_aes_key_t *)ptr);
         break;
+#endif
 
     case DWT_CONFIGURELEADDRESS:
         if(ptr != NULL)
@@ -9604,6 +11522,7 @@ static int32_t dwt_ioctl(dwchip_t *dw, dwt_ioctl_e fn, int32_t param, void *ptr)
         }
         break;
 
+#ifdef DWT_ENABLE_OTP_WRITE
     case DWT_OTPWRITE:
         if(ptr != NULL)
         {
@@ -9611,7 +11530,9 @@ static int32_t dwt_ioctl(dwchip_t *dw, dwt_ioctl_e fn, int32_t param, void *ptr)
             ret = ull_otpwrite(dw, tmp->value, tmp->address);
         }
         break;
+#endif
 
+#ifdef DWT_ENABLE_OTP_WRITE
     case DWT_OTPWRITEANDVERIFY:
         if(ptr != NULL)
         {
@@ -9619,6 +11540,7 @@ static int32_t dwt_ioctl(dwchip_t *dw, dwt_ioctl_e fn, int32_t param, void *ptr)
             ret = ull_otpwriteandverify(dw, tmp->value, tmp->address);
         }
         break;
+#endif
 
     case DWT_ENTERSLEEP:
         ull_entersleep(dw, param);
@@ -9748,6 +11670,7 @@ static int32_t dwt_ioctl(dwchip_t *dw, dwt_ioctl_e fn, int32_t param, void *ptr)
         ret = ull_readstsquality(dw, (int16_t *)ptr);
         break;
 
+#ifdef DWT_ENABLE_AES
     case DWT_DOAES:
         if(ptr != NULL)
         {
@@ -9755,10 +11678,13 @@ static int32_t dwt_ioctl(dwchip_t *dw, dwt_ioctl_e fn, int32_t param, void *ptr)
             tmp->result = ull_do_aes(dw, tmp->job, tmp->core_type);
         }
         break;
+#endif
 
+#ifdef DWT_ENABLE_AES
     case DWT_CONFIGUREAES:
         ull_configure_aes(dw, (const dwt_aes_config_t *)ptr);
         break;
+#endif
 
     case DWT_MICSIZEFROMBYTES:
         if(ptr != NULL)
@@ -10704,7 +12630,9 @@ static const struct dwt_ops_s dw3720_ops = {
     .write_tx_fctrl = ull_writetxfctrl,
     .read_rx_data = ull_readrxdata,
     .read_acc_data = ull_readaccdata,
+#ifdef DWT_ENABLE_CIR
     .read_cir = ull_readcir,
+#endif
     .read_rx_timestamp = ull_readrxtimestamp,
     .configure_tx_rf = ull_configuretxrf,
     .set_interrupt = ull_setinterrupt,
@@ -29,6 +29,14 @@
  */
 uint32_t log2_lut(uint32_t x);
 
+/**
+ * log2_lut_fast - Compute log2(x) with a finer lut.
+ * @x: x to convert in log2, must not be 0.
+ *
+ * Return: log2(x) shifted by LUT_LOG_SHIFT, within one LSB of the exact value.
+ */
+uint32_t log2_lut_fast(uint32_t x);
+
 /**
  * log10_10 - Compute 10*log10(x).
  * @x: x to convert in 10*log10(x).
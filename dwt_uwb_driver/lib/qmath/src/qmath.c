@@ -14,6 +14,8 @@
 
 #define LUT_SIZE                     33U
 #define LUT_SIZE_POW_BASE_2          32U
+#define LUT_FINE_PRECISION           8U
+#define LUT_FINE_SIZE                ((1U << LUT_FINE_PRECISION) + 1U)
 #define LOG_PRECISION                5U
 #define LOG2_10_SHIFTED_100TH        109UL
 #define DIVIDE_BY_POW2_ROUNDED(x, y) (((uint64_t)(x) + (1ULL << ((uint64_t)(y) - 1ULL))) >> (uint64_t)(y))
@@ -40,6 +42,31 @@ static const uint16_t lut_log2[LUT_SIZE] =
     20143U, 21098U, 22034U, 22952U, 23852U, 24736U, 25604U, 26455U, 27292U, 28114U, 28922U, 29717U, 30498U, 31267U, 32024U, 32768U
 };
 
+/**
+ * lut_log2_fine is a lut that computes log2(x) shifted by LUT_LOG_SHIFT
+ * with a step for x of 1/(2^LUT_FINE_PRECISION).
+ */
+static const uint16_t lut_log2_fine[LUT_FINE_SIZE] =
+{
+    0U, 184U, 368U, 551U, 733U, 914U, 1095U, 1275U, 1455U, 1633U, 1811U, 1989U, 2166U, 2342U, 2517U, 2692U,
+    2866U, 3039U, 3212U, 3385U, 3556U, 3727U, 3897U, 4067U, 4236U, 4405U, 4573U, 4740U, 4907U, 5073U, 5239U, 5404U,
+    5568U, 5732U, 5895U, 6058U, 6220U, 6382U, 6543U, 6703U, 6863U, 7023U, 7182U, 7340U, 7498U, 7655U, 7812U, 7968U,
+    8124U, 8279U, 8434U, 8588U, 8742U, 8895U, 9048U, 9200U, 9352U, 9503U, 9654U, 9804U, 9954U, 10104U, 10253U, 10401U,
+    10549U, 10696U, 10843U, 10990U, 11136U, 11282U, 11427U, 11572U, 11716U, 11860U, 12004U, 12147U, 12289U, 12431U, 12573U, 12715U,
+    12855U, 12996U, 13136U, 13276U, 13415U, 13554U, 13692U, 13830U, 13968U, 14105U, 14242U, 14378U, 14514U, 14650U, 14785U, 14920U,
+    15055U, 15189U, 15322U, 15456U, 15589U, 15721U, 15854U, 15986U, 16117U, 16248U, 16379U, 16509U, 16639U, 16769U, 16898U, 17027U,
+    17156U, 17284U, 17412U, 17540U, 17667U, 17794U, 17921U, 18047U, 18173U, 18298U, 18424U, 18548U, 18673U, 18797U, 18921U, 19045U,
+    19168U, 19291U, 19414U, 19536U, 19658U, 19780U, 19901U, 20022U, 20143U, 20263U, 20383U, 20503U, 20623U, 20742U, 20861U, 20980U,
+    21098U, 21216U, 21334U, 21451U, 21568U, 21685U, 21802U, 21918U, 22034U, 22150U, 22265U, 22380U, 22495U, 22610U, 22724U, 22838U,
+    22952U, 23066U, 23179U, 23292U, 23404U, 23517U, 23629U, 23741U, 23852U, 23964U, 24075U, 24186U, 24296U, 24407U, 24517U, 24627U,
+    24736U, 24845U, 24955U, 25063U, 25172U, 25280U, 25388U, 25496U, 25604U, 25711U, 25818U, 25925U, 26031U, 26138U, 26244U, 26350U,
+    26455U, 26561U, 26666U, 26771U, 26876U, 26980U, 27084U, 27188U, 27292U, 27396U, 27499U, 27602U, 27705U, 27808U, 27910U, 28012U,
+    28114U, 28216U, 28318U, 28419U, 28520U, 28621U, 28722U, 28822U, 28922U, 29022U, 29122U, 29222U, 29321U, 29421U, 29520U, 29618U,
+    29717U, 29815U, 29914U, 30012U, 30109U, 30207U, 30304U, 30401U, 30498U, 30595U, 30692U, 30788U, 30884U, 30980U, 31076U, 31172U,
+    31267U, 31362U, 31457U, 31552U, 31647U, 31741U, 31836U, 31930U, 32024U, 32117U, 32211U, 32304U, 32397U, 32490U, 32583U, 32676U,
+    32768U
+};
+
 /**
  * log2_lut - Compute log2(x).
  * @x: x to convert in log2.
@@ -90,6 +117,40 @@ uint32_t log2_lut(uint32_t x)
     return log2_x;
 }
 
+/**
+ * log2_lut_fast - Compute log2(x).
+ * @x: x to convert in log2, must not be 0.
+ *
+ * Return: Return the log2(x) shifted by LUT_LOG_SHIFT.
+ *
+ * Same algo as log2_lut() but without the 64 bit division: x is normalized
+ * with its msb at bit 31, the next LUT_FINE_PRECISION bits are the index into
+ * lut_log2_fine and the 16 bits below them interpolate linearly to the next
+ * entry. The error of the interpolation over a step of 1/256 is below 0.1 LSB,
+ * so the result is within one LSB for all x.
+ * A call is one clz, two loads from the 514 byte table and one multiply. The
+ * 64 bit division of log2_lut() was the cost, a batch of frames has no loop
+ * over independent lanes which SIMD could speed up.
+ */
+uint32_t log2_lut_fast(uint32_t x)
+{
+    uint32_t z, m, index, frac, delta;
+
+    /* 0 is not valid, return log2(1) instead of reading garbage. */
+    if (x == 0UL)
+    {
+        return 0U;
+    }
+
+    z = 31U - (uint32_t)__builtin_clz(x);
+    m = x << (31U - z);
+    index = (m >> (31U - LUT_FINE_PRECISION)) & ((1UL << LUT_FINE_PRECISION) - 1UL);
+    frac = (m >> (31U - LUT_FINE_PRECISION - 16U)) & 0xFFFFUL;
+    delta = (uint32_t)lut_log2_fine[index + 1U] - (uint32_t)lut_log2_fine[index];
+
+    return (z << LUT_LOG_SHIFT) + (uint32_t)lut_log2_fine[index] + ((delta * frac + 0x8000UL) >> 16UL);
+}
+
 /**
  * log10_10 - Compute 10*log10(x).
  * @x: x to convert in 10*log10(x).
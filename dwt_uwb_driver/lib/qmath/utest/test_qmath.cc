@@ -45,6 +45,33 @@ TEST_P(TestLogInt, logx)
     EXPECT_NEAR(result_q8 / 100.0, log_val_q8, 0.15);
 }
 
+class TestLog2Fast : public ::testing::TestWithParam<int>
+{
+};
+
+INSTANTIATE_TEST_SUITE_P(Log2FastData, TestLog2Fast, testing::Range(0, 32, 1));
+
+TEST_P(TestLog2Fast, oneLsb)
+{
+    uint32_t base = 1UL << GetParam();
+
+    /* Every power of two and a sweep of the mantissa above it. */
+    for (uint32_t i = 0; i < 4096; i++)
+    {
+        uint32_t x = base + (uint32_t)(((uint64_t)base * i) / 4096);
+        double log_val_q15 = log2(x) * (1 << LUT_LOG_SHIFT);
+
+        ASSERT_NEAR(log2_lut_fast(x), log_val_q15, 1.0) << x;
+        /* Not worse than log2_lut(). */
+        ASSERT_LE(fabs(log2_lut_fast(x) - log_val_q15), fabs(log2_lut(x) - log_val_q15) + 1.0) << x;
+    }
+}
+
+TEST(TestLog2Fast, logMax)
+{
+    EXPECT_NEAR(log2_lut_fast(0xffffffff), log2(0xffffffff) * (1 << LUT_LOG_SHIFT), 1.0);
+}
+
 class TestLogMax : public ::testing::Test
 {
 };
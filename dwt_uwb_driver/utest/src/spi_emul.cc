@@ -0,0 +1,339 @@
+/*
+ * SPI level emulator of the DW3xxx register files, see spi_emul.h.
+ */
+
+#include <string.h>
+
+#include "spi_emul.h"
+
+extern "C"
+{
+#include "deca_device_api.h"
+/* the addresses used here are the same on the DW3720 */
+#include "dw3000_deca_regs.h"
+}
+
+#define EMUL_NUM_FILES	32
+#define EMUL_FILE_SIZE	0x4000
+#define EMUL_MAX_FORCED 16
+#define EMUL_MAX_W1C	8
+
+#define EMUL_FILE(reg)	 (((reg) >> 16) & 0x1FU)
+#define EMUL_OFFSET(reg) ((reg) & 0xFFFFU)
+
+struct emul_bits {
+	uint32_t reg;
+	uint32_t bits;
+};
+
+static uint8_t emul_mem[EMUL_NUM_FILES][EMUL_FILE_SIZE];
+static struct emul_bits emul_forced[EMUL_MAX_FORCED];
+static int emul_num_forced;
+static uint32_t emul_w1c_regs[EMUL_MAX_W1C];
+static int emul_num_w1c;
+static int emul_last_cmd;
+static uint32_t emul_hook_reg;
+static void (*emul_hook)(void);
+static struct spi_emul_stats emul_stats;
+
+/* the byte mask of a 32 bit register from the list that covers addr */
+static uint8_t emul_bits_at(const struct emul_bits *list, int num, uint8_t file, uint16_t addr)
+{
+	uint8_t bits = 0;
+
+	for (int i = 0; i < num; i++) {
+		uint16_t off = EMUL_OFFSET(list[i].reg);
+
+		if (EMUL_FILE(list[i].reg) == file && addr >= off && addr < off + 4) {
+			bits |= (uint8_t)(list[i].bits >> (8 * (addr - off)));
+		}
+	}
+	return bits;
+}
+
+static bool emul_is_w1c(uint8_t file, uint16_t addr)
+{
+	for (int i = 0; i < emul_num_w1c; i++) {
+		uint16_t off = EMUL_OFFSET(emul_w1c_regs[i]);
+
+		if (EMUL_FILE(emul_w1c_regs[i]) == file && addr >= off && addr < off + 4) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/* decode the SPI header, returns false for a fast command */
+static bool emul_decode(uint16_t header_length, const uint8_t *header, uint8_t *file,
+			uint16_t *offset, uint8_t *mode)
+{
+	*file = (header[0] >> 1) & 0x1FU;
+	*offset = 0;
+	*mode = 0;
+
+	if (header_length == 1) {
+		return (header[0] & 0x81U) != 0x81U;
+	}
+
+	*offset = (uint16_t)(((header[0] & 0x01U) << 6) | (header[1] >> 2));
+	*mode = header[1] & 0x03U;
+	return true;
+}
+
+static void emul_store(uint8_t file, uint16_t offset, uint16_t length, const uint8_t *data)
+{
+	for (uint16_t i = 0; i < length && offset + i < EMUL_FILE_SIZE; i++) {
+		uint16_t addr = offset + i;
+
+		if (emul_is_w1c(file, addr)) {
+			emul_mem[file][addr] &= (uint8_t)~data[i];
+		} else {
+			emul_mem[file][addr] = data[i];
+		}
+	}
+}
+
+static void emul_count(uint16_t header_length, uint16_t body_length, bool read)
+{
+	emul_stats.xfers++;
+	if (read) {
+		emul_stats.reads++;
+	} else {
+		emul_stats.writes++;
+	}
+	emul_stats.header_bytes += header_length;
+	emul_stats.body_bytes += body_length;
+}
+
+static void emul_read_at(uint8_t file, uint16_t offset, uint16_t read_length, uint8_t *read_buffer)
+{
+	for (uint16_t i = 0; i < read_length; i++) {
+		uint16_t addr = offset + i;
+
+		if (addr < EMUL_FILE_SIZE) {
+			read_buffer[i] = emul_mem[file][addr] |
+					 emul_bits_at(emul_forced, emul_num_forced, file, addr);
+		} else {
+			read_buffer[i] = 0;
+		}
+	}
+}
+
+static void emul_write_at(uint8_t file, uint16_t offset, uint8_t mode, uint16_t write_length,
+			  const uint8_t *write_buffer)
+{
+	if (mode == 0) {
+		emul_store(file, offset, write_length, write_buffer);
+	} else {
+		/* AND mask followed by OR mask of 1, 2 or 4 bytes */
+		uint16_t width = (uint16_t)(1U << (mode - 1U));
+		uint8_t value[4];
+
+		for (uint16_t i = 0; i < width && i < write_length / 2U; i++) {
+			value[i] = (uint8_t)((emul_mem[file][offset + i] & write_buffer[i]) |
+					     write_buffer[width + i]);
+		}
+		emul_store(file, offset, width, value);
+	}
+}
+
+static int32_t emul_readfromspi(uint16_t header_length, uint8_t *header_buffer,
+				uint16_t read_length, uint8_t *read_buffer)
+{
+	uint8_t file;
+	uint16_t offset;
+	uint8_t mode;
+
+	emul_count(header_length, read_length, true);
+	emul_decode(header_length, header_buffer, &file, &offset, &mode);
+	if (emul_hook != NULL && EMUL_FILE(emul_hook_reg) == file &&
+	    EMUL_OFFSET(emul_hook_reg) == offset) {
+		void (*hook)(void) = emul_hook;
+
+		/* the hook may access the device itself */
+		emul_hook = NULL;
+		hook();
+	}
+	emul_read_at(file, offset, read_length, read_buffer);
+	return DWT_SUCCESS;
+}
+
+static int32_t emul_writetospi(uint16_t header_length, const uint8_t *header_buffer,
+			       uint16_t write_length, const uint8_t *write_buffer)
+{
+	uint8_t file;
+	uint16_t offset;
+	uint8_t mode;
+
+	emul_count(header_length, write_length, false);
+	if (!emul_decode(header_length, header_buffer, &file, &offset, &mode)) {
+		emul_stats.fast_cmds++;
+		emul_last_cmd = file;
+		return DWT_SUCCESS;
+	}
+
+	emul_write_at(file, offset, mode, write_length, write_buffer);
+	return DWT_SUCCESS;
+}
+
+static int32_t emul_writetospiwithcrc(uint16_t header_length, const uint8_t *header_buffer,
+				      uint16_t write_length, const uint8_t *write_buffer,
+				      uint8_t crc8)
+{
+	(void)crc8;
+
+	emul_writetospi(header_length, header_buffer, write_length, write_buffer);
+	emul_stats.body_bytes++;
+	return DWT_SUCCESS;
+}
+
+/* a chained transaction continues the CS frame of the one before it, so like
+ * the device its body goes to the address following the previous body and
+ * only the body bytes are counted */
+static int32_t emul_xferbatch(const struct dwt_spi_xfer_s *xfers, uint16_t count)
+{
+	uint8_t file = 0;
+	uint16_t offset = 0;
+
+	for (uint16_t i = 0; i < count; i++) {
+		const struct dwt_spi_xfer_s *x = &xfers[i];
+		uint8_t mode = 0;
+
+		if (i == 0 || !x->chained) {
+			if (x->read) {
+				emul_readfromspi(x->headerLength, (uint8_t *)x->header, x->length, x->buffer);
+			} else {
+				emul_writetospi(x->headerLength, x->header, x->length, x->buffer);
+			}
+			emul_decode(x->headerLength, x->header, &file, &offset, &mode);
+		} else {
+			emul_stats.body_bytes += x->length;
+			if (x->read) {
+				emul_read_at(file, offset, x->length, x->buffer);
+			} else {
+				emul_write_at(file, offset, 0, x->length, x->buffer);
+			}
+		}
+		offset = (uint16_t)(offset + x->length);
+	}
+	return DWT_SUCCESS;
+}
+
+static void emul_setslowrate(void)
+{
+}
+
+static void emul_setfastrate(void)
+{
+}
+
+struct dwt_spi_s spi_emul;
+
+void spi_emul_reset(uint32_t dev_id)
+{
+	/* the optional async and bus lock functions are not set, so the driver
+	 * falls back to single transfers, which are counted */
+	memset(&spi_emul, 0, sizeof(spi_emul));
+	spi_emul.readfromspi = emul_readfromspi;
+	spi_emul.writetospi = emul_writetospi;
+	spi_emul.writetospiwithcrc = emul_writetospiwithcrc;
+	spi_emul.setslowrate = emul_setslowrate;
+	spi_emul.setfastrate = emul_setfastrate;
+	spi_emul.xferbatch = emul_xferbatch;
+
+	memset(emul_mem, 0, sizeof(emul_mem));
+	emul_num_forced = 0;
+	emul_num_w1c = 0;
+	emul_hook = NULL;
+	spi_emul_clear_stats();
+	spi_emul_write32(0, dev_id);
+}
+
+static void emul_wakeup(void)
+{
+}
+
+int32_t spi_emul_probe(uint32_t dev_id, const struct dwt_driver_s *driver)
+{
+	static const struct dwt_driver_s *drv_list[1];
+	struct dwt_probe_s probe_interf = {};
+
+	spi_emul_reset(dev_id);
+	spi_emul_force_bits(SYS_STATUS_ID, SYS_STATUS_CP_LOCK_BIT_MASK);
+	spi_emul_force_bits(SAR_STATUS_ID, SAR_STATUS_SAR_DONE_BIT_MASK);
+	spi_emul_force_bits(RX_CAL_STS_ID, 0x1U);
+
+	drv_list[0] = driver;
+	probe_interf.spi = &spi_emul;
+	probe_interf.wakeup_device_with_io = emul_wakeup;
+	probe_interf.driver_list = (struct dwt_driver_s **)drv_list;
+	probe_interf.dw_driver_num = 1;
+	return dwt_probe(&probe_interf);
+}
+
+void spi_emul_write(uint32_t reg, uint16_t offset, const void *data, uint16_t len)
+{
+	memcpy(&emul_mem[EMUL_FILE(reg)][EMUL_OFFSET(reg) + offset], data, len);
+}
+
+void spi_emul_read(uint32_t reg, uint16_t offset, void *data, uint16_t len)
+{
+	memcpy(data, &emul_mem[EMUL_FILE(reg)][EMUL_OFFSET(reg) + offset], len);
+}
+
+void spi_emul_write32(uint32_t reg, uint32_t value)
+{
+	uint8_t buf[4];
+
+	for (int i = 0; i < 4; i++) {
+		buf[i] = (uint8_t)(value >> (8 * i));
+	}
+	spi_emul_write(reg, 0, buf, sizeof(buf));
+}
+
+uint32_t spi_emul_read32(uint32_t reg)
+{
+	uint8_t buf[4];
+
+	spi_emul_read(reg, 0, buf, sizeof(buf));
+	return ((uint32_t)buf[3] << 24) | ((uint32_t)buf[2] << 16) | ((uint32_t)buf[1] << 8) |
+	       buf[0];
+}
+
+void spi_emul_force_bits(uint32_t reg, uint32_t bits)
+{
+	if (emul_num_forced < EMUL_MAX_FORCED) {
+		emul_forced[emul_num_forced].reg = reg;
+		emul_forced[emul_num_forced].bits = bits;
+		emul_num_forced++;
+	}
+}
+
+void spi_emul_w1c(uint32_t reg)
+{
+	if (emul_num_w1c < EMUL_MAX_W1C) {
+		emul_w1c_regs[emul_num_w1c++] = reg;
+	}
+}
+
+void spi_emul_on_read(uint32_t reg, void (*hook)(void))
+{
+	emul_hook_reg = reg;
+	emul_hook = hook;
+}
+
+int spi_emul_last_cmd(void)
+{
+	return emul_last_cmd;
+}
+
+const struct spi_emul_stats *spi_emul_get_stats(void)
+{
+	return &emul_stats;
+}
+
+void spi_emul_clear_stats(void)
+{
+	memset(&emul_stats, 0, sizeof(emul_stats));
+	emul_last_cmd = -1;
+}
@@ -0,0 +1,62 @@
+/*
+ * SPI level emulator of the DW3xxx register files for host tests.
+ *
+ * The SPI headers written by the driver are decoded like the device does,
+ * reads return the register file contents and writes (including the AND/OR
+ * modes) update them. Every transaction is counted, so tests can check how
+ * many transactions and bytes on the wire an API call costs.
+ */
+
+#ifndef SPI_EMUL_H
+#define SPI_EMUL_H
+
+#include <stdint.h>
+
+extern "C"
+{
+#include "deca_interface.h"
+}
+
+struct spi_emul_stats {
+	uint32_t xfers;		/* SPI transactions (CS assertions) */
+	uint32_t reads;
+	uint32_t writes;
+	uint32_t fast_cmds;
+	uint32_t header_bytes;
+	uint32_t body_bytes;	/* including the CRC byte of CRC writes */
+};
+
+/* the SPI functions to set into dwt_probe_s, valid after spi_emul_reset() */
+extern struct dwt_spi_s spi_emul;
+
+/* set up spi_emul, clear all register files and the statistics, set DEV_ID */
+void spi_emul_reset(uint32_t dev_id);
+
+/* spi_emul_reset() and dwt_probe() of driver on the emulator, with the
+ * status bits the driver polls for during the initialisation forced */
+int32_t spi_emul_probe(uint32_t dev_id, const struct dwt_driver_s *driver);
+
+/* register access, reg is the driver register ID (file << 16 | offset) */
+void spi_emul_write(uint32_t reg, uint16_t offset, const void *data, uint16_t len);
+void spi_emul_read(uint32_t reg, uint16_t offset, void *data, uint16_t len);
+void spi_emul_write32(uint32_t reg, uint32_t value);
+uint32_t spi_emul_read32(uint32_t reg);
+
+/* bits which always read as set in the 32 bit register at reg, for status
+ * bits the driver polls (e.g. PLL lock) */
+void spi_emul_force_bits(uint32_t reg, uint32_t bits);
+
+/* registers where writing one clears a bit (SYS_STATUS) */
+void spi_emul_w1c(uint32_t reg);
+
+/* run hook once, before the next single read of reg, e.g. to run dwt_isr()
+ * in the middle of a driver call */
+void spi_emul_on_read(uint32_t reg, void (*hook)(void));
+
+/* the last fast command, or -1 */
+int spi_emul_last_cmd(void);
+
+const struct spi_emul_stats *spi_emul_get_stats(void);
+void spi_emul_clear_stats(void);
+
+#endif
@@ -0,0 +1,193 @@
+/*
+ * Tests of the CIR analysis on synthetic CIR windows.
+ */
+
+#include <gtest/gtest.h>
+
+#include <climits>
+#include <cmath>
+
+extern "C"
+{
+#include "deca_device_api.h"
+#include "deca_cir.h"
+}
+
+#define WINDOW_LEN 64
+
+static void put_sample_48b(uint8_t *p, int32_t re, int32_t im)
+{
+	uint32_t r = (uint32_t)re & 0xFFFFFF;
+	uint32_t i = (uint32_t)im & 0xFFFFFF;
+
+	p[0] = r;
+	p[1] = r >> 8;
+	p[2] = r >> 16;
+	p[3] = i;
+	p[4] = i >> 8;
+	p[5] = i >> 16;
+}
+
+/* Noise of about the given magnitude with a random phase, a first path at
+ * fp and the strongest path at peak, both 3 samples wide. */
+static void make_window(int32_t *re, int32_t *im, double noise, int fp,
+			double fp_amp, int peak, double peak_amp)
+{
+	uint32_t seed = 0x2468ACE;
+
+	for (int i = 0; i < WINDOW_LEN; i++) {
+		seed = seed * 1103515245U + 12345U;
+		double phase = (seed >> 8) * (2 * M_PI / (1 << 24));
+		seed = seed * 1103515245U + 12345U;
+		double amp = noise * (0.5 + (seed >> 8) / (double)(1 << 24));
+
+		if (i == fp || i == peak) {
+			amp = (i == fp) ? fp_amp : peak_amp;
+		} else if (i == fp + 1 || i == peak + 1 || i == fp - 1 ||
+			   i == peak - 1) {
+			amp = ((i == fp + 1 || i == fp - 1) ? fp_amp :
+							      peak_amp) / 3;
+		}
+		re[i] = (int32_t)lround(amp * cos(phase));
+		im[i] = (int32_t)lround(amp * sin(phase));
+	}
+}
+
+TEST(TestCirMagnitude, Accuracy48b)
+{
+	uint8_t buf[6 * 64];
+	uint32_t mag[64];
+	int32_t re[64];
+	int32_t im[64];
+
+	for (int amp : { 1000, 30000, 131071 }) {
+		for (int i = 0; i < 64; i++) {
+			double phase = i * (2 * M_PI / 64);
+
+			re[i] = (int32_t)lround(amp * cos(phase));
+			im[i] = (int32_t)lround(amp * sin(phase));
+			put_sample_48b(&buf[6 * i], re[i], im[i]);
+		}
+		cir_magnitude_48b(buf, 64, mag);
+
+		for (int i = 0; i < 64; i++) {
+			double exact = hypot(re[i], im[i]);
+
+			EXPECT_NEAR(mag[i], exact, exact * 0.025 + 1)
+				<< re[i] << " " << im[i];
+		}
+	}
+}
+
+TEST(TestCirMagnitude, Accuracy16b)
+{
+	int16_t buf[2 * 64];
+	uint32_t mag[64];
+
+	for (int i = 0; i < 64; i++) {
+		double phase = i * (2 * M_PI / 64);
+
+		buf[2 * i] = (int16_t)lround(32767 * cos(phase));
+		buf[2 * i + 1] = (int16_t)lround(32767 * sin(phase));
+	}
+	buf[0] = INT16_MIN;
+	buf[1] = INT16_MIN;
+	cir_magnitude_16b(buf, 64, 2, mag);
+
+	for (int i = 0; i < 64; i++) {
+		double exact = hypot(buf[2 * i], buf[2 * i + 1]) * 4;
+
+		EXPECT_NEAR(mag[i], exact, exact * 0.025 + 1) << i;
+	}
+}
+
+TEST(TestCirAnalyse, LineOfSight)
+{
+	int32_t re[WINDOW_LEN];
+	int32_t im[WINDOW_LEN];
+	uint8_t buf[6 * WINDOW_LEN];
+	uint32_t mag[WINDOW_LEN];
+	cir_analysis_t res;
+
+	make_window(re, im, 300, 32, 20000, 32, 20000);
+	for (int i = 0; i < WINDOW_LEN; i++) {
+		put_sample_48b(&buf[6 * i], re[i], im[i]);
+	}
+	cir_magnitude_48b(buf, WINDOW_LEN, mag);
+
+	ASSERT_EQ(cir_analyse(mag, WINDOW_LEN, 700, NULL, &res), DWT_SUCCESS);
+	EXPECT_NEAR(res.noise_mean, 300, 60);
+	EXPECT_EQ(res.peak_index, 732);
+	EXPECT_EQ(res.fp_mag, res.peak_mag);
+	EXPECT_EQ(res.fp_to_peak_q8, 0);
+	/* The leading edge is between the noise and the rising sample before
+	 * the peak. */
+	EXPECT_GT(res.fp_index, 730 << 6);
+	EXPECT_LE(res.fp_index, 731 << 6);
+}
+
+TEST(TestCirAnalyse, NonLineOfSight)
+{
+	int32_t re[WINDOW_LEN];
+	int32_t im[WINDOW_LEN];
+	int16_t buf[2 * WINDOW_LEN];
+	uint32_t mag[WINDOW_LEN];
+	cir_analysis_t res;
+
+	/* Weak direct path 12 dB below a reflection 5 samples later. */
+	make_window(re, im, 100, 30, 2500, 35, 10000);
+	for (int i = 0; i < WINDOW_LEN; i++) {
+		buf[2 * i] = (int16_t)(re[i] >> 1);
+		buf[2 * i + 1] = (int16_t)(im[i] >> 1);
+	}
+	cir_magnitude_16b(buf, WINDOW_LEN, 1, mag);
+
+	ASSERT_EQ(cir_analyse(mag, WINDOW_LEN, 0, NULL, &res), DWT_SUCCESS);
+	EXPECT_EQ(res.peak_index, 35);
+	EXPECT_GT(res.fp_index, 28 << 6);
+	EXPECT_LE(res.fp_index, 29 << 6);
+	EXPECT_NEAR(res.fp_to_peak_q8 / 256.0, -12.04, 0.5);
+}
+
+TEST(TestCirAnalyse, LeadingEdgeInterpolation)
+{
+	uint32_t mag[32] = {};
+	cir_analysis_cfg_t cfg = { 16, 0, 128 };
+	cir_analysis_t res;
+
+	/* Flat noise floor 100, ramp 100, 300, 500, 700 to the peak at 20. */
+	for (int i = 0; i < 32; i++) {
+		mag[i] = 100;
+	}
+	mag[17] = 300;
+	mag[18] = 500;
+	mag[19] = 700;
+	mag[20] = 1000;
+
+	/* Threshold is half the peak, 500: exactly sample 18. */
+	ASSERT_EQ(cir_analyse(mag, 32, 0, &cfg, &res), DWT_SUCCESS);
+	EXPECT_EQ(res.threshold, 500U);
+	EXPECT_EQ(res.fp_index, 18 << 6);
+
+	/* About 600, half way between 18 and 19. */
+	cfg.pmult_q8 = 154;
+	ASSERT_EQ(cir_analyse(mag, 32, 0, &cfg, &res), DWT_SUCCESS);
+	EXPECT_EQ(res.threshold, 601U);
+	EXPECT_NEAR(res.fp_index, (18 << 6) + 32, 1);
+	EXPECT_EQ(res.fp_mag, 1000U);
+}
+
+TEST(TestCirAnalyse, InvalidParameters)
+{
+	uint32_t mag[16] = {};
+	cir_analysis_t res;
+
+	EXPECT_EQ(cir_analyse(mag, 16, 0, NULL, &res), DWT_ERROR);
+	EXPECT_EQ(cir_analyse(NULL, 32, 0, NULL, &res), DWT_ERROR);
+	EXPECT_EQ(cir_analyse(mag, 16, 0, NULL, NULL), DWT_ERROR);
+
+	/* All zero: no first path power. */
+	cir_analysis_cfg_t cfg = { 8, 6, 16 };
+	ASSERT_EQ(cir_analyse(mag, 16, 0, &cfg, &res), DWT_SUCCESS);
+	EXPECT_EQ(res.fp_to_peak_q8, SHRT_MIN);
+}
@@ -0,0 +1,157 @@
+/*
+ * Tests of the sample packing of dwt_readcir_stream() on the SPI emulator.
+ */
+
+#include <string.h>
+#include <vector>
+#include <gtest/gtest.h>
+
+extern "C"
+{
+#include "deca_interface.h"
+#include "deca_device_api.h"
+#include "dw3000_deca_regs.h"
+#include "dw3000_deca_vals.h"
+}
+
+#include "spi_emul.h"
+
+extern const struct dwt_driver_s dw3000_driver;
+
+struct stream_out {
+	std::vector<uint8_t> data;
+	std::vector<uint8_t> exponents;
+	uint16_t num_samples;
+};
+
+static int32_t stream_sink(const uint8_t *data, uint16_t length, uint16_t num_samples, uint8_t exponent,
+			   void *user_data)
+{
+	struct stream_out *out = (struct stream_out *)user_data;
+
+	out->data.insert(out->data.end(), data, data + length);
+	out->exponents.push_back(exponent);
+	out->num_samples += num_samples;
+	return DWT_SUCCESS;
+}
+
+struct TestCirStream:public::testing::Test {
+    public:
+	void SetUp() override
+	{
+		ASSERT_EQ(spi_emul_probe((uint32_t)DWT_DW3000_PDOA_DEV_ID, &dw3000_driver), DWT_SUCCESS);
+		ASSERT_EQ(dwt_initialise(DWT_DW_INIT), DWT_SUCCESS);
+	}
+
+	/* the accumulator is read through the indirect pointer, which the
+	 * emulator returns for every chunk, after the dummy byte */
+	void SetSamples(const int32_t *parts, uint16_t num_parts)
+	{
+		uint8_t buf[1 + 6 * CHUNK_CIR_STREAM_NB_SAMP] = { 0 };
+
+		for (uint16_t k = 0; k < num_parts; k++) {
+			uint32_t v = (uint32_t)parts[k] & 0xFFFFFF;
+
+			buf[1 + 3 * k] = (uint8_t)v;
+			buf[2 + 3 * k] = (uint8_t)(v >> 8);
+			buf[3 + 3 * k] = (uint8_t)(v >> 16);
+		}
+		spi_emul_write(INDIRECT_POINTER_A_ID, 0, buf, sizeof(buf));
+	}
+
+	void Stream(uint16_t num_samples, dwt_cir_pack_e pack)
+	{
+		out = stream_out();
+		ASSERT_EQ(dwt_readcir_stream(DWT_ACC_IDX_IP_M, 0, num_samples, pack, stream_sink, &out), DWT_SUCCESS);
+		EXPECT_EQ(out.num_samples, num_samples);
+	}
+
+	int16_t Bfp16(size_t k)
+	{
+		return (int16_t)(out.data[2 * k] | (out.data[2 * k + 1] << 8));
+	}
+
+    protected:
+	struct stream_out out;
+};
+
+TEST_F(TestCirStream, Full48b)
+{
+	const int32_t parts[] = { 1, -1, 0x1FFFF, -0x20000 };
+
+	SetSamples(parts, 4);
+	Stream(2, DWT_CIR_PACK_48B);
+	ASSERT_EQ(out.data.size(), 12U);
+	EXPECT_EQ(out.exponents[0], 0);
+	EXPECT_EQ(out.data[3], 0xFF); /* -1, low byte of the imaginary part */
+}
+
+TEST_F(TestCirStream, Packed18b)
+{
+	const int32_t parts[] = { 0x12345, -2, 0x1FFFF, -0x20000, 7, -7 };
+	uint8_t expect[14] = { 0 };
+	uint32_t bit = 0;
+
+	SetSamples(parts, 6);
+	Stream(3, DWT_CIR_PACK_18B);
+
+	/* 18 bit parts LSB first, the odd last byte is padded */
+	for (int32_t p : parts) {
+		for (int b = 0; b < 18; b++, bit++) {
+			if (((uint32_t)p >> b) & 1U) {
+				expect[bit / 8] |= (uint8_t)(1U << (bit % 8));
+			}
+		}
+	}
+	ASSERT_EQ(out.data.size(), sizeof(expect));
+	EXPECT_EQ(memcmp(out.data.data(), expect, sizeof(expect)), 0);
+}
+
+TEST_F(TestCirStream, Bfp16NoShift)
+{
+	/* the full int16 range, including -32768, fits without shift */
+	const int32_t parts[] = { 0x7FFF, -0x8000, -1, 3 };
+
+	SetSamples(parts, 4);
+	Stream(2, DWT_CIR_PACK_BFP16);
+	ASSERT_EQ(out.data.size(), 8U);
+	EXPECT_EQ(out.exponents[0], 0);
+	for (size_t k = 0; k < 4; k++) {
+		EXPECT_EQ(Bfp16(k), parts[k]) << k;
+	}
+}
+
+TEST_F(TestCirStream, Bfp16Exponent)
+{
+	const struct {
+		int32_t max;
+		uint8_t exponent;
+	} cases[] = {
+		{ 0x8000, 1 }, { -0x8001, 1 }, { 0xFFFF, 1 }, { 0x10000, 2 }, { 0x1FFFF, 2 }, { -0x20000, 2 },
+	};
+
+	for (const auto &c : cases) {
+		const int32_t parts[] = { c.max, 5, -5, -1 };
+
+		SetSamples(parts, 4);
+		Stream(2, DWT_CIR_PACK_BFP16);
+		ASSERT_EQ(out.exponents.size(), 1U);
+		EXPECT_EQ(out.exponents[0], c.exponent) << c.max;
+		/* shifted right with sign, so rounded down */
+		for (size_t k = 0; k < 4; k++) {
+			EXPECT_EQ(Bfp16(k), parts[k] >> c.exponent) << c.max << " " << k;
+		}
+	}
+}
+
+TEST_F(TestCirStream, Bfp16ExponentPerChunk)
+{
+	const int32_t parts[] = { 0x1FFFF, 1 };
+
+	SetSamples(parts, 2);
+	Stream(CHUNK_CIR_STREAM_NB_SAMP + 1, DWT_CIR_PACK_BFP16);
+	ASSERT_EQ(out.exponents.size(), 2U);
+	EXPECT_EQ(out.exponents[0], 2);
+	EXPECT_EQ(out.exponents[1], 2);
+	EXPECT_EQ(out.data.size(), 4U * (CHUNK_CIR_STREAM_NB_SAMP + 1));
+}
@@ -0,0 +1,134 @@
+/*
+ * Tests of the clock tracking on simulated sync frames.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+extern "C"
+{
+#include "deca_device_api.h"
+#include "deca_clktrack.h"
+}
+
+#define TS_MASK 0xFFFFFFFFFFULL
+/* 100 ms in device time units */
+#define SYNC_INTERVAL 6389760000ULL
+
+/* A reference clock running at (1 + skew) of the local one, with timestamp
+ * noise of up to +-noise device time units */
+struct SimClock {
+	double skew;
+	double ref0;
+	int noise;
+	uint32_t seed = 0x13579BD;
+
+	uint64_t ref(double local) { return (uint64_t)llround(ref0 + local * (1 + skew)) & TS_MASK; }
+
+	int64_t rnd()
+	{
+		seed = seed * 1103515245U + 12345U;
+		return noise ? (int64_t)((seed >> 8) % (2 * noise + 1)) - noise : 0;
+	}
+};
+
+static int64_t ts_diff(uint64_t a, uint64_t b)
+{
+	int64_t d = (int64_t)((a - b) & TS_MASK);
+
+	return d >= (1LL << 39) ? d - (1LL << 40) : d;
+}
+
+TEST(TestClkTrack, Converges)
+{
+	SimClock sim = { 20e-6, 123456789.0, 8 };
+	clktrack_t t;
+
+	clktrack_reset(&t);
+	/* 30 s, the local and reference timestamps wrap */
+	for (int i = 0; i < 300; i++) {
+		double local = (double)(0xFF00000000ULL + i * SYNC_INTERVAL);
+		int ret = clktrack_update(&t, NULL, sim.ref(local) + sim.rnd(),
+					  (uint64_t)local + sim.rnd(), 0);
+
+		ASSERT_EQ(ret, i == 0 ? CLKTRACK_INIT : CLKTRACK_OK) << i;
+	}
+
+	EXPECT_NEAR(clktrack_skew_ppm_q16(&t) / 65536.0, 20.0, 0.005);
+
+	/* conversions between the syncs and far from them */
+	for (double dt : { 0.0, 0.05e9, 1e9, -2e9 }) {
+		double local = (double)(0xFF00000000ULL + 299 * SYNC_INTERVAL) + dt;
+		uint64_t l = (uint64_t)local & TS_MASK;
+		uint64_t r = clktrack_to_ref(&t, l);
+
+		EXPECT_LE(std::abs(ts_diff(r, sim.ref(local))), 30) << dt;
+		EXPECT_LE(std::abs(ts_diff(clktrack_to_local(&t, r), l)), 1) << dt;
+	}
+}
+
+TEST(TestClkTrack, Outliers)
+{
+	SimClock sim = { -12e-6, 5e11, 0 };
+	clktrack_t t;
+	uint64_t local = 1000;
+
+	clktrack_reset(&t);
+	for (int i = 0; i < 10; i++, local += SYNC_INTERVAL) {
+		clktrack_update(&t, NULL, sim.ref(local), local, 0);
+	}
+	clktrack_t before = t;
+
+	/* a sync 1 us off is rejected and does not change the estimate */
+	EXPECT_EQ(clktrack_update(&t, NULL, sim.ref(local) + 64000, local, 0), CLKTRACK_OUTLIER);
+	EXPECT_EQ(t.ref_ts, before.ref_ts);
+	EXPECT_EQ(t.skew_q32, before.skew_q32);
+	local += SYNC_INTERVAL;
+	EXPECT_EQ(clktrack_update(&t, NULL, sim.ref(local), local, 0), CLKTRACK_OK);
+	local += SYNC_INTERVAL;
+
+	/* the reference restarted: tracking restarts after 3 outliers */
+	sim.ref0 += 1e9;
+	EXPECT_EQ(clktrack_update(&t, NULL, sim.ref(local), local, 0), CLKTRACK_OUTLIER);
+	local += SYNC_INTERVAL;
+	EXPECT_EQ(clktrack_update(&t, NULL, sim.ref(local), local, 0), CLKTRACK_OUTLIER);
+	local += SYNC_INTERVAL;
+	EXPECT_EQ(clktrack_update(&t, NULL, sim.ref(local), local, 0), CLKTRACK_INIT);
+	local += SYNC_INTERVAL;
+	EXPECT_EQ(clktrack_update(&t, NULL, sim.ref(local), local, 0), CLKTRACK_OK);
+	EXPECT_NEAR(clktrack_skew_ppm_q16(&t) / 65536.0, -12.0, 0.001);
+	EXPECT_LE(std::abs(ts_diff(clktrack_to_ref(&t, local + SYNC_INTERVAL),
+				   sim.ref(local + SYNC_INTERVAL))), 1);
+
+	/* too long without sync */
+	local += 10 * SYNC_INTERVAL * 10;
+	EXPECT_EQ(clktrack_update(&t, NULL, sim.ref(local), local, 0), CLKTRACK_INIT);
+}
+
+TEST(TestClkTrack, CarrierClockOffset)
+{
+	SimClock sim = { 20e-6, 0, 0 };
+	clktrack_cfg_t cfg = { CLKTRACK_DEFAULT_ALPHA_Q8, CLKTRACK_DEFAULT_BETA_Q8, 32,
+			       CLKTRACK_DEFAULT_MAX_OUTLIERS, CLKTRACK_DEFAULT_MAX_INNOVATION,
+			       CLKTRACK_DEFAULT_MAX_INTERVAL };
+	/* 20 ppm in s[-15:-26] */
+	int16_t clock_offset = (int16_t)lround(20e-6 * (1 << 26));
+	dwt_rxreport_t report = {};
+	clktrack_t t;
+
+	clktrack_reset(&t);
+	report.clockOffset = clock_offset;
+	report.rxTime[0] = 0x10;
+
+	/* the first sync already predicts with the carrier clock offset */
+	EXPECT_EQ(clktrack_update_rx(&t, &cfg, sim.ref(0x10), &report), CLKTRACK_INIT);
+	EXPECT_NEAR(clktrack_skew_ppm_q16(&t) / 65536.0, 20.0, 0.01);
+	EXPECT_LE(std::abs(ts_diff(clktrack_to_ref(&t, 0x10 + SYNC_INTERVAL),
+				   sim.ref(0x10 + SYNC_INTERVAL))), 100);
+
+	for (uint64_t local = 0x10 + SYNC_INTERVAL; local < 20 * SYNC_INTERVAL; local += SYNC_INTERVAL) {
+		EXPECT_EQ(clktrack_update(&t, &cfg, sim.ref(local), local, clock_offset), CLKTRACK_OK);
+	}
+	EXPECT_NEAR(clktrack_skew_ppm_q16(&t) / 65536.0, 20.0, 0.01);
+}
@@ -0,0 +1,107 @@
+/*
+ * Tests of the fixed point conversions against the float versions: the
+ * results have to be the float value rounded to the nearest LSB, allowing for
+ * the rounding error of the float math (4 ulp for float, 2^-20 for double).
+ */
+
+#include <gtest/gtest.h>
+
+#include <cfloat>
+#include <cmath>
+
+extern "C"
+{
+#include "deca_device_api.h"
+#include "deca_conv.h"
+}
+
+static double float_tolerance(float f, double scale)
+{
+	return 0.5 + (4 * fabsf(f) * FLT_EPSILON * scale);
+}
+
+#define DOUBLE_TOLERANCE (0.5 + 1.0 / (1 << 20))
+
+/* the float formulas of dwt_convertrawtemperature() of the DW3000 and the
+ * DW3720, and of dwt_convertrawvoltage() */
+static float temperature_float_dw3000(uint8_t raw_temp, uint8_t otp_temp)
+{
+	return (((float)raw_temp - (float)otp_temp) * 1.05f) + 22.0f;
+}
+
+static float temperature_float_dw3720(uint8_t raw_temp, uint8_t otp_temp)
+{
+	return (((float)raw_temp - (float)otp_temp) * 1.05f) + 25.0f;
+}
+
+static float voltage_float(uint8_t raw_voltage, uint8_t otp_vbat)
+{
+	return (((float)raw_voltage - (float)otp_vbat) * 0.4f * 16.0f / 255.0f) + 3.0f;
+}
+
+TEST(TestConv, TemperatureDw3000)
+{
+	for (int otp = 0; otp < 256; otp++) {
+		for (int raw = 0; raw < 256; raw++) {
+			float f = temperature_float_dw3000(raw, otp);
+
+			ASSERT_NEAR(conv_temperature_q8(raw, otp, CONV_OTP_TEMP_C_DW3000),
+				    f * 256, float_tolerance(f, 256))
+				<< raw << " " << otp;
+		}
+	}
+	EXPECT_EQ(conv_temperature_q8(0x80, 0x80, CONV_OTP_TEMP_C_DW3000), 22 << 8);
+}
+
+TEST(TestConv, TemperatureDw3720)
+{
+	for (int otp = 0; otp < 256; otp++) {
+		for (int raw = 0; raw < 256; raw++) {
+			float f = temperature_float_dw3720(raw, otp);
+
+			ASSERT_NEAR(conv_temperature_q8(raw, otp, CONV_OTP_TEMP_C_DW3720),
+				    f * 256, float_tolerance(f, 256))
+				<< raw << " " << otp;
+		}
+	}
+	EXPECT_EQ(conv_temperature_q8(0x80, 0x80, CONV_OTP_TEMP_C_DW3720), 25 << 8);
+}
+
+TEST(TestConv, Voltage)
+{
+	for (int otp = 0; otp < 256; otp++) {
+		for (int raw = 0; raw < 256; raw++) {
+			float f = voltage_float(raw, otp);
+
+			ASSERT_NEAR(conv_voltage_q16(raw, otp), f * 65536,
+				    float_tolerance(f, 65536))
+				<< raw << " " << otp;
+		}
+	}
+	EXPECT_EQ(conv_voltage_q16(0x90, 0x90), 3 << 16);
+}
+
+TEST(TestConv, ClockOffset)
+{
+	for (int32_t offs = -2048; offs < 2048; offs++) {
+		double ppm = offs * CLOCK_OFFSET_PPM_TO_RATIO * 1e6;
+
+		ASSERT_NEAR(conv_clockoffset_ppm_q16(offs), ppm * 65536, DOUBLE_TOLERANCE)
+			<< offs;
+	}
+}
+
+TEST(TestConv, CarrierIntegrator)
+{
+	/* 21 bit signed */
+	for (int32_t ci = -(1 << 20); ci < (1 << 20); ci += 7) {
+		double hz = ci * FREQ_OFFSET_MULTIPLIER;
+
+		ASSERT_NEAR(conv_carrierintegrator_ppm_q16(ci, 5),
+			    hz * HERTZ_TO_PPM_MULTIPLIER_CHAN_5 * 65536, DOUBLE_TOLERANCE)
+			<< ci;
+		ASSERT_NEAR(conv_carrierintegrator_ppm_q16(ci, 9),
+			    hz * HERTZ_TO_PPM_MULTIPLIER_CHAN_9 * 65536, DOUBLE_TOLERANCE)
+			<< ci;
+	}
+}
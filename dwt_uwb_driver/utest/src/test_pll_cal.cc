@@ -0,0 +1,123 @@
+/*
+ * Tests of the PLL calibration cache of the DW3720 automotive PLL calibration
+ * on the SPI emulator.
+ */
+
+#include <gtest/gtest.h>
+
+extern "C"
+{
+#include "deca_interface.h"
+#include "deca_device_api.h"
+#include "dw3720_deca_regs.h"
+}
+
+#include "spi_emul.h"
+
+extern const struct dwt_driver_s dw3720_driver;
+
+/* the CH5 coarse code the emulated VCO locks on, the search from the OTP
+ * code 0 needs 5 steps to get there */
+#define PLL_CH5_LOCK_CODE 0x1FU
+
+void deca_usleep(unsigned long time_us)
+{
+	(void)time_us;
+}
+
+void deca_sleep(unsigned int time_ms)
+{
+	(void)time_ms;
+}
+
+decaIrqStatus_t decamutexon(void)
+{
+	return 0;
+}
+
+void decamutexoff(decaIrqStatus_t s)
+{
+	(void)s;
+}
+
+static int pll_checks;
+
+/* RF_STATUS of the CH5 VCO for the coarse code in PLL_COARSE_CODE: below
+ * PLL_CH5_LOCK_CODE the low threshold is not reached, above it the high
+ * threshold is exceeded */
+static void emul_vco_ch5(void)
+{
+	uint32_t code = (spi_emul_read32(PLL_COARSE_CODE_ID) & PLL_COARSE_CODE_CH5_VCO_COARSE_TUNE_BIT_MASK) >>
+			PLL_COARSE_CODE_CH5_VCO_COARSE_TUNE_BIT_OFFSET;
+	uint32_t rf_status = 0x0U;
+
+	if (code == PLL_CH5_LOCK_CODE) {
+		rf_status = RF_STATUS_PLL1_LO_FLAG_BIT_MASK | 0x1U;
+	} else if (code > PLL_CH5_LOCK_CODE) {
+		rf_status = RF_STATUS_PLL1_HI_FLAG_BIT_MASK | RF_STATUS_PLL1_LO_FLAG_BIT_MASK;
+	}
+	spi_emul_write32(RF_STATUS_ID, rf_status);
+	pll_checks++;
+	spi_emul_on_read(RF_STATUS_ID, emul_vco_ch5);
+}
+
+struct TestPllCalCache:public::testing::Test {
+    public:
+	void SetUp() override
+	{
+		ASSERT_EQ(spi_emul_probe((uint32_t)DWT_QM33120_PDOA_DEV_ID, &dw3720_driver), DWT_SUCCESS);
+		spi_emul_write32(PLL_STATUS_ID, 0x46U);
+		spi_emul_on_read(RF_STATUS_ID, emul_vco_ch5);
+		ASSERT_EQ(dwt_initialise(DWT_DW_INIT), DWT_SUCCESS);
+		pll_checks = 0;
+	}
+
+    protected:
+	dwt_config_t config = {
+		5,		  /* Channel number. */
+		DWT_PLEN_128,	  /* Preamble length. Used in TX only. */
+		DWT_PAC8,	  /* Preamble acquisition chunk size. Used in RX only. */
+		9,		  /* TX preamble code. Used in TX only. */
+		9,		  /* RX preamble code. Used in RX only. */
+		DWT_SFD_DW_8,	  /* SFD type */
+		DWT_BR_6M8,	  /* Data rate. */
+		DWT_PHRMODE_STD,  /* PHY header mode. */
+		DWT_PHRRATE_STD,  /* PHY header rate. */
+		(129 + 8 - 8),	  /* SFD timeout */
+		DWT_STS_MODE_OFF, /* STS disabled */
+		DWT_STS_LEN_64,	  /* STS length */
+		DWT_PDOA_M0	  /* PDOA mode off */
+	};
+};
+
+/* without a cache every calibration searches from the OTP code */
+TEST_F(TestPllCalCache, NoCache)
+{
+	ASSERT_EQ(dwt_configure(&config), DWT_SUCCESS);
+	EXPECT_EQ(pll_checks, 6);
+
+	pll_checks = 0;
+	ASSERT_EQ(dwt_configure(&config), DWT_SUCCESS);
+	EXPECT_EQ(pll_checks, 6);
+}
+
+/* the first calibration stores the code it locked on, the next one locks on
+ * it at the first check */
+TEST_F(TestPllCalCache, CachedCodeSkipsSearch)
+{
+	dwt_pll_cal_cache_t cache = {};
+
+	ASSERT_EQ(dwt_setpllcalcache(&cache), DWT_SUCCESS);
+	ASSERT_EQ(dwt_configure(&config), DWT_SUCCESS);
+	EXPECT_EQ(pll_checks, 6);
+	EXPECT_EQ(cache.misses, 1U);
+	EXPECT_EQ(cache.hits, 0U);
+	ASSERT_NE(cache.ch5Valid, 0U);
+
+	pll_checks = 0;
+	ASSERT_EQ(dwt_configure(&config), DWT_SUCCESS);
+	EXPECT_EQ(pll_checks, 1);
+	EXPECT_EQ(cache.misses, 1U);
+	EXPECT_EQ(cache.hits, 1U);
+	EXPECT_EQ(cache.ch9Valid, 0U);
+}
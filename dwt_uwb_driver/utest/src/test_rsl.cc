@@ -6,6 +6,7 @@
 
 #include <gtest/gtest.h>
 
+#include <climits>
 #include <cmath>
 
 extern "C"
@@ -205,4 +206,162 @@ TEST_P(TestLLHWRxPower, ForEachCase)
 }
 
 INSTANTIATE_TEST_CASE_P(ForEachCase, TestLLHWRxPower,
-			::testing::ValuesIn(TestLLHWRxPower::test_cases));
\ No newline at end of file
+			::testing::ValuesIn(TestLLHWRxPower::test_cases));
+
+TEST(TestRslBatch, SignalPowerTestCases)
+{
+	for (const SignalPowerTestCase &params :
+	     SignalPowerPrecisionTest::test_cases) {
+		dwt_rxreport_t report = {};
+		int16_t rsl_q8;
+
+		report.ipatovPower = params.channel_impulse_response;
+		report.ipatovAccumCount = params.preamble_accumulation_count;
+		report.dgcDecision = (uint8_t)params.dgc_decision;
+
+		rsl_calculate_batch(&report, 1, params.quantization_factor,
+				    params.rx_pcode, &rsl_q8, NULL);
+
+		if (params.expected_rssi_dbm != invalid_q8) {
+			EXPECT_NEAR(params.expected_rssi_dbm,
+				    convert_q_to_double(rsl_q8, 8), 0.05);
+		} else {
+			/* Far below -128 dBm or invalid. */
+			EXPECT_EQ(rsl_q8, SHRT_MIN);
+		}
+	}
+}
+
+TEST(TestRslBatch, FirstPathTestCases)
+{
+	for (const RxPowerTestCase &params : TestLLHWRxPower::test_cases) {
+		dwt_rxreport_t report = {};
+		int16_t rsl_q8;
+		int16_t fsl_q8;
+
+		report.ipatovPower = params.power;
+		report.ipatovF1 = params.f1;
+		report.ipatovF2 = params.f2;
+		report.ipatovF3 = params.f3;
+		report.ipatovAccumCount = params.preamble_accumulation_count;
+		report.dgcDecision = params.dgc_decision;
+
+		/* The RX report has the Ipatov values, no STS. */
+		rsl_calculate_batch(&report, 1, RSL_QUANTIZATION_FACTOR_DW3720,
+				    params.rx_code, &rsl_q8, &fsl_q8);
+
+		EXPECT_NEAR(params.expected_fp_rsl_dbm -
+				    (params.sts ? 1.0 : 0.0),
+			    convert_q_to_double(fsl_q8, 8), 0.05);
+		EXPECT_EQ(rsl_q8,
+			  rsl_calculate_signal_power(
+				  params.power, RSL_QUANTIZATION_FACTOR_DW3720,
+				  params.preamble_accumulation_count,
+				  params.dgc_decision, params.rx_code, false));
+	}
+}
+
+/*
+ * Pseudo random RX reports over the register ranges, compared with the
+ * floating point estimate and the single frame functions.
+ */
+TEST(TestRslBatch, AgainstCurrentImplementation)
+{
+	constexpr uint16_t count = 2000;
+	static dwt_rxreport_t reports[count];
+	static int16_t rsl_q8[count];
+	static int16_t fsl_q8[count];
+	uint32_t seed = 0x12345678;
+	auto next = [&seed](uint32_t mask) {
+		seed = seed * 1103515245U + 12345U;
+		return (seed >> 8) & mask;
+	};
+
+	for (uint16_t i = 0; i < count; i++) {
+		reports[i].ipatovPower = next(0x1FFFF) + 1;
+		reports[i].ipatovF1 = next(0x3FFFFF) >> next(0xF);
+		reports[i].ipatovF2 = next(0x3FFFFF) >> next(0xF);
+		reports[i].ipatovF3 = next(0x3FFFFF) >> next(0xF);
+		/* Runs of the same count like in a real capture. */
+		reports[i].ipatovAccumCount =
+			(i % 8 == 0) ? (uint16_t)(next(0xFFF) + 1) :
+				       reports[i - 1].ipatovAccumCount;
+		reports[i].dgcDecision = (uint8_t)next(0x7);
+	}
+
+	for (uint8_t qf : { RSL_QUANTIZATION_FACTOR_DW3000,
+			    RSL_QUANTIZATION_FACTOR_DW3720 }) {
+		rsl_calculate_batch(reports, count, qf, 9, rsl_q8, fsl_q8);
+
+		for (uint16_t i = 0; i < count; i++) {
+			const dwt_rxreport_t &r = reports[i];
+			double constant_dbm = GetRssiConstant(9, false);
+			double f1 = (double)(r.ipatovF1 / 4);
+			double f2 = (double)(r.ipatovF2 / 4);
+			double f3 = (double)(r.ipatovF3 / 4);
+			double area = f1 * f1 + f2 * f2 + f3 * f3;
+			double rsl_dbm = EstimateReceiveSignalPower(
+				(double)r.ipatovPower * (1 << qf),
+				r.ipatovAccumCount, r.dgcDecision, constant_dbm);
+
+			ASSERT_NEAR(convert_q_to_double(rsl_q8[i], 8), rsl_dbm,
+				    0.05) << "frame " << i;
+			if (area == 0) {
+				EXPECT_EQ(fsl_q8[i], SHRT_MIN) << "frame " << i;
+			} else {
+				double fsl_dbm = EstimateReceiveSignalPower(
+					area, r.ipatovAccumCount, r.dgcDecision,
+					constant_dbm);
+
+				if (fsl_dbm > -128.0) {
+					ASSERT_NEAR(convert_q_to_double(fsl_q8[i], 8),
+						    fsl_dbm, 0.05)
+						<< "frame " << i;
+				} else {
+					EXPECT_EQ(fsl_q8[i], SHRT_MIN);
+				}
+			}
+
+			/* Where the current implementation is valid (no
+			 * overflow and not below the noise floor) both agree
+			 * within the error of its coarser lut. */
+			if ((uint64_t)r.ipatovPower << qf >=
+			    (uint64_t)r.ipatovAccumCount * r.ipatovAccumCount) {
+				EXPECT_NEAR(rsl_q8[i],
+					    rsl_calculate_signal_power(
+						    r.ipatovPower, qf,
+						    r.ipatovAccumCount,
+						    r.dgcDecision, 9, false),
+					    0.15 * 256);
+			}
+			if (area < 4294967296.0 &&
+			    area >= (double)r.ipatovAccumCount *
+					    r.ipatovAccumCount) {
+				EXPECT_NEAR(fsl_q8[i],
+					    rsl_calculate_first_path_power(
+						    r.ipatovF1, r.ipatovF2,
+						    r.ipatovF3,
+						    r.ipatovAccumCount,
+						    r.dgcDecision, 9, false),
+					    0.15 * 256);
+			}
+		}
+	}
+}
+
+TEST(TestRslBatch, NullOutputs)
+{
+	dwt_rxreport_t report = {};
+	int16_t rsl_q8 = 0;
+
+	report.ipatovPower = 40;
+	report.ipatovAccumCount = 65;
+
+	rsl_calculate_batch(&report, 1, RSL_QUANTIZATION_FACTOR_DW3000, 9,
+			    &rsl_q8, NULL);
+	EXPECT_NEAR(convert_q_to_double(rsl_q8, 8), -78.7, 0.05);
+	rsl_calculate_batch(&report, 1, RSL_QUANTIZATION_FACTOR_DW3000, 9,
+			    NULL, NULL);
+	rsl_calculate_batch(NULL, 0, RSL_QUANTIZATION_FACTOR_DW3000, 9, NULL,
+			    NULL);
+}
\ No newline at end of file
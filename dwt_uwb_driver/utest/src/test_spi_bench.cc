@@ -0,0 +1,298 @@
+/*
+ * SPI transaction benchmark of the driver API on the SPI emulator.
+ *
+ * Every test runs one API call (or ISR scenario) and reports the number of
+ * SPI transactions and bytes on the wire. The limits are the current costs,
+ * so a change which adds transactions to these paths fails here and the
+ * limit has to be raised deliberately.
+ */
+
+#include <stdio.h>
+#include <gtest/gtest.h>
+
+extern "C"
+{
+#include "deca_interface.h"
+#include "deca_device_api.h"
+#include "dw3000_deca_regs.h"
+}
+
+#include "spi_emul.h"
+
+extern const struct dwt_driver_s dw3000_driver;
+
+void deca_usleep(unsigned long time_us)
+{
+	(void)time_us;
+}
+
+void deca_sleep(unsigned int time_ms)
+{
+	(void)time_ms;
+}
+
+decaIrqStatus_t decamutexon(void)
+{
+	return 0;
+}
+
+void decamutexoff(decaIrqStatus_t s)
+{
+	(void)s;
+}
+
+static int cb_tx_done_cnt;
+static int cb_rx_ok_cnt;
+static int cb_spi_err_cnt;
+static uint16_t cb_rx_len;
+
+static void cb_tx_done(const dwt_cb_data_t *cb_data)
+{
+	(void)cb_data;
+	cb_tx_done_cnt++;
+}
+
+static void cb_rx_ok(const dwt_cb_data_t *cb_data)
+{
+	cb_rx_ok_cnt++;
+	cb_rx_len = cb_data->datalength;
+}
+
+static void cb_spi_err(const dwt_cb_data_t *cb_data)
+{
+	(void)cb_data;
+	cb_spi_err_cnt++;
+}
+
+struct TestSpiBench:public::testing::Test {
+    public:
+	void SetUp() override
+	{
+		ASSERT_EQ(spi_emul_probe((uint32_t)DWT_DW3000_PDOA_DEV_ID, &dw3000_driver), DWT_SUCCESS);
+		spi_emul_w1c(SYS_STATUS_ID);
+		spi_emul_w1c(SYS_STATUS_HI_ID);
+		spi_emul_clear_stats();
+	}
+
+	void Initialise()
+	{
+		ASSERT_EQ(dwt_initialise(DWT_DW_INIT), DWT_SUCCESS);
+	}
+
+	void Configure()
+	{
+		Initialise();
+		ASSERT_EQ(dwt_configure(&config), DWT_SUCCESS);
+	}
+
+	void SetCallbacks()
+	{
+		dwt_callbacks_s cbs = {};
+
+		cbs.cbTxDone = cb_tx_done;
+		cbs.cbRxOk = cb_rx_ok;
+		cbs.cbSPIErr = cb_spi_err;
+		dwt_setcallbacks(&cbs);
+		cb_tx_done_cnt = 0;
+		cb_rx_ok_cnt = 0;
+		cb_spi_err_cnt = 0;
+	}
+
+	/* print the cost of the calls since the last clear and check it */
+	void Report(const char *name, uint32_t max_xfers, uint32_t max_bytes)
+	{
+		const struct spi_emul_stats *s = spi_emul_get_stats();
+		uint32_t bytes = s->header_bytes + s->body_bytes;
+
+		printf("%-26s xfers %4u (rd %4u wr %4u fast %2u) header %5u body %6u\n", name,
+		       s->xfers, s->reads, s->writes, s->fast_cmds, s->header_bytes,
+		       s->body_bytes);
+		EXPECT_LE(s->xfers, max_xfers) << name;
+		EXPECT_LE(bytes, max_bytes) << name;
+	}
+
+    protected:
+	dwt_config_t config = {
+		5,		  /* Channel number. */
+		DWT_PLEN_128,	  /* Preamble length. Used in TX only. */
+		DWT_PAC8,	  /* Preamble acquisition chunk size. Used in RX only. */
+		9,		  /* TX preamble code. Used in TX only. */
+		9,		  /* RX preamble code. Used in RX only. */
+		DWT_SFD_DW_8,	  /* SFD type */
+		DWT_BR_6M8,	  /* Data rate. */
+		DWT_PHRMODE_STD,  /* PHY header mode. */
+		DWT_PHRRATE_STD,  /* PHY header rate. */
+		(129 + 8 - 8),	  /* SFD timeout */
+		DWT_STS_MODE_OFF, /* STS disabled */
+		DWT_STS_LEN_64,	  /* STS length */
+		DWT_PDOA_M0	  /* PDOA mode off */
+	};
+};
+
+TEST_F(TestSpiBench, Initialise)
+{
+	Initialise();
+	Report("dwt_initialise", 35, 154);
+}
+
+TEST_F(TestSpiBench, Configure)
+{
+	Initialise();
+	spi_emul_clear_stats();
+
+	ASSERT_EQ(dwt_configure(&config), DWT_SUCCESS);
+	Report("dwt_configure", 51, 271);
+}
+
+TEST_F(TestSpiBench, StartTx)
+{
+	uint8_t frame[12] = { 0x41, 0x88, 0x00, 0xCA, 0xDE };
+
+	Configure();
+	spi_emul_clear_stats();
+
+	dwt_writetxdata(sizeof(frame), frame, 0);
+	dwt_writetxfctrl(sizeof(frame) + FCS_LEN, 0, 0);
+	ASSERT_EQ(dwt_starttx(DWT_START_TX_IMMEDIATE), DWT_SUCCESS);
+	EXPECT_EQ(spi_emul_last_cmd(), CMD_TX);
+	Report("dwt_writetxdata/starttx", 3, 24);
+}
+
+TEST_F(TestSpiBench, StartTxDelayed)
+{
+	Configure();
+	spi_emul_clear_stats();
+
+	dwt_setdelayedtrxtime(0x12345678);
+	ASSERT_EQ(dwt_starttx(DWT_START_TX_DELAYED), DWT_SUCCESS);
+	EXPECT_EQ(spi_emul_last_cmd(), CMD_DTX);
+	Report("dwt_starttx delayed", 4, 16);
+}
+
+TEST_F(TestSpiBench, IsrTxDone)
+{
+	Configure();
+	SetCallbacks();
+	spi_emul_write32(FINT_STAT_ID, FINT_STAT_TXOK_BIT_MASK);
+	spi_emul_write32(SYS_STATUS_ID, SYS_STATUS_TXFRS_BIT_MASK | SYS_STATUS_TXPHS_BIT_MASK |
+						SYS_STATUS_TXPRS_BIT_MASK | SYS_STATUS_TXFRB_BIT_MASK);
+	spi_emul_clear_stats();
+
+	dwt_isr();
+	EXPECT_EQ(cb_tx_done_cnt, 1);
+	EXPECT_EQ(spi_emul_read32(SYS_STATUS_ID) & SYS_STATUS_TXFRS_BIT_MASK, 0U);
+	Report("dwt_isr TX done", 4, 25);
+}
+
+TEST_F(TestSpiBench, IsrRxGood)
+{
+	uint8_t frame[20];
+
+	Configure();
+	SetCallbacks();
+	spi_emul_write32(FINT_STAT_ID, FINT_STAT_RXOK_BIT_MASK);
+	spi_emul_write32(SYS_STATUS_ID, SYS_STATUS_RXFCG_BIT_MASK | SYS_STATUS_RXFR_BIT_MASK |
+						SYS_STATUS_RXPHD_BIT_MASK | SYS_STATUS_RXSFDD_BIT_MASK |
+						SYS_STATUS_RXPRD_BIT_MASK | SYS_STATUS_CIADONE_BIT_MASK);
+	spi_emul_write32(RX_FINFO_ID, sizeof(frame));
+	spi_emul_clear_stats();
+
+	dwt_isr();
+	EXPECT_EQ(cb_rx_ok_cnt, 1);
+	EXPECT_EQ(cb_rx_len, sizeof(frame));
+	Report("dwt_isr RX good", 3, 22);
+
+	spi_emul_clear_stats();
+	dwt_readrxdata(frame, sizeof(frame) - FCS_LEN, 0);
+	Report("dwt_readrxdata", 1, 19);
+}
+
+/* the clear of SYS_STATUS and SYS_STATUS_HI is one chained write */
+TEST_F(TestSpiBench, IsrSpiError)
+{
+	Configure();
+	SetCallbacks();
+	spi_emul_write32(FINT_STAT_ID, FINT_STAT_SYS_PANIC_BIT_MASK);
+	spi_emul_write32(SYS_STATUS_HI_ID, SYS_STATUS_HI_SPIERR_BIT_MASK);
+	spi_emul_clear_stats();
+
+	dwt_isr();
+	EXPECT_EQ(cb_spi_err_cnt, 1);
+	EXPECT_EQ(spi_emul_read32(SYS_STATUS_HI_ID) & SYS_STATUS_HI_SPIERR_BIT_MASK, 0U);
+	Report("dwt_isr SPI error", 3, 24);
+}
+
+/* a patch behind offset 127 of the TX buffer is written indirectly, the
+ * indirect address and offset registers are written in one chained write */
+TEST_F(TestSpiBench, SendTemplateIndirect)
+{
+	uint8_t frame[20] = { 0x41, 0x88, 0x00, 0xCA, 0xDE };
+	uint8_t seq = 0x5A;
+	dwt_txtemplate_t tpl;
+	dwt_txpatch_t patch = { 2, 1, &seq };
+
+	Configure();
+	ASSERT_EQ(dwt_writetxtemplate(&tpl, sizeof(frame), frame, 200, 0), DWT_SUCCESS);
+	spi_emul_clear_stats();
+
+	ASSERT_EQ(dwt_sendtemplate(&tpl, &patch, 1, 0, DWT_START_TX_IMMEDIATE), DWT_SUCCESS);
+	EXPECT_EQ(spi_emul_last_cmd(), CMD_TX);
+	EXPECT_EQ(spi_emul_read32(INDIRECT_ADDR_A_ID), TX_BUFFER_ID >> 16);
+	EXPECT_EQ(spi_emul_read32(ADDR_OFFSET_A_ID), 202U);
+	Report("dwt_sendtemplate indirect", 3, 13);
+}
+
+/* dwt_isr() preempting the driver while it holds a partly queued batch */
+static void isr_tx_done(void)
+{
+	spi_emul_write32(FINT_STAT_ID, FINT_STAT_TXOK_BIT_MASK);
+	spi_emul_write32(SYS_STATUS_ID, SYS_STATUS_TXFRS_BIT_MASK);
+	dwt_isr();
+}
+
+/* the ISR runs its own batch while the patch and TX command of
+ * dwt_sendtemplate() are queued, neither may be lost */
+TEST_F(TestSpiBench, IsrDuringSendTemplate)
+{
+	uint8_t frame[20] = { 0x41, 0x88, 0x00, 0xCA, 0xDE };
+	uint8_t seq = 0x5A;
+	uint8_t sent;
+	dwt_txtemplate_t tpl;
+	dwt_txpatch_t patch = { 2, 1, &seq };
+
+	Configure();
+	SetCallbacks();
+	ASSERT_EQ(dwt_writetxtemplate(&tpl, sizeof(frame), frame, 0, 0), DWT_SUCCESS);
+	spi_emul_clear_stats();
+
+	/* DWT_START_TX_DLY_RS reads DX_TIME after the patch is queued */
+	spi_emul_on_read(DX_TIME_ID, isr_tx_done);
+	ASSERT_EQ(dwt_sendtemplate(&tpl, &patch, 1, 0, DWT_START_TX_DLY_RS), DWT_SUCCESS);
+	EXPECT_EQ(cb_tx_done_cnt, 1);
+	EXPECT_EQ(spi_emul_last_cmd(), CMD_DTX_RS);
+	spi_emul_read(TX_BUFFER_ID, 2, &sent, 1);
+	EXPECT_EQ(sent, seq);
+}
+
+TEST_F(TestSpiBench, ReadDiagnostics)
+{
+	dwt_rxdiag_t diag;
+
+	Configure();
+	dwt_configciadiag(DW_CIA_DIAG_LOG_ALL);
+	spi_emul_clear_stats();
+
+	dwt_readdiagnostics(&diag);
+	Report("dwt_readdiagnostics", 2, 218);
+}
+
+TEST_F(TestSpiBench, ReadCir)
+{
+	static uint32_t cir[2 * DWT_CIR_LEN_MAX];
+
+	Configure();
+	spi_emul_clear_stats();
+
+	dwt_readcir(cir, DWT_ACC_IDX_IP_M, 0, DWT_CIR_LEN_MAX, DWT_CIR_READ_FULL);
+	Report("dwt_readcir", 194, 7004);
+}
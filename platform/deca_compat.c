@@ -17,13 +17,16 @@
 #include "deca_version.h"
 #include "deca_private.h"
 #include "deca_ull.h"
+#include "deca_conv.h"
 
 #if CONFIG_DW3000_CHIP_DW3720
 #include "dw3720/dw3720_deca_regs.h"
 #include "dw3720/dw3720_deca_vals.h"
+#define DWT_OTP_TEMP_C CONV_OTP_TEMP_C_DW3720
 #elif CONFIG_DW3000_CHIP_DW3000
 #include "dw3000/dw3000_deca_regs.h"
 #include "dw3000/dw3000_deca_vals.h"
+#define DWT_OTP_TEMP_C CONV_OTP_TEMP_C_DW3000
 #endif
 
 // Common to all Decawave chips ID address
@@ -50,6 +53,65 @@ static const uint8_t crcTable[256] = {
         0xAEU, 0xA9U, 0xA0U, 0xA7U, 0xB2U, 0xB5U, 0xBCU, 0xBBU, 0x96U, 0x91U, 0x98U, 0x9FU, 0x8AU, 0x8DU, 0x84U, 0x83U,
         0xDEU, 0xD9U, 0xD0U, 0xD7U, 0xC2U, 0xC5U, 0xCCU, 0xCBU, 0xE6U, 0xE1U, 0xE8U, 0xEFU, 0xFAU, 0xFDU, 0xF4U, 0xF3U
 };
+#ifdef DWT_CRC8_SLICE4
+// Slice-by-4 tables, crcTableSlice[n - 1][x] is the CRC-8 of byte x followed by n zero bytes.
+static const uint8_t crcTableSlice[3][256] = {
+        {
+            0x00U, 0x15U, 0x2AU, 0x3FU, 0x54U, 0x41U, 0x7EU, 0x6BU, 0xA8U, 0xBDU, 0x82U, 0x97U, 0xFCU, 0xE9U, 0xD6U, 0xC3U,
+            0x57U, 0x42U, 0x7DU, 0x68U, 0x03U, 0x16U, 0x29U, 0x3CU, 0xFFU, 0xEAU, 0xD5U, 0xC0U, 0xABU, 0xBEU, 0x81U, 0x94U,
+            0xAEU, 0xBBU, 0x84U, 0x91U, 0xFAU, 0xEFU, 0xD0U, 0xC5U, 0x06U, 0x13U, 0x2CU, 0x39U, 0x52U, 0x47U, 0x78U, 0x6DU,
+            0xF9U, 0xECU, 0xD3U, 0xC6U, 0xADU, 0xB8U, 0x87U, 0x92U, 0x51U, 0x44U, 0x7BU, 0x6EU, 0x05U, 0x10U, 0x2FU, 0x3AU,
+            0x5BU, 0x4EU, 0x71U, 0x64U, 0x0FU, 0x1AU, 0x25U, 0x30U, 0xF3U, 0xE6U, 0xD9U, 0xCCU, 0xA7U, 0xB2U, 0x8DU, 0x98U,
+            0x0CU, 0x19U, 0x26U, 0x33U, 0x58U, 0x4DU, 0x72U, 0x67U, 0xA4U, 0xB1U, 0x8EU, 0x9BU, 0xF0U, 0xE5U, 0xDAU, 0xCFU,
+            0xF5U, 0xE0U, 0xDFU, 0xCAU, 0xA1U, 0xB4U, 0x8BU, 0x9EU, 0x5DU, 0x48U, 0x77U, 0x62U, 0x09U, 0x1CU, 0x23U, 0x36U,
+            0xA2U, 0xB7U, 0x88U, 0x9DU, 0xF6U, 0xE3U, 0xDCU, 0xC9U, 0x0AU, 0x1FU, 0x20U, 0x35U, 0x5EU, 0x4BU, 0x74U, 0x61U,
+            0xB6U, 0xA3U, 0x9CU, 0x89U, 0xE2U, 0xF7U, 0xC8U, 0xDDU, 0x1EU, 0x0BU, 0x34U, 0x21U, 0x4AU, 0x5FU, 0x60U, 0x75U,
+            0xE1U, 0xF4U, 0xCBU, 0xDEU, 0xB5U, 0xA0U, 0x9FU, 0x8AU, 0x49U, 0x5CU, 0x63U, 0x76U, 0x1DU, 0x08U, 0x37U, 0x22U,
+            0x18U, 0x0DU, 0x32U, 0x27U, 0x4CU, 0x59U, 0x66U, 0x73U, 0xB0U, 0xA5U, 0x9AU, 0x8FU, 0xE4U, 0xF1U, 0xCEU, 0xDBU,
+            0x4FU, 0x5AU, 0x65U, 0x70U, 0x1BU, 0x0EU, 0x31U, 0x24U, 0xE7U, 0xF2U, 0xCDU, 0xD8U, 0xB3U, 0xA6U, 0x99U, 0x8CU,
+            0xEDU, 0xF8U, 0xC7U, 0xD2U, 0xB9U, 0xACU, 0x93U, 0x86U, 0x45U, 0x50U, 0x6FU, 0x7AU, 0x11U, 0x04U, 0x3BU, 0x2EU,
+            0xBAU, 0xAFU, 0x90U, 0x85U, 0xEEU, 0xFBU, 0xC4U, 0xD1U, 0x12U, 0x07U, 0x38U, 0x2DU, 0x46U, 0x53U, 0x6CU, 0x79U,
+            0x43U, 0x56U, 0x69U, 0x7CU, 0x17U, 0x02U, 0x3DU, 0x28U, 0xEBU, 0xFEU, 0xC1U, 0xD4U, 0xBFU, 0xAAU, 0x95U, 0x80U,
+            0x14U, 0x01U, 0x3EU, 0x2BU, 0x40U, 0x55U, 0x6AU, 0x7FU, 0xBCU, 0xA9U, 0x96U, 0x83U, 0xE8U, 0xFDU, 0xC2U, 0xD7U
+        },
+        {
+            0x00U, 0x6BU, 0xD6U, 0xBDU, 0xABU, 0xC0U, 0x7DU, 0x16U, 0x51U, 0x3AU, 0x87U, 0xECU, 0xFAU, 0x91U, 0x2CU, 0x47U,
+            0xA2U, 0xC9U, 0x74U, 0x1FU, 0x09U, 0x62U, 0xDFU, 0xB4U, 0xF3U, 0x98U, 0x25U, 0x4EU, 0x58U, 0x33U, 0x8EU, 0xE5U,
+            0x43U, 0x28U, 0x95U, 0xFEU, 0xE8U, 0x83U, 0x3EU, 0x55U, 0x12U, 0x79U, 0xC4U, 0xAFU, 0xB9U, 0xD2U, 0x6FU, 0x04U,
+            0xE1U, 0x8AU, 0x37U, 0x5CU, 0x4AU, 0x21U, 0x9CU, 0xF7U, 0xB0U, 0xDBU, 0x66U, 0x0DU, 0x1BU, 0x70U, 0xCDU, 0xA6U,
+            0x86U, 0xEDU, 0x50U, 0x3BU, 0x2DU, 0x46U, 0xFBU, 0x90U, 0xD7U, 0xBCU, 0x01U, 0x6AU, 0x7CU, 0x17U, 0xAAU, 0xC1U,
+            0x24U, 0x4FU, 0xF2U, 0x99U, 0x8FU, 0xE4U, 0x59U, 0x32U, 0x75U, 0x1EU, 0xA3U, 0xC8U, 0xDEU, 0xB5U, 0x08U, 0x63U,
+            0xC5U, 0xAEU, 0x13U, 0x78U, 0x6EU, 0x05U, 0xB8U, 0xD3U, 0x94U, 0xFFU, 0x42U, 0x29U, 0x3FU, 0x54U, 0xE9U, 0x82U,
+            0x67U, 0x0CU, 0xB1U, 0xDAU, 0xCCU, 0xA7U, 0x1AU, 0x71U, 0x36U, 0x5DU, 0xE0U, 0x8BU, 0x9DU, 0xF6U, 0x4BU, 0x20U,
+            0x0BU, 0x60U, 0xDDU, 0xB6U, 0xA0U, 0xCBU, 0x76U, 0x1DU, 0x5AU, 0x31U, 0x8CU, 0xE7U, 0xF1U, 0x9AU, 0x27U, 0x4CU,
+            0xA9U, 0xC2U, 0x7FU, 0x14U, 0x02U, 0x69U, 0xD4U, 0xBFU, 0xF8U, 0x93U, 0x2EU, 0x45U, 0x53U, 0x38U, 0x85U, 0xEEU,
+            0x48U, 0x23U, 0x9EU, 0xF5U, 0xE3U, 0x88U, 0x35U, 0x5EU, 0x19U, 0x72U, 0xCFU, 0xA4U, 0xB2U, 0xD9U, 0x64U, 0x0FU,
+            0xEAU, 0x81U, 0x3CU, 0x57U, 0x41U, 0x2AU, 0x97U, 0xFCU, 0xBBU, 0xD0U, 0x6DU, 0x06U, 0x10U, 0x7BU, 0xC6U, 0xADU,
+            0x8DU, 0xE6U, 0x5BU, 0x30U, 0x26U, 0x4DU, 0xF0U, 0x9BU, 0xDCU, 0xB7U, 0x0AU, 0x61U, 0x77U, 0x1CU, 0xA1U, 0xCAU,
+            0x2FU, 0x44U, 0xF9U, 0x92U, 0x84U, 0xEFU, 0x52U, 0x39U, 0x7EU, 0x15U, 0xA8U, 0xC3U, 0xD5U, 0xBEU, 0x03U, 0x68U,
+            0xCEU, 0xA5U, 0x18U, 0x73U, 0x65U, 0x0EU, 0xB3U, 0xD8U, 0x9FU, 0xF4U, 0x49U, 0x22U, 0x34U, 0x5FU, 0xE2U, 0x89U,
+            0x6CU, 0x07U, 0xBAU, 0xD1U, 0xC7U, 0xACU, 0x11U, 0x7AU, 0x3DU, 0x56U, 0xEBU, 0x80U, 0x96U, 0xFDU, 0x40U, 0x2BU
+        },
+        {
+            0x00U, 0x16U, 0x2CU, 0x3AU, 0x58U, 0x4EU, 0x74U, 0x62U, 0xB0U, 0xA6U, 0x9CU, 0x8AU, 0xE8U, 0xFEU, 0xC4U, 0xD2U,
+            0x67U, 0x71U, 0x4BU, 0x5DU, 0x3FU, 0x29U, 0x13U, 0x05U, 0xD7U, 0xC1U, 0xFBU, 0xEDU, 0x8FU, 0x99U, 0xA3U, 0xB5U,
+            0xCEU, 0xD8U, 0xE2U, 0xF4U, 0x96U, 0x80U, 0xBAU, 0xACU, 0x7EU, 0x68U, 0x52U, 0x44U, 0x26U, 0x30U, 0x0AU, 0x1CU,
+            0xA9U, 0xBFU, 0x85U, 0x93U, 0xF1U, 0xE7U, 0xDDU, 0xCBU, 0x19U, 0x0FU, 0x35U, 0x23U, 0x41U, 0x57U, 0x6DU, 0x7BU,
+            0x9BU, 0x8DU, 0xB7U, 0xA1U, 0xC3U, 0xD5U, 0xEFU, 0xF9U, 0x2BU, 0x3DU, 0x07U, 0x11U, 0x73U, 0x65U, 0x5FU, 0x49U,
+            0xFCU, 0xEAU, 0xD0U, 0xC6U, 0xA4U, 0xB2U, 0x88U, 0x9EU, 0x4CU, 0x5AU, 0x60U, 0x76U, 0x14U, 0x02U, 0x38U, 0x2EU,
+            0x55U, 0x43U, 0x79U, 0x6FU, 0x0DU, 0x1BU, 0x21U, 0x37U, 0xE5U, 0xF3U, 0xC9U, 0xDFU, 0xBDU, 0xABU, 0x91U, 0x87U,
+            0x32U, 0x24U, 0x1EU, 0x08U, 0x6AU, 0x7CU, 0x46U, 0x50U, 0x82U, 0x94U, 0xAEU, 0xB8U, 0xDAU, 0xCCU, 0xF6U, 0xE0U,
+            0x31U, 0x27U, 0x1DU, 0x0BU, 0x69U, 0x7FU, 0x45U, 0x53U, 0x81U, 0x97U, 0xADU, 0xBBU, 0xD9U, 0xCFU, 0xF5U, 0xE3U,
+            0x56U, 0x40U, 0x7AU, 0x6CU, 0x0EU, 0x18U, 0x22U, 0x34U, 0xE6U, 0xF0U, 0xCAU, 0xDCU, 0xBEU, 0xA8U, 0x92U, 0x84U,
+            0xFFU, 0xE9U, 0xD3U, 0xC5U, 0xA7U, 0xB1U, 0x8BU, 0x9DU, 0x4FU, 0x59U, 0x63U, 0x75U, 0x17U, 0x01U, 0x3BU, 0x2DU,
+            0x98U, 0x8EU, 0xB4U, 0xA2U, 0xC0U, 0xD6U, 0xECU, 0xFAU, 0x28U, 0x3EU, 0x04U, 0x12U, 0x70U, 0x66U, 0x5CU, 0x4AU,
+            0xAAU, 0xBCU, 0x86U, 0x90U, 0xF2U, 0xE4U, 0xDEU, 0xC8U, 0x1AU, 0x0CU, 0x36U, 0x20U, 0x42U, 0x54U, 0x6EU, 0x78U,
+            0xCDU, 0xDBU, 0xE1U, 0xF7U, 0x95U, 0x83U, 0xB9U, 0xAFU, 0x7DU, 0x6BU, 0x51U, 0x47U, 0x25U, 0x33U, 0x09U, 0x1FU,
+            0x64U, 0x72U, 0x48U, 0x5EU, 0x3CU, 0x2AU, 0x10U, 0x06U, 0xD4U, 0xC2U, 0xF8U, 0xEEU, 0x8CU, 0x9AU, 0xA0U, 0xB6U,
+            0x03U, 0x15U, 0x2FU, 0x39U, 0x5BU, 0x4DU, 0x77U, 0x61U, 0xB3U, 0xA5U, 0x9FU, 0x89U, 0xEBU, 0xFDU, 0xC7U, 0xD1U
+        }
+};
+#endif // DWT_CRC8_SLICE4
 // clang-format on
 #endif // DWT_ENABLE_CRC
 
@@ -93,6 +155,7 @@ int32_t dwt_probe(struct dwt_probe_s *probe_interf)
         }
         dw->SPI = (struct dwt_spi_s*)probe_interf->spi;
         dw->wakeup_device_with_io = probe_interf->wakeup_device_with_io;
+        dw->wait_device_ready = probe_interf->wait_device_ready;
 
         dw->wakeup_device_with_io();
 
@@ -311,6 +374,28 @@ int8_t dwt_getpllcalibrationtemperature(void)
     return -1;
 }
 
+/*! ------------------------------------------------------------------------------------------------------------------
+ * @brief This function sets a cache of PLL calibration results, see ull_setpllcalcache()
+ *
+ * input parameters
+ * @param cache - pointer to the cache, NULL to not use a cache
+ *
+ * output parameters none
+ *
+ * returns DWT_SUCCESS, or DWT_ERROR on DW3000
+ *
+ * DW3720 ONLY
+ */
+int32_t dwt_setpllcalcache(dwt_pll_cal_cache_t *cache)
+{
+#if CONFIG_DW3000_CHIP_DW3720
+    return ull_setpllcalcache(dw, cache);
+#else
+    (void)cache;
+    return (int32_t)DWT_ERROR;
+#endif
+}
+
 /*! ------------------------------------------------------------------------------------------------------------------
  * @brief This function enables/disables the fine grain TX sequencing (enabled by default).
  *
@@ -430,6 +515,38 @@ int32_t dwt_initialise(int32_t mode)
     return dw->dwt_driver->dwt_ops->initialize(dw, mode);
 }
 
+/*! ------------------------------------------------------------------------------------------------------------------
+ * @brief This function saves the values dwt_initialise() reads from OTP memory, together with the configuration state
+ * of the driver and the trim and calibration values applied to the device, into a warm context.
+ *
+ * input parameters
+ *
+ * output parameters
+ * @param ctx - pointer to the warm context to fill in
+ *
+ * returns DWT_SUCCESS for success, or DWT_ERROR for error
+ */
+int32_t dwt_savewarmcontext(dwt_warm_context_t *ctx)
+{
+    return ull_savewarmcontext(dw, ctx);
+}
+
+/*! ------------------------------------------------------------------------------------------------------------------
+ * @brief This function initialises the DW3xxx transceiver from a warm context saved by dwt_savewarmcontext(),
+ * without any OTP memory reads.
+ *
+ * input parameters
+ * @param ctx - pointer to the warm context
+ *
+ * output parameters
+ *
+ * returns DWT_SUCCESS for success, or DWT_ERROR if the context is not valid
+ */
+int32_t dwt_initialise_warm(const dwt_warm_context_t *ctx)
+{
+    return ull_initialise_warm(dw, ctx);
+}
+
 /*! ------------------------------------------------------------------------------------------------------------------
  * @brief This function can place DW3000 into IDLE/IDLE_PLL or IDLE_RC mode when it is not actively in TX or RX.
  *
@@ -687,6 +804,26 @@ int32_t dwt_writetxdata(uint16_t txDataLength, uint8_t *txDataBytes, uint16_t tx
     return dw->dwt_driver->dwt_ops->write_tx_data(dw, txDataLength, txDataBytes, txBufferOffset);
 }
 
+/*! ------------------------------------------------------------------------------------------------------------------
+ * @brief This API function starts writing the supplied TX data into the DW IC's TX buffer without waiting for the
+ * SPI transfer to finish. The data must stay valid until the callback has been called.
+ *
+ * input parameters
+ * @param txDataLength   - This is the total length of data (in bytes) to write to the tx buffer.
+ * @param txDataBytes    - Pointer to the user's buffer containing the data to send.
+ * @param txBufferOffset - This specifies an offset in the DW IC's TX Buffer at which to start writing data.
+ * @param cb             - function called when the transfer has completed (can be NULL)
+ * @param user_data      - pointer passed to the callback
+ *
+ * output parameters
+ *
+ * returns DWT_SUCCESS if the transfer was started, or DWT_ERROR for error
+ */
+int32_t dwt_writetxdata_async(uint16_t txDataLength, uint8_t *txDataBytes, uint16_t txBufferOffset, dwt_spi_done_cb_t cb, void *user_data)
+{
+    return ull_writetxdata_async(dw, txDataLength, txDataBytes, txBufferOffset, cb, user_data);
+}
+
 /*! ------------------------------------------------------------------------------------------------------------------
  * @brief This API function configures the TX frame control register before the transmission of a frame
  *
@@ -707,6 +844,45 @@ void dwt_writetxfctrl(uint16_t txFrameLength, uint16_t txBufferOffset, uint8_t r
     dw->dwt_driver->dwt_ops->write_tx_fctrl(dw, txFrameLength, txBufferOffset, ranging);
 }
 
+/*! ------------------------------------------------------------------------------------------------------------------
+ * @brief This API function writes a TX frame template into the TX buffer and configures the TX frame control register
+ *        for it, see dwt_sendtemplate().
+ *
+ * input parameters
+ * @param txFrameLength  - length of the frame including the 2 byte CRC
+ * @param txFrameBytes   - the frame, the 2 CRC bytes at its end are not written
+ * @param txBufferOffset - offset of the frame in the TX buffer
+ * @param ranging        - 1 if this is a ranging frame, else 0
+ *
+ * output parameters
+ * @param tpl            - template descriptor to fill in
+ *
+ * returns DWT_SUCCESS for success, or DWT_ERROR for error
+ */
+int32_t dwt_writetxtemplate(dwt_txtemplate_t *tpl, uint16_t txFrameLength, uint8_t *txFrameBytes, uint16_t txBufferOffset, uint8_t ranging)
+{
+    return ull_writetxtemplate(dw, tpl, txFrameLength, txFrameBytes, txBufferOffset, ranging);
+}
+
+/*! ------------------------------------------------------------------------------------------------------------------
+ * @brief This API function patches a TX frame template and initiates its transmission in one batch of SPI transactions
+ *
+ * input parameters
+ * @param tpl            - the template descriptor
+ * @param patches        - array of byte ranges of the frame to overwrite
+ * @param numPatches     - number of entries in patches
+ * @param txFrameLength  - length of the frame including the 2 byte CRC, or 0 for the length of the template
+ * @param mode           - TX mode, see dwt_starttx()
+ *
+ * output parameters
+ *
+ * returns DWT_SUCCESS for success, or DWT_ERROR for error
+ */
+int32_t dwt_sendtemplate(const dwt_txtemplate_t *tpl, const dwt_txpatch_t *patches, uint8_t numPatches, uint16_t txFrameLength, uint8_t mode)
+{
+    return ull_sendtemplate(dw, tpl, patches, numPatches, txFrameLength, mode);
+}
+
 /*! ------------------------------------------------------------------------------------------------------------------
  * @brief This API function is used to configure frame preamble length, the frame premable length can be
  * configured in steps of 8, from 16 to 2048 symbols. If a non-zero value is configured, then the TXPSR_PE setting is ignored.
@@ -1556,6 +1732,17 @@ uint8_t dwt_generatecrc8(const uint8_t *byteArray, uint32_t flen, uint8_t crcIni
 #ifdef DWT_ENABLE_CRC
     uint8_t data;
 
+#ifdef DWT_CRC8_SLICE4
+    /* Divide the message by the polynomial four bytes at a time, the CRC is linear so the contribution of each byte
+     * can be looked up separately. */
+    for (; flen >= 4UL; flen -= 4UL)
+    {
+        crcInit = crcTableSlice[2][byteArray[0] ^ crcInit] ^ crcTableSlice[1][byteArray[1]] ^
+                  crcTableSlice[0][byteArray[2]] ^ crcTable[byteArray[3]];
+        byteArray += 4;
+    }
+#endif
+
     /* Divide the message by the polynomial, a byte at a time. */
     for (uint32_t byte = 0UL; byte < flen; ++byte)
     {
@@ -1655,6 +1842,26 @@ void dwt_readrxdata(uint8_t *buffer, uint16_t length, uint16_t rxBufferOffset)
     dw->dwt_driver->dwt_ops->read_rx_data(dw, buffer, length, rxBufferOffset);
 }
 
+/*! ------------------------------------------------------------------------------------------------------------------
+ * @brief This is used to start reading the data from the RX buffer without waiting for the SPI transfer to finish.
+ * The buffer must stay valid until the callback has been called.
+ *
+ * input parameters
+ * @param buffer - the buffer into which the data will be read
+ * @param length - the length of data to read (in bytes)
+ * @param rxBufferOffset - the offset in the rx buffer from which to read the data
+ * @param cb - function called when the transfer has completed (can be NULL)
+ * @param user_data - pointer passed to the callback
+ *
+ * output parameters
+ *
+ * returns DWT_SUCCESS if the transfer was started, or DWT_ERROR for error
+ */
+int32_t dwt_readrxdata_async(uint8_t *buffer, uint16_t length, uint16_t rxBufferOffset, dwt_spi_done_cb_t cb, void *user_data)
+{
+    return ull_readrxdata_async(dw, buffer, length, rxBufferOffset, cb, user_data);
+}
+
 /*! ------------------------------------------------------------------------------------------------------------------
  * @brief This is used to write the data from the RX scratch buffer, from an offset location given by offset parameter.
  *
@@ -1745,6 +1952,7 @@ void dwt_readaccdata(uint8_t *buffer, uint16_t len, uint16_t accOffset)
  *
  * @return None
  */
+#ifdef DWT_ENABLE_CIR
 void dwt_readcir(uint32_t *buffer, dwt_acc_idx_e cir_idx, uint16_t sample_offs,
                     uint16_t num_samples, dwt_cir_read_mode_e mode)
 {
@@ -1755,6 +1963,30 @@ void dwt_readcir_48b(uint8_t *buffer, dwt_acc_idx_e acc_idx, uint16_t sample_off
     // In the QM33 devices the DWT_CIR_READ_FULL is already 48-bit. This function is added only for compatibility with QM35 devices
     dw->dwt_driver->dwt_ops->read_cir( dw , (uint32_t*)(void*)buffer, acc_idx, sample_offs , num_samples , DWT_CIR_READ_FULL );
 }
+#endif // DWT_ENABLE_CIR
+
+/*!
+ * This function streams a window of the CIR/accumulator data to a sink, chunk by chunk, reading the next chunk while
+ * the current one is packed and passed to the sink.
+ *
+ * @param[in] acc_idx      Index of the accumulator to read data from
+ * @param[in] sample_offs  The sample index offset within the selected accumulator to start reading from
+ * @param[in] num_samples  The number of complex samples to stream
+ * @param[in] pack         Packing of the samples passed to the sink, see dwt_cir_pack_e
+ * @param[in] sink         Function called with every packed chunk
+ * @param[in] user_data    Pointer passed to sink
+ *
+ * @return DWT_SUCCESS, or DWT_ERROR for invalid parameters or if an asynchronous SPI transfer is pending
+ */
+int32_t dwt_readcir_stream(dwt_acc_idx_e acc_idx, uint16_t sample_offs, uint16_t num_samples, dwt_cir_pack_e pack,
+    dwt_cir_sink_cb_t sink, void *user_data)
+{
+#ifdef DWT_ENABLE_CIR
+    return ull_readcir_stream(dw, acc_idx, sample_offs, num_samples, pack, sink, user_data);
+#else
+    return (int32_t)DWT_ERROR;
+#endif
+}
 
 /*! ------------------------------------------------------------------------------------------------------------------
  * @brief This is used to read the crystal offset (relating to the frequency offset of the far DW3000 device compared to this one)
@@ -1851,6 +2083,21 @@ void dwt_readdiagnostics(dwt_rxdiag_t *diagnostics)
     ull_readdiagnostics(dw, diagnostics);
 }
 
+/*! ------------------------------------------------------------------------------------------------------------------
+ * @brief this function reads the per-frame RX report (RX timestamps, clock offset, STS quality, PDOA and first path
+ *        power inputs) in one SPI batch
+ *
+ * input parameters
+ * @param report - RX report structure pointer, this will contain the data read from the DW3000
+ *
+ * output parameters
+ * return value - >=0 for good and < 0 if bad STS quality.
+ */
+int32_t dwt_readrxreport(dwt_rxreport_t *report)
+{
+    return ull_readrxreport(dw, report);
+}
+
 /*! ------------------------------------------------------------------------------------------------------------------
  * @brief This is used to enable/disable the event counter in the IC
  *
@@ -1910,7 +2157,11 @@ void dwt_otpread(uint16_t address, uint32_t* array, uint8_t length)
  */
 int32_t dwt_otpwriteandverify(uint32_t value, uint16_t address)
 {
+#ifdef DWT_ENABLE_OTP_WRITE
     return ull_otpwriteandverify(dw, value, address);
+#else
+    return (int32_t)DWT_ERROR;
+#endif
 }
 
 /*! ------------------------------------------------------------------------------------------------------------------
@@ -1926,7 +2177,11 @@ int32_t dwt_otpwriteandverify(uint32_t value, uint16_t address)
  */
 int32_t dwt_otpwrite(uint32_t value, uint16_t address)
 {
+#ifdef DWT_ENABLE_OTP_WRITE
     return ull_otpwrite(dw, value, address);
+#else
+    return (int32_t)DWT_ERROR;
+#endif
 }
 
 /*! ------------------------------------------------------------------------------------------------------------------
@@ -2156,6 +2411,36 @@ float dwt_convertrawvoltage(uint8_t raw_voltage)
     return ull_convertrawvoltage(dw, raw_voltage);
 }
 
+/*! ------------------------------------------------------------------------------------------------------------------
+ * @brief fixed point version of dwt_convertrawtemperature(), without float math
+ *
+ * input parameters:
+ * @param raw_temp - this is the 8-bit raw temperature value as read by dwt_readtempvbat
+ *
+ * output parameters:
+ *
+ * returns: temperature in degree C, Q24.8
+ */
+int32_t dwt_convertrawtemperature_q8(uint8_t raw_temp)
+{
+    return conv_temperature_q8(raw_temp, ull_geticreftemp(dw), DWT_OTP_TEMP_C);
+}
+
+/*! ------------------------------------------------------------------------------------------------------------------
+ * @brief fixed point version of dwt_convertrawvoltage(), without float math
+ *
+ * input parameters:
+ * @param raw_voltage - this is the 8-bit raw voltage value as read by dwt_readtempvbat
+ *
+ * output parameters:
+ *
+ * returns: voltage in V, Q16.16
+ */
+int32_t dwt_convertrawvoltage_q16(uint8_t raw_voltage)
+{
+    return conv_voltage_q16(raw_voltage, ull_geticrefvolt(dw));
+}
+
 /*! ------------------------------------------------------------------------------------------------------------------
  * @brief this function reads the temperature of the DW3000 that was sampled
  * on waking from Sleep/Deepsleep. They are not current values, but read on last
@@ -2254,6 +2539,7 @@ uint16_t dwt_calcpgcount(uint8_t pgdly)
  *
  * no return value
  */
+#ifdef DWT_ENABLE_AES
 void dwt_set_keyreg_128(dwt_aes_key_t *key)
 {
     ull_set_keyreg_128(dw, key);
@@ -2273,6 +2559,7 @@ void dwt_configure_aes(dwt_aes_config_t *pCfg)
 {
     ull_configure_aes(dw, pCfg);
 }
+#endif // DWT_ENABLE_AES
 
 /*! ------------------------------------------------------------------------------------------------------------------
  * @brief   This gets mic size in bytes and convert it to value to write in AES_CFG
@@ -2303,7 +2590,44 @@ dwt_mic_size_e dwt_mic_size_from_bytes(uint8_t mic_size_in_bytes)
  */
 int8_t dwt_do_aes(dwt_aes_job_t *job, dwt_aes_core_type_e core_type)
 {
+#ifdef DWT_ENABLE_AES
     return ull_do_aes(dw, job, core_type);
+#else
+    return ERROR_WRONG_MODE;
+#endif
+}
+
+/*! ------------------------------------------------------------------------------------------------------------------
+ * @brief   This function starts an AES job without waiting for its completion, which is reported by cb
+ *
+ * @param job - pointer to AES job, contains data info and encryption info.
+ * @param core_type - Core type
+ * @param cb - completion callback (can be NULL)
+ * @param user_data - pointer passed to cb
+ *
+ * @return  0 when the job was started, or a negative error code
+ */
+int8_t dwt_do_aes_async(dwt_aes_job_t *job, dwt_aes_core_type_e core_type, dwt_aes_done_cb_t cb, void *user_data)
+{
+#ifdef DWT_ENABLE_AES
+    return ull_do_aes_async(dw, job, core_type, cb, user_data);
+#else
+    return ERROR_WRONG_MODE;
+#endif
+}
+
+/*! ------------------------------------------------------------------------------------------------------------------
+ * @brief   This function checks if the job started by dwt_do_aes_async() has completed
+ *
+ * @return  0 while the job is running, the AES_STS_ID status bits when it has completed, or ERROR_AES_IDLE
+ */
+int8_t dwt_aes_poll(void)
+{
+#ifdef DWT_ENABLE_AES
+    return ull_aes_poll(dw);
+#else
+    return ERROR_AES_IDLE;
+#endif
 }
 
 /****************************************************************************************************************************************************
@@ -2,22 +2,70 @@
 
 #include "deca_interface.h"
 
+#include "deca_probe_interface.h"
 #include "dw3000_hw.h"
 #include "dw3000_spi.h"
 
 /* This file implements the functions required by decadriver */
 
+#define DT_DRV_COMPAT decawave_dw3000
+
+/* driver structure of each instance */
+static struct dwchip_s dw3000_chips[DW3000_NUM_INST];
+
+/* held by the thread using an instance, see dw3000_lock_ex() */
+#define DW3000_PORT_MUTEX(n) static K_MUTEX_DEFINE(dw3000_mutex_##n);
+#define DW3000_PORT_MUTEX_PTR(n) &dw3000_mutex_##n,
+DT_INST_FOREACH_STATUS_OKAY(DW3000_PORT_MUTEX)
+static struct k_mutex* const dw3000_mutexes[] = {
+	DT_INST_FOREACH_STATUS_OKAY(DW3000_PORT_MUTEX_PTR)};
+
+/* held while an instance is selected for the dwt_*() functions, see
+ * dw3000_lock() */
+static K_MUTEX_DEFINE(dw3000_select_mutex);
+static uint32_t dw3000_lock_depth[DW3000_NUM_INST];
+/* instance selected before the outermost dw3000_lock() */
+static uint8_t dw3000_lock_prev[DW3000_NUM_INST];
+
+#if CONFIG_DW3000_MUTEX_LOCK
+/*
+ * dwt_isr() runs in a thread with the mutex of its instance held, so taking
+ * the same (recursive) mutex keeps it out of the critical section without
+ * touching the GPIO interrupt configuration. Returns the instance, whose
+ * mutex decamutexoff() releases
+ */
+decaIrqStatus_t decamutexon(void)
+{
+	uint8_t inst = dw3000_hw_selected();
+
+	k_mutex_lock(dw3000_mutexes[inst], K_FOREVER);
+	return inst;
+}
+
+void decamutexoff(decaIrqStatus_t s)
+{
+	k_mutex_unlock(dw3000_mutexes[s]);
+}
+#else
+/* returns the previous IRQ state, so nested calls only re-enable it at the
+ * outermost decamutexoff() */
 decaIrqStatus_t decamutexon(void)
 {
-	dw3000_hw_interrupt_disable();
-	return 1;
+	decaIrqStatus_t s = dw3000_hw_interrupt_is_enabled() ? 1 : 0;
+
+	if (s) {
+		dw3000_hw_interrupt_disable();
+	}
+	return s;
 }
 
 void decamutexoff(decaIrqStatus_t s)
 {
-	// TODO?: s is not used
-	dw3000_hw_interrupt_enable();
+	if (s) {
+		dw3000_hw_interrupt_enable();
+	}
 }
+#endif
 
 void deca_sleep(unsigned int time_ms)
 {
@@ -29,13 +77,117 @@ void deca_usleep(unsigned long time_us)
 	k_usleep(time_us);
 }
 
-static const struct dwt_spi_s dw3000_spi_fct = {
-	.readfromspi = dw3000_spi_read,
-	.writetospi = dw3000_spi_write,
-	.writetospiwithcrc = dw3000_spi_write_crc,
-	.setslowrate = dw3000_spi_speed_slow,
-	.setfastrate = dw3000_spi_speed_fast,
-};
+#if CONFIG_DW3000_SPI_ASYNC
+#define DW3000_PORT_SPI_ASYNC(n)                                               \
+	static int32_t dw3000_spi_read_async_##n(                                  \
+		uint16_t headerLength, uint8_t* headerBuffer, uint16_t readLength,     \
+		uint8_t* readBuffer, dwt_spi_done_cb_t cb, void* user_data)            \
+	{                                                                          \
+		return dw3000_spi_read_async_ex(n, headerLength, headerBuffer,         \
+										readLength, readBuffer, cb,            \
+										user_data);                            \
+	}                                                                          \
+	static int32_t dw3000_spi_write_async_##n(                                 \
+		uint16_t headerLength, const uint8_t* headerBuffer,                    \
+		uint16_t bodyLength, const uint8_t* bodyBuffer, dwt_spi_done_cb_t cb,  \
+		void* user_data)                                                       \
+	{                                                                          \
+		return dw3000_spi_write_async_ex(n, headerLength, headerBuffer,        \
+										 bodyLength, bodyBuffer, cb,           \
+										 user_data);                           \
+	}                                                                          \
+	static int32_t dw3000_spi_wait_async_##n(void)                             \
+	{                                                                          \
+		return dw3000_spi_wait_async_ex(n);                                    \
+	}
+#define DW3000_PORT_SPI_ASYNC_FCT(n)                                           \
+	.readfromspi_async = dw3000_spi_read_async_##n,                            \
+	.writetospi_async = dw3000_spi_write_async_##n,                            \
+	.waitasync = dw3000_spi_wait_async_##n,
+#else
+#define DW3000_PORT_SPI_ASYNC(n)
+#define DW3000_PORT_SPI_ASYNC_FCT(n)
+#endif
+
+/* SPI functions bound to instance n, so the driver structure of an instance
+ * always accesses its own device, independent of the selected one */
+#define DW3000_PORT_SPI(n)                                                     \
+	static int32_t dw3000_spi_read_##n(uint16_t headerLength,                  \
+									   uint8_t* headerBuffer,                  \
+									   uint16_t readLength,                    \
+									   uint8_t* readBuffer)                    \
+	{                                                                          \
+		return dw3000_spi_read_ex(n, headerLength, headerBuffer, readLength,   \
+								  readBuffer);                                 \
+	}                                                                          \
+	static int32_t dw3000_spi_write_##n(uint16_t headerLength,                 \
+										const uint8_t* headerBuffer,           \
+										uint16_t bodyLength,                   \
+										const uint8_t* bodyBuffer)             \
+	{                                                                          \
+		return dw3000_spi_write_ex(n, headerLength, headerBuffer, bodyLength,  \
+								   bodyBuffer);                                \
+	}                                                                          \
+	static int32_t dw3000_spi_write_crc_##n(                                   \
+		uint16_t headerLength, const uint8_t* headerBuffer,                    \
+		uint16_t bodyLength, const uint8_t* bodyBuffer, uint8_t crc8)          \
+	{                                                                          \
+		return dw3000_spi_write_crc_ex(n, headerLength, headerBuffer,          \
+									   bodyLength, bodyBuffer, crc8);          \
+	}                                                                          \
+	static void dw3000_spi_speed_slow_##n(void)                                \
+	{                                                                          \
+		dw3000_spi_speed_slow_ex(n);                                           \
+	}                                                                          \
+	static void dw3000_spi_speed_fast_##n(void)                                \
+	{                                                                          \
+		dw3000_spi_speed_fast_ex(n);                                           \
+	}                                                                          \
+	static int32_t dw3000_spi_xfer_batch_##n(                                  \
+		const struct dwt_spi_xfer_s* xfers, uint16_t count)                    \
+	{                                                                          \
+		return dw3000_spi_xfer_batch_ex(n, xfers, count);                      \
+	}                                                                          \
+	static void dw3000_spi_bus_lock_##n(void)                                  \
+	{                                                                          \
+		dw3000_spi_bus_lock_ex(n);                                             \
+	}                                                                          \
+	static void dw3000_spi_bus_unlock_##n(void)                                \
+	{                                                                          \
+		dw3000_spi_bus_unlock_ex(n);                                           \
+	}                                                                          \
+	static void dw3000_hw_wakeup_##n(void)                                     \
+	{                                                                          \
+		dw3000_hw_wakeup_ex(n);                                                \
+	}                                                                          \
+	static int32_t dw3000_hw_wait_ready_##n(uint32_t timeout_us)               \
+	{                                                                          \
+		return dw3000_hw_wait_ready_ex(n, timeout_us);                         \
+	}                                                                          \
+	DW3000_PORT_SPI_ASYNC(n)                                                   \
+	static const struct dwt_spi_s dw3000_spi_fct_##n = {                       \
+		.readfromspi = dw3000_spi_read_##n,                                    \
+		.writetospi = dw3000_spi_write_##n,                                    \
+		.writetospiwithcrc = dw3000_spi_write_crc_##n,                         \
+		.setslowrate = dw3000_spi_speed_slow_##n,                              \
+		.setfastrate = dw3000_spi_speed_fast_##n,                              \
+		.xferbatch = dw3000_spi_xfer_batch_##n,                                \
+		.lockbus = dw3000_spi_bus_lock_##n,                                    \
+		.unlockbus = dw3000_spi_bus_unlock_##n,                                \
+		DW3000_PORT_SPI_ASYNC_FCT(n)};
+
+DT_INST_FOREACH_STATUS_OKAY(DW3000_PORT_SPI)
+
+#define DW3000_PORT_SPI_FCT(n) &dw3000_spi_fct_##n,
+#define DW3000_PORT_WAKEUP(n) dw3000_hw_wakeup_##n,
+#define DW3000_PORT_WAIT_READY(n) dw3000_hw_wait_ready_##n,
+
+static const struct dwt_spi_s* const dw3000_spi_fcts[] = {
+	DT_INST_FOREACH_STATUS_OKAY(DW3000_PORT_SPI_FCT)};
+static void (*const dw3000_wakeups[])(void) = {
+	DT_INST_FOREACH_STATUS_OKAY(DW3000_PORT_WAKEUP)};
+static int32_t (*const dw3000_wait_readys[])(uint32_t) = {
+	DT_INST_FOREACH_STATUS_OKAY(DW3000_PORT_WAIT_READY)};
 
 #if CONFIG_DW3000_CHIP_DW3000
 extern const struct dwt_driver_s dw3000_driver;
@@ -52,9 +204,81 @@ const struct dwt_driver_s* tmp_ptr[] = {
 };
 
 const struct dwt_probe_s dw3000_probe_interf = {
-	.dw = NULL,
-	.spi = (void*)&dw3000_spi_fct,
-	.wakeup_device_with_io = dw3000_hw_wakeup,
+	.dw = &dw3000_chips[0],
+	.spi = (void*)&dw3000_spi_fct_0,
+	.wakeup_device_with_io = dw3000_hw_wakeup_0,
 	.driver_list = (struct dwt_driver_s**)tmp_ptr,
 	.dw_driver_num = 1,
+	.wait_device_ready = dw3000_hw_wait_ready_0,
 };
+
+/** select the instance used by the platform and the dwt_*() functions */
+void dw3000_select(uint8_t inst)
+{
+	dw3000_hw_select(inst);
+	dwt_update_dw(&dw3000_chips[inst]);
+}
+
+/**
+ * lock the instance for the calling thread and select it for the dwt_*()
+ * functions. Other instances can not be selected meanwhile, so this
+ * serializes all users of the selection. Can be nested, the outermost
+ * dw3000_unlock() of inst selects the instance selected before the outermost
+ * dw3000_lock() of inst again, the others keep inst selected.
+ */
+void dw3000_lock(uint8_t inst)
+{
+	k_mutex_lock(&dw3000_select_mutex, K_FOREVER);
+	k_mutex_lock(dw3000_mutexes[inst], K_FOREVER);
+	if (dw3000_lock_depth[inst]++ == 0) {
+		dw3000_lock_prev[inst] = dw3000_hw_selected();
+	}
+	dw3000_select(inst);
+}
+
+/** unlock the instance locked with dw3000_lock() */
+void dw3000_unlock(uint8_t inst)
+{
+	if (--dw3000_lock_depth[inst] == 0) {
+		dw3000_select(dw3000_lock_prev[inst]);
+	} else {
+		dw3000_select(inst);
+	}
+	k_mutex_unlock(dw3000_mutexes[inst]);
+	k_mutex_unlock(&dw3000_select_mutex);
+}
+
+/**
+ * lock the instance for the calling thread without changing the selection
+ * and return its driver structure, which has to be used with the functions
+ * of its dwt_ops instead of the dwt_*() functions. Other instances can be
+ * used meanwhile. dw3000_lock() must not be called while holding it.
+ */
+struct dwchip_s* dw3000_lock_ex(uint8_t inst)
+{
+	k_mutex_lock(dw3000_mutexes[inst], K_FOREVER);
+	return &dw3000_chips[inst];
+}
+
+/** unlock the instance locked with dw3000_lock_ex() */
+void dw3000_unlock_ex(uint8_t inst)
+{
+	k_mutex_unlock(dw3000_mutexes[inst]);
+}
+
+/** probe the instance with its own driver structure and select it */
+int32_t dw3000_probe_ex(uint8_t inst)
+{
+	struct dwt_probe_s probe = dw3000_probe_interf;
+
+	if (inst >= DW3000_NUM_INST) {
+		return DWT_ERROR;
+	}
+
+	probe.dw = &dw3000_chips[inst];
+	probe.spi = (void*)dw3000_spi_fcts[inst];
+	probe.wakeup_device_with_io = dw3000_wakeups[inst];
+	probe.wait_device_ready = dw3000_wait_readys[inst];
+	dw3000_select(inst);
+	return dwt_probe(&probe);
+}
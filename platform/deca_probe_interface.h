@@ -17,4 +17,15 @@
 
 extern const struct dwt_probe_s dw3000_probe_interf;
 
+/* Multiple instances: select one for the following dwt_*() calls */
+int32_t dw3000_probe_ex(uint8_t inst);
+void dw3000_select(uint8_t inst);
+void dw3000_lock(uint8_t inst);
+void dw3000_unlock(uint8_t inst);
+
+/* Multiple instances: use one through its driver structure, without
+ * selecting it */
+struct dwchip_s* dw3000_lock_ex(uint8_t inst);
+void dw3000_unlock_ex(uint8_t inst);
+
 #endif
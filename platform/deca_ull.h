@@ -9,6 +9,7 @@ void dwt_write32bitoffsetreg(dwchip_t *dw, uint32_t regFileID, uint16_t regOffse
 uint8_t ull_otprevision(dwchip_t *dw);
 void ull_setpllcaltemperature(dwchip_t *dw, int8_t temperature); // DW3720 only
 int8_t ull_getpllcaltemperature(dwchip_t *dw);// DW3720 only
+int32_t ull_setpllcalcache(dwchip_t *dw, dwt_pll_cal_cache_t *cache); // DW3720 only
 void ull_setfinegraintxseq(dwchip_t *dw, int32_t enable);
 void ull_setlnapamode(dwchip_t *dw, int32_t lna_pa);
 void ull_setgpiomode(dwchip_t *dw, uint32_t gpio_mask, uint32_t gpio_modes);
@@ -79,6 +80,10 @@ void ull_configciadiag(dwchip_t *dw, uint8_t enable_mask);
 int32_t ull_readstsquality(dwchip_t *dw, int16_t *rxStsQualityIndex);
 int32_t ull_readstsstatus(dwchip_t *dw, uint16_t *stsStatus, int32_t sts_num);
 void ull_readdiagnostics(dwchip_t *dw, dwt_rxdiag_t *diagnostics);
+int32_t ull_readrxreport(dwchip_t *dw, dwt_rxreport_t *report);
+int32_t ull_readcir_stream(dwchip_t *dw, dwt_acc_idx_e acc_idx, uint16_t sample_offs, uint16_t num_samples, dwt_cir_pack_e pack, dwt_cir_sink_cb_t sink, void *user_data);
+int32_t ull_savewarmcontext(dwchip_t *dw, dwt_warm_context_t *ctx);
+int32_t ull_initialise_warm(dwchip_t *dw, const dwt_warm_context_t *ctx);
 int ull_readdiagnostics_acc(dwchip_t *dw, dwt_cirdiags_t *cir_diag, dwt_acc_idx_e acc_idx);
 void ull_configeventcounters(dwchip_t *dw, int32_t enable);
 void ull_readeventcounters(dwchip_t *dw, dwt_deviceentcnts_t *counters);
@@ -108,6 +113,8 @@ void ull_set_keyreg_128(dwchip_t *dw, const dwt_aes_key_t *key);
 void ull_configure_aes(dwchip_t *dw, const dwt_aes_config_t *pCfg);
 dwt_mic_size_e ull_mic_size_from_bytes(dwchip_t *dw, uint8_t mic_size_in_bytes);
 int8_t ull_do_aes(dwchip_t *dw, dwt_aes_job_t *job, dwt_aes_core_type_e core_type);
+int8_t ull_do_aes_async(dwchip_t *dw, dwt_aes_job_t *job, dwt_aes_core_type_e core_type, dwt_aes_done_cb_t cb, void *user_data);
+int8_t ull_aes_poll(dwchip_t *dw);
 int32_t ull_check_dev_id(dwchip_t *dw);
 int32_t ull_run_pgfcal(dwchip_t *dw);
 int32_t ull_pgf_cal(dwchip_t *dw, int32_t ldoen);
@@ -148,9 +155,13 @@ int ull_calculate_first_path_power(struct dwchip_s *dw, const dwt_cirdiags_t *di
 int32_t ull_setpdoamode(dwchip_t *dw, dwt_pdoa_mode_e pdoaMode);
 int32_t ull_writetxdata(dwchip_t *dw, uint16_t txDataLength, uint8_t *txDataBytes, uint16_t txBufferOffset);
 void ull_writetxfctrl(dwchip_t *dw, uint16_t txFrameLength, uint16_t txBufferOffset, uint8_t ranging);
+int32_t ull_writetxtemplate(dwchip_t *dw, dwt_txtemplate_t *tpl, uint16_t txFrameLength, uint8_t *txFrameBytes, uint16_t txBufferOffset, uint8_t ranging);
+int32_t ull_sendtemplate(dwchip_t *dw, const dwt_txtemplate_t *tpl, const dwt_txpatch_t *patches, uint8_t numPatches, uint16_t txFrameLength, uint8_t mode);
 void ull_readrxtimestamp(dwchip_t *dw, uint8_t *timestamp);
 int32_t ull_rxenable(dwchip_t *dw, int32_t mode);
 void ull_readrxdata(dwchip_t *dw, uint8_t *buffer, uint16_t length, uint16_t rxBufferOffset);
+int32_t ull_writetxdata_async(dwchip_t *dw, uint16_t txDataLength, uint8_t *txDataBytes, uint16_t txBufferOffset, dwt_spi_done_cb_t cb, void *user_data);
+int32_t ull_readrxdata_async(dwchip_t *dw, uint8_t *buffer, uint16_t length, uint16_t rxBufferOffset, dwt_spi_done_cb_t cb, void *user_data);
 
 // DW3720 only
 void ull_setinterrupt_db(dwchip_t *dw, uint8_t bitmask, dwt_INT_options_e INT_options);
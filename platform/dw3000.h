@@ -8,5 +8,17 @@
 #include "deca_probe_interface.h"
 #include "dw3000_hw.h"
 #include "dw3000_spi.h"
+#if CONFIG_DW3000_RX_POOL
+#include "dw3000_rx_pool.h"
+#endif
+#if CONFIG_DW3000_RX_RING
+#include "dw3000_rx_ring.h"
+#endif
+#if CONFIG_DW3000_RANGING
+#include "dw3000_ranging.h"
+#endif
+#if CONFIG_DW3000_DEVICE
+#include "dw3000_drv.h"
+#endif
 
 #endif // DW3000_H
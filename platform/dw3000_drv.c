@@ -0,0 +1,279 @@
+#include <zephyr/device.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/pm/device.h>
+#include <zephyr/pm/device_runtime.h>
+
+#include "deca_device_api.h"
+#include "deca_probe_interface.h"
+#include "dw3000_drv.h"
+#include "dw3000_hw.h"
+#include "dw3000_spi.h"
+
+/* This file registers every DW3000 as Zephyr device, with runtime PM */
+
+LOG_MODULE_DECLARE(dw3000, CONFIG_DW3000_LOG_LEVEL);
+
+#define DT_DRV_COMPAT decawave_dw3000
+
+/* Maximum time for the XTAL to start after wakeup */
+#define DW3000_DRV_WAKEUP_TIMEOUT_US 5000
+
+/* dwt_config_t fields from the devicetree properties of instance n */
+#define DW3000_DRV_PLEN(n)                                                     \
+	(DT_INST_PROP(n, preamble_length) == 4096                                  \
+		 ? DWT_PLEN_4096                                                       \
+		 : (DT_INST_PROP(n, preamble_length) / 8 - 1))
+
+#define DW3000_DRV_PAC(n)                                                      \
+	(DT_INST_PROP(n, pac) == 4    ? DWT_PAC4                                   \
+	 : DT_INST_PROP(n, pac) == 16 ? DWT_PAC16                                  \
+	 : DT_INST_PROP(n, pac) == 32 ? DWT_PAC32                                  \
+								  : DWT_PAC8)
+
+#define DW3000_DRV_STS_LEN(n)                                                  \
+	(DT_INST_PROP(n, sts_length) == 32   ? DWT_STS_LEN_32                    \
+	 : DT_INST_PROP(n, sts_length) == 64   ? DWT_STS_LEN_64                    \
+	 : DT_INST_PROP(n, sts_length) == 128  ? DWT_STS_LEN_128                   \
+	 : DT_INST_PROP(n, sts_length) == 256  ? DWT_STS_LEN_256                   \
+	 : DT_INST_PROP(n, sts_length) == 512  ? DWT_STS_LEN_512                   \
+	 : DT_INST_PROP(n, sts_length) == 1024 ? DWT_STS_LEN_1024                  \
+										   : DWT_STS_LEN_2048)
+
+/* preamble length + 1 + SFD length - PAC */
+#define DW3000_DRV_SFD_TO(n)                                                   \
+	DT_INST_PROP_OR(n, sfd_timeout,                                            \
+					(DT_INST_PROP(n, preamble_length) + 1                      \
+					 + (DT_INST_PROP(n, sfd_type) == DWT_SFD_DW_16 ? 16 : 8)   \
+					 - DT_INST_PROP(n, pac)))
+
+#define DW3000_DRV_RADIO_CONFIG(n)                                             \
+	{                                                                          \
+		.chan = DT_INST_PROP(n, channel),                                      \
+		.txPreambLength = DW3000_DRV_PLEN(n),                                  \
+		.rxPAC = DW3000_DRV_PAC(n),                                            \
+		.txCode = DT_INST_PROP(n, preamble_code),                              \
+		.rxCode = DT_INST_PROP(n, preamble_code),                              \
+		.sfdType = DT_INST_PROP(n, sfd_type),                                  \
+		.dataRate = DT_INST_PROP(n, data_rate) == 850 ? DWT_BR_850K            \
+													  : DWT_BR_6M8,            \
+		.phrMode = DT_INST_PROP(n, phr_extended) ? DWT_PHRMODE_EXT             \
+												 : DWT_PHRMODE_STD,            \
+		.phrRate = DT_INST_PROP(n, phr_data_rate) ? DWT_PHRRATE_DTA            \
+												  : DWT_PHRRATE_STD,           \
+		.sfdTO = DW3000_DRV_SFD_TO(n),                                         \
+		.stsMode = DT_INST_PROP(n, sts_mode)                                   \
+				   | (DT_INST_PROP(n, sts_sdc) ? DWT_STS_MODE_SDC : 0),        \
+		.stsLength = DW3000_DRV_STS_LEN(n),                                    \
+		.pdoaMode = DT_INST_PROP(n, pdoa_mode),                                \
+	}
+
+/* what dwt_configure() would only find with DWT_API_ERROR_CHECK */
+#define DW3000_DRV_RADIO_CHECK(n)                                              \
+	BUILD_ASSERT(DT_INST_PROP(n, preamble_code) >= 1                           \
+					 && DT_INST_PROP(n, preamble_code) <= 32,                  \
+				 "DW3000: invalid preamble-code");                             \
+	BUILD_ASSERT(DT_INST_PROP(n, preamble_length) != 4096                      \
+					 || DT_INST_PROP(n, preamble_code) <= 24,                  \
+				 "DW3000: preamble-length 4096 is not supported with SCP");    \
+	BUILD_ASSERT(DT_INST_PROP(n, sts_mode) != 0 || !DT_INST_PROP(n, sts_sdc),  \
+				 "DW3000: sts-sdc needs an sts-mode");                         \
+	BUILD_ASSERT(DT_INST_PROP(n, pdoa_mode) != 3                               \
+					 || DT_INST_PROP(n, sts_mode) != 0,                        \
+				 "DW3000: pdoa-mode 3 needs an sts-mode");                     \
+	BUILD_ASSERT(DW3000_DRV_SFD_TO(n) > 0 && DW3000_DRV_SFD_TO(n) <= 0xFFFF,   \
+				 "DW3000: invalid sfd-timeout");
+
+struct dw3000_drv_config {
+	uint8_t inst;
+	const struct device* bus;
+	/* radio configuration from devicetree, or NULL */
+	const dwt_config_t* radio;
+};
+
+uint8_t dw3000_drv_inst(const struct device* dev)
+{
+	const struct dw3000_drv_config* cfg = dev->config;
+
+	return cfg->inst;
+}
+
+/* dwt_configure() of the devicetree configuration, with the instance locked */
+static int dw3000_drv_configure_radio(const struct dw3000_drv_config* cfg)
+{
+	/* dwt_configure() takes a non-const configuration */
+	dwt_config_t radio = *cfg->radio;
+
+	return dwt_configure(&radio) == DWT_SUCCESS ? 0 : -EIO;
+}
+
+int dw3000_drv_configure(const struct device* dev)
+{
+	const struct dw3000_drv_config* cfg = dev->config;
+	int ret;
+
+	if (cfg->radio == NULL) {
+		return -ENOTSUP;
+	}
+
+	dw3000_lock(cfg->inst);
+	ret = dw3000_drv_configure_radio(cfg);
+	dw3000_unlock(cfg->inst);
+
+	return ret;
+}
+
+#if CONFIG_PM_DEVICE
+/** put the DW3000 into DEEPSLEEP, after that its SPI bus can be suspended */
+static int dw3000_drv_suspend(const struct dw3000_drv_config* cfg)
+{
+	dw3000_lock(cfg->inst);
+	dw3000_hw_interrupt_disable();
+	dwt_configuresleep(DWT_CONFIG, DWT_PRES_SLEEP | DWT_WAKE_CSN | DWT_WAKE_WUP
+										| DWT_SLP_EN);
+	dwt_entersleep(DWT_DW_IDLE_RC);
+	dw3000_hw_wakeup_pin_low();
+	dw3000_unlock(cfg->inst);
+
+	/* release the reference taken by dw3000_drv_init() or the resume */
+	return pm_device_runtime_put(cfg->bus);
+}
+
+/** wake up the DW3000 and restore the configuration not kept in AON */
+static int dw3000_drv_resume(const struct dw3000_drv_config* cfg)
+{
+	int ret;
+
+	ret = pm_device_runtime_get(cfg->bus);
+	if (ret < 0) {
+		LOG_ERR("DW3000 %d SPI bus resume failed", cfg->inst);
+		return ret;
+	}
+
+	dw3000_lock(cfg->inst);
+	dw3000_hw_wakeup();
+	dw3000_hw_wait_ready(DW3000_DRV_WAKEUP_TIMEOUT_US);
+	if (!dwt_checkidlerc()) {
+		LOG_ERR("DW3000 %d did not wake up", cfg->inst);
+		ret = -EIO;
+	} else {
+		dwt_restoreconfig(1);
+	}
+	dw3000_hw_interrupt_enable();
+	dw3000_unlock(cfg->inst);
+
+	/* the device stays suspended, without a reference on its bus */
+	if (ret < 0) {
+		(void)pm_device_runtime_put(cfg->bus);
+	}
+	return ret;
+}
+
+static int dw3000_drv_pm_action(const struct device* dev,
+								enum pm_device_action action)
+{
+	const struct dw3000_drv_config* cfg = dev->config;
+
+	switch (action) {
+	case PM_DEVICE_ACTION_SUSPEND:
+		return dw3000_drv_suspend(cfg);
+	case PM_DEVICE_ACTION_RESUME:
+		return dw3000_drv_resume(cfg);
+	default:
+		return -ENOTSUP;
+	}
+}
+#endif
+
+static int dw3000_drv_setup(const struct device* dev)
+{
+	const struct dw3000_drv_config* cfg = dev->config;
+	int ret;
+
+	ret = dw3000_hw_init_ex(cfg->inst);
+	if (ret < 0) {
+		return ret;
+	}
+
+	dw3000_hw_reset_ex(cfg->inst);
+
+	ret = dw3000_hw_init_interrupt_ex(cfg->inst);
+	if (ret < 0) {
+		return ret;
+	}
+
+	dw3000_lock(cfg->inst);
+	ret = dw3000_probe_ex(cfg->inst);
+	if (ret < 0) {
+		LOG_ERR("DW3000 %d probe failed", cfg->inst);
+		dw3000_unlock(cfg->inst);
+		return -ENODEV;
+	}
+
+	ret = dwt_initialise(DWT_READ_OTP_PID | DWT_READ_OTP_LID | DWT_READ_OTP_BAT
+						 | DWT_READ_OTP_TMP);
+	if (ret < 0) {
+		LOG_ERR("DW3000 %d init failed", cfg->inst);
+		dw3000_unlock(cfg->inst);
+		return -EIO;
+	}
+
+	if (cfg->radio != NULL) {
+		ret = dw3000_drv_configure_radio(cfg);
+		if (ret < 0) {
+			LOG_ERR("DW3000 %d configure failed", cfg->inst);
+			dw3000_unlock(cfg->inst);
+			return -EIO;
+		}
+	}
+	dw3000_unlock(cfg->inst);
+
+	return 0;
+}
+
+static int dw3000_drv_init(const struct device* dev)
+{
+	const struct dw3000_drv_config* cfg = dev->config;
+	int ret;
+
+	/* The active device holds a reference on its SPI bus, which the
+	 * suspend releases */
+	ret = pm_device_runtime_get(cfg->bus);
+	if (ret < 0) {
+		return ret;
+	}
+
+	ret = dw3000_drv_setup(dev);
+	if (ret < 0) {
+		(void)pm_device_runtime_put(cfg->bus);
+		return ret;
+	}
+
+#if CONFIG_PM_DEVICE_RUNTIME
+	/* This puts the DW3000 into DEEPSLEEP until the first
+	 * pm_device_runtime_get() */
+	return pm_device_runtime_enable(dev);
+#else
+	return 0;
+#endif
+}
+
+#define DW3000_DRV_RADIO_DEFINE(n)                                             \
+	DW3000_DRV_RADIO_CHECK(n)                                                  \
+	static const dwt_config_t dw3000_drv_radio_##n                             \
+		= DW3000_DRV_RADIO_CONFIG(n);
+
+#define DW3000_DRV_DEFINE(n)                                                   \
+	IF_ENABLED(DT_INST_NODE_HAS_PROP(n, channel), (DW3000_DRV_RADIO_DEFINE(n))) \
+	static const struct dw3000_drv_config dw3000_drv_config_##n = {            \
+		.inst = n,                                                             \
+		.bus = DEVICE_DT_GET(DT_INST_BUS(n)),                                  \
+		.radio = COND_CODE_1(DT_INST_NODE_HAS_PROP(n, channel),                \
+							 (&dw3000_drv_radio_##n), (NULL)),                 \
+	};                                                                         \
+	PM_DEVICE_DT_INST_DEFINE(n, dw3000_drv_pm_action);                         \
+	DEVICE_DT_INST_DEFINE(n, dw3000_drv_init, PM_DEVICE_DT_INST_GET(n), NULL,  \
+						  &dw3000_drv_config_##n, POST_KERNEL,                 \
+						  CONFIG_DW3000_INIT_PRIORITY, NULL);
+
+DT_INST_FOREACH_STATUS_OKAY(DW3000_DRV_DEFINE)
@@ -0,0 +1,34 @@
+#ifndef DW3000_DRV_H
+#define DW3000_DRV_H
+
+#include <stdint.h>
+#include <zephyr/device.h>
+
+/*
+ * Zephyr device for each "decawave,dw3000" devicetree node. The device is
+ * reset, probed and initialised with dwt_initialise() at boot, so the
+ * application continues with dwt_configure(), unless the radio configuration
+ * is in devicetree (see dw3000_drv_configure()).
+ *
+ * With CONFIG_PM_DEVICE_RUNTIME the DW3000 is kept in DEEPSLEEP while it is
+ * not used: call pm_device_runtime_get() before using the radio (which wakes
+ * it up and calls dwt_restoreconfig()) and pm_device_runtime_put() when done.
+ * The IRQ is disabled and the SPI bus is released while suspended.
+ *
+ * Use dw3000_lock(dw3000_drv_inst(dev)) to select the device for the
+ * dwt_*() functions.
+ */
+
+uint8_t dw3000_drv_inst(const struct device* dev);
+
+/*
+ * When the devicetree node has a "channel" property the radio configuration
+ * of its properties is checked at build time and applied at boot, so
+ * dwt_configure() is not needed. This applies it again with dwt_configure(),
+ * e.g. after dwt_softreset(). The radio has to be awake.
+ *
+ * Returns 0, -ENOTSUP without devicetree configuration or -EIO.
+ */
+int dw3000_drv_configure(const struct device* dev);
+
+#endif
@@ -4,15 +4,34 @@
 #include <zephyr/logging/log.h>
 
 #include "deca_device_api.h"
+#include "deca_probe_interface.h"
 #include "dw3000_hw.h"
 #include "dw3000_spi.h"
+#include "dw3000_stats.h"
 
 LOG_MODULE_REGISTER(dw3000, CONFIG_DW3000_LOG_LEVEL);
 
-#define DW_INST DT_INST(0, decawave_dw3000)
+#define DT_DRV_COMPAT decawave_dw3000
 
-static struct gpio_callback gpio_cb;
-static struct k_work dw3000_isr_work;
+BUILD_ASSERT(DW3000_NUM_INST <= DWT_NUM_DW_DEV,
+			 "CONFIG_DW3000_NUM_INSTANCES is lower than the number of "
+			 "DW3000 devicetree instances");
+
+#if CONFIG_DW3000_READY_IRQ
+#define DW3000_RESET_PULSE_US	10
+#define DW3000_WAKEUP_PULSE_US	500
+#define DW3000_RESET_TIMEOUT_US 2000
+#define DW3000_READY_POLL_US	10
+#endif
+
+#if CONFIG_DW3000_IRQ_THREAD
+static K_THREAD_STACK_DEFINE(dw3000_isr_stack,
+							 CONFIG_DW3000_IRQ_THREAD_STACK_SIZE);
+static struct k_thread dw3000_isr_thread;
+static K_SEM_DEFINE(dw3000_isr_sem, 0, 1);
+static atomic_t dw3000_isr_pending;
+static bool dw3000_isr_thread_started;
+#endif
 
 struct dw3000_config {
 	struct gpio_dt_spec gpio_irq;
@@ -22,70 +41,190 @@ struct dw3000_config {
 	struct gpio_dt_spec gpio_spi_pha;
 };
 
-static const struct dw3000_config conf = {
-	.gpio_irq = GPIO_DT_SPEC_GET_OR(DW_INST, irq_gpios, {0}),
-	.gpio_reset = GPIO_DT_SPEC_GET_OR(DW_INST, reset_gpios, {0}),
-	.gpio_wakeup = GPIO_DT_SPEC_GET_OR(DW_INST, wakeup_gpios, {0}),
-	.gpio_spi_pol = GPIO_DT_SPEC_GET_OR(DW_INST, spi_pol_gpios, {0}),
-	.gpio_spi_pha = GPIO_DT_SPEC_GET_OR(DW_INST, spi_pha_gpios, {0}),
+/* per instance state */
+struct dw3000_data {
+	uint8_t inst;
+	struct gpio_callback gpio_cb;
+#if !CONFIG_DW3000_IRQ_THREAD
+	struct k_work isr_work;
+#endif
+#if CONFIG_DW3000_READY_IRQ
+	struct k_sem ready_sem;
+	atomic_t ready_wait;
+	bool irq_installed;
+#endif
+	bool irq_enabled;
 };
 
-int dw3000_hw_init(void)
+#define DW3000_HW_CONF(n)                                                      \
+	{                                                                          \
+		.gpio_irq = GPIO_DT_SPEC_INST_GET_OR(n, irq_gpios, {0}),               \
+		.gpio_reset = GPIO_DT_SPEC_INST_GET_OR(n, reset_gpios, {0}),           \
+		.gpio_wakeup = GPIO_DT_SPEC_INST_GET_OR(n, wakeup_gpios, {0}),         \
+		.gpio_spi_pol = GPIO_DT_SPEC_INST_GET_OR(n, spi_pol_gpios, {0}),       \
+		.gpio_spi_pha = GPIO_DT_SPEC_INST_GET_OR(n, spi_pha_gpios, {0}),       \
+	},
+
+static const struct dw3000_config confs[] = {
+	DT_INST_FOREACH_STATUS_OKAY(DW3000_HW_CONF)};
+
+static struct dw3000_data datas[DW3000_NUM_INST];
+
+/* instance used by the functions without instance parameter */
+static uint8_t cur_inst;
+
+/** select the instance used by the functions without instance parameter */
+void dw3000_hw_select(uint8_t inst)
+{
+	cur_inst = inst;
+	dw3000_spi_select(inst);
+}
+
+uint8_t dw3000_hw_selected(void)
+{
+	return cur_inst;
+}
+
+int dw3000_hw_init_ex(uint8_t inst)
 {
+	const struct dw3000_config* conf;
+
+	if (inst >= DW3000_NUM_INST) {
+		return -EINVAL;
+	}
+	conf = &confs[inst];
+
+	datas[inst].inst = inst;
+	dw3000_stats_init();
+#if CONFIG_DW3000_READY_IRQ
+	k_sem_init(&datas[inst].ready_sem, 0, 1);
+
+	/* IRQ is polled for SPIRDY until dw3000_hw_init_interrupt() */
+	if (conf->gpio_irq.port) {
+		gpio_pin_configure_dt(&conf->gpio_irq, GPIO_INPUT);
+	}
+#endif
+
 	/* Reset */
-	if (conf.gpio_reset.port) {
-		gpio_pin_configure_dt(&conf.gpio_reset, GPIO_INPUT);
-		LOG_INF("RESET on %s pin %d", conf.gpio_reset.port->name,
-				conf.gpio_reset.pin);
+	if (conf->gpio_reset.port) {
+		gpio_pin_configure_dt(&conf->gpio_reset, GPIO_INPUT);
+		LOG_INF("RESET on %s pin %d", conf->gpio_reset.port->name,
+				conf->gpio_reset.pin);
 	}
 
 	/* Wakeup (optional) */
-	if (conf.gpio_wakeup.port) {
-		gpio_pin_configure_dt(&conf.gpio_wakeup, GPIO_OUTPUT_ACTIVE);
-		LOG_INF("WAKEUP on %s pin %d", conf.gpio_wakeup.port->name,
-				conf.gpio_wakeup.pin);
+	if (conf->gpio_wakeup.port) {
+		gpio_pin_configure_dt(&conf->gpio_wakeup, GPIO_OUTPUT_ACTIVE);
+		LOG_INF("WAKEUP on %s pin %d", conf->gpio_wakeup.port->name,
+				conf->gpio_wakeup.pin);
 	}
 
 	/* SPI Polarity (optional) */
-	if (conf.gpio_spi_pol.port) {
-		gpio_pin_configure_dt(&conf.gpio_spi_pol, GPIO_OUTPUT_INACTIVE);
-		LOG_INF("SPI_POL on %s pin %d", conf.gpio_spi_pol.port->name,
-				conf.gpio_spi_pol.pin);
+	if (conf->gpio_spi_pol.port) {
+		gpio_pin_configure_dt(&conf->gpio_spi_pol, GPIO_OUTPUT_INACTIVE);
+		LOG_INF("SPI_POL on %s pin %d", conf->gpio_spi_pol.port->name,
+				conf->gpio_spi_pol.pin);
 	}
 
 	/* SPI Phase (optional) */
-	if (conf.gpio_spi_pha.port) {
-		gpio_pin_configure_dt(&conf.gpio_spi_pha, GPIO_OUTPUT_INACTIVE);
-		LOG_INF("SPI_PHA on %s pin %d", conf.gpio_spi_pha.port->name,
-				conf.gpio_spi_pha.pin);
+	if (conf->gpio_spi_pha.port) {
+		gpio_pin_configure_dt(&conf->gpio_spi_pha, GPIO_OUTPUT_INACTIVE);
+		LOG_INF("SPI_PHA on %s pin %d", conf->gpio_spi_pha.port->name,
+				conf->gpio_spi_pha.pin);
 	}
 
 	return dw3000_spi_init();
 }
 
-static void dw3000_hw_isr_work_handler(struct k_work* item)
+int dw3000_hw_init(void)
+{
+	return dw3000_hw_init_ex(cur_inst);
+}
+
+/* run dwt_isr() with the instance selected */
+static void dw3000_hw_isr_dispatch(uint8_t inst)
 {
+	dw3000_lock(inst);
+	dw3000_stats_isr_start(inst);
 	dwt_isr();
+	dw3000_stats_isr_end();
+	dw3000_unlock(inst);
 }
 
+#if CONFIG_DW3000_IRQ_THREAD
+static void dw3000_hw_isr_thread_fn(void* p1, void* p2, void* p3)
+{
+	while (true) {
+		k_sem_take(&dw3000_isr_sem, K_FOREVER);
+		for (uint8_t i = 0; i < DW3000_NUM_INST; i++) {
+			if (atomic_test_and_clear_bit(&dw3000_isr_pending, i)) {
+				dw3000_hw_isr_dispatch(i);
+			}
+		}
+	}
+}
+#else
+static void dw3000_hw_isr_work_handler(struct k_work* item)
+{
+	struct dw3000_data* data = CONTAINER_OF(item, struct dw3000_data, isr_work);
+
+	dw3000_hw_isr_dispatch(data->inst);
+}
+#endif
+
 static void dw3000_hw_isr(const struct device* dev, struct gpio_callback* cb,
 						  uint32_t pins)
 {
-	k_work_submit(&dw3000_isr_work);
+	struct dw3000_data* data = CONTAINER_OF(cb, struct dw3000_data, gpio_cb);
+	bool queued;
+
+#if CONFIG_DW3000_READY_IRQ
+	if (atomic_cas(&data->ready_wait, 1, 0)) {
+		k_sem_give(&data->ready_sem);
+		return;
+	}
+#endif
+
+#if CONFIG_DW3000_IRQ_THREAD
+	queued = !atomic_test_and_set_bit(&dw3000_isr_pending, data->inst);
+	k_sem_give(&dw3000_isr_sem);
+#else
+	queued = k_work_submit(&data->isr_work) > 0;
+#endif
+	dw3000_stats_irq(data->inst, queued);
 }
 
-int dw3000_hw_init_interrupt(void)
+int dw3000_hw_init_interrupt_ex(uint8_t inst)
 {
-	if (conf.gpio_irq.port) {
-		k_work_init(&dw3000_isr_work, dw3000_hw_isr_work_handler);
+	const struct dw3000_config* conf = &confs[inst];
+	struct dw3000_data* data = &datas[inst];
+
+	if (conf->gpio_irq.port) {
+#if CONFIG_DW3000_IRQ_THREAD
+		if (!dw3000_isr_thread_started) {
+			k_thread_create(&dw3000_isr_thread, dw3000_isr_stack,
+							K_THREAD_STACK_SIZEOF(dw3000_isr_stack),
+							dw3000_hw_isr_thread_fn, NULL, NULL, NULL,
+							CONFIG_DW3000_IRQ_THREAD_PRIORITY, 0, K_NO_WAIT);
+			k_thread_name_set(&dw3000_isr_thread, "dw3000_isr");
+			dw3000_isr_thread_started = true;
+		}
+#else
+		k_work_init(&data->isr_work, dw3000_hw_isr_work_handler);
+#endif
 
-		gpio_pin_configure_dt(&conf.gpio_irq, GPIO_INPUT);
-		gpio_init_callback(&gpio_cb, dw3000_hw_isr, BIT(conf.gpio_irq.pin));
-		gpio_add_callback(conf.gpio_irq.port, &gpio_cb);
-		gpio_pin_interrupt_configure_dt(&conf.gpio_irq, GPIO_INT_EDGE_RISING);
+		gpio_pin_configure_dt(&conf->gpio_irq, GPIO_INPUT);
+		gpio_init_callback(&data->gpio_cb, dw3000_hw_isr,
+						   BIT(conf->gpio_irq.pin));
+		gpio_add_callback(conf->gpio_irq.port, &data->gpio_cb);
+		gpio_pin_interrupt_configure_dt(&conf->gpio_irq, GPIO_INT_EDGE_RISING);
+		data->irq_enabled = true;
+#if CONFIG_DW3000_READY_IRQ
+		data->irq_installed = true;
+#endif
 
-		LOG_INF("IRQ on %s pin %d", conf.gpio_irq.port->name,
-				conf.gpio_irq.pin);
+		LOG_INF("IRQ on %s pin %d", conf->gpio_irq.port->name,
+				conf->gpio_irq.pin);
 		return 0;
 	} else {
 		LOG_ERR("IRQ pin not configured");
@@ -93,65 +232,196 @@ int dw3000_hw_init_interrupt(void)
 	}
 }
 
+int dw3000_hw_init_interrupt(void)
+{
+	return dw3000_hw_init_interrupt_ex(cur_inst);
+}
+
 void dw3000_hw_interrupt_enable(void)
 {
-	if (conf.gpio_irq.port) {
-		gpio_pin_interrupt_configure_dt(&conf.gpio_irq, GPIO_INT_EDGE_RISING);
+	const struct dw3000_config* conf = &confs[cur_inst];
+
+	if (conf->gpio_irq.port) {
+		gpio_pin_interrupt_configure_dt(&conf->gpio_irq, GPIO_INT_EDGE_RISING);
+		datas[cur_inst].irq_enabled = true;
 	}
 }
 
 void dw3000_hw_interrupt_disable(void)
 {
-	if (conf.gpio_irq.port) {
-		gpio_pin_interrupt_configure_dt(&conf.gpio_irq, GPIO_INT_DISABLE);
+	const struct dw3000_config* conf = &confs[cur_inst];
+
+	if (conf->gpio_irq.port) {
+		datas[cur_inst].irq_enabled = false;
+		gpio_pin_interrupt_configure_dt(&conf->gpio_irq, GPIO_INT_DISABLE);
 	}
 }
 
 bool dw3000_hw_interrupt_is_enabled(void)
 {
-	return true; // TODO
+	return datas[cur_inst].irq_enabled;
+}
+
+void dw3000_hw_fini_ex(uint8_t inst)
+{
+	const struct dw3000_config* conf = &confs[inst];
+
+	if (conf->gpio_irq.port) {
+		gpio_pin_interrupt_configure_dt(&conf->gpio_irq, GPIO_INT_DISABLE);
+		gpio_remove_callback(conf->gpio_irq.port, &datas[inst].gpio_cb);
+		datas[inst].irq_enabled = false;
+#if CONFIG_DW3000_READY_IRQ
+		datas[inst].irq_installed = false;
+#endif
+	}
+
+	/* Wakeup pin low, so the DW3000 can stay in DEEPSLEEP */
+	if (conf->gpio_wakeup.port) {
+		gpio_pin_set_dt(&conf->gpio_wakeup, 0);
+	}
+
+	dw3000_spi_fini_ex(inst);
 }
 
 void dw3000_hw_fini(void)
 {
-	// TODO
-	dw3000_spi_fini();
+	dw3000_hw_fini_ex(cur_inst);
 }
 
-void dw3000_hw_reset()
+#if CONFIG_DW3000_READY_IRQ
+static bool dw3000_hw_irq_active(uint8_t inst)
+{
+	return gpio_pin_get_dt(&confs[inst].gpio_irq) > 0;
+}
+
+/** clear SPIRDY and RCINIT in SYS_STATUS, which releases the IRQ line */
+static void dw3000_hw_clear_ready(uint8_t inst)
+{
+	/* write SYS_STATUS (0x0:0x44) at byte offset 2 */
+	const uint8_t header[2] = {0xC1, 0x18};
+	const uint8_t body[2] = {
+		(uint8_t)((DWT_INT_SPIRDY_BIT_MASK | DWT_INT_RCINIT_BIT_MASK) >> 16),
+		(uint8_t)((DWT_INT_SPIRDY_BIT_MASK | DWT_INT_RCINIT_BIT_MASK) >> 24),
+	};
+
+	dw3000_spi_write_ex(inst, sizeof(header), header, sizeof(body), body);
+}
+#endif
+
+/**
+ * wait until the device is ready (SPIRDY on the IRQ line) or timeout_us
+ * passed. The interrupt is used once dw3000_hw_init_interrupt() was called,
+ * the IRQ pin is polled before. Returns 0 when ready or -ETIMEDOUT.
+ * Without CONFIG_DW3000_READY_IRQ this just sleeps for timeout_us.
+ */
+int32_t dw3000_hw_wait_ready_ex(uint8_t inst, uint32_t timeout_us)
 {
-	if (!conf.gpio_reset.port) {
+#if CONFIG_DW3000_READY_IRQ
+	struct dw3000_data* data = &datas[inst];
+	int ret = 0;
+
+	if (!confs[inst].gpio_irq.port) {
+		k_usleep(timeout_us);
+		return 0;
+	}
+
+	if (data->irq_installed) {
+		k_sem_reset(&data->ready_sem);
+		atomic_set(&data->ready_wait, 1);
+		if (!dw3000_hw_irq_active(inst)) {
+			ret = k_sem_take(&data->ready_sem, K_USEC(timeout_us));
+		}
+		atomic_set(&data->ready_wait, 0);
+	} else {
+		uint32_t waited = 0;
+		while (!dw3000_hw_irq_active(inst)) {
+			if (waited >= timeout_us) {
+				ret = -ETIMEDOUT;
+				break;
+			}
+			k_busy_wait(DW3000_READY_POLL_US);
+			waited += DW3000_READY_POLL_US;
+		}
+	}
+
+	if (ret == 0) {
+		dw3000_hw_clear_ready(inst);
+	} else {
+		ret = -ETIMEDOUT;
+		LOG_DBG("SPIRDY timeout");
+	}
+	return ret;
+#else
+	k_usleep(timeout_us);
+	return 0;
+#endif
+}
+
+int32_t dw3000_hw_wait_ready(uint32_t timeout_us)
+{
+	return dw3000_hw_wait_ready_ex(cur_inst, timeout_us);
+}
+
+void dw3000_hw_reset_ex(uint8_t inst)
+{
+	const struct dw3000_config* conf = &confs[inst];
+
+	if (!conf->gpio_reset.port) {
 		LOG_ERR("No HW reset configured");
 		return;
 	}
 
-	gpio_pin_configure_dt(&conf.gpio_reset, GPIO_OUTPUT_ACTIVE);
+	gpio_pin_configure_dt(&conf->gpio_reset, GPIO_OUTPUT_ACTIVE);
+#if CONFIG_DW3000_READY_IRQ
+	k_busy_wait(DW3000_RESET_PULSE_US);
+	gpio_pin_configure_dt(&conf->gpio_reset, GPIO_INPUT);
+	dw3000_hw_wait_ready_ex(inst, DW3000_RESET_TIMEOUT_US);
+#else
 	k_msleep(1); // 10 us?
-	gpio_pin_configure_dt(&conf.gpio_reset, GPIO_INPUT);
+	gpio_pin_configure_dt(&conf->gpio_reset, GPIO_INPUT);
 	k_msleep(2);
+#endif
+}
+
+void dw3000_hw_reset()
+{
+	dw3000_hw_reset_ex(cur_inst);
 }
 
 /** wakeup either using the WAKEUP pin or SPI CS */
-void dw3000_hw_wakeup(void)
+void dw3000_hw_wakeup_ex(uint8_t inst)
 {
-	if (conf.gpio_wakeup.port) {
+	const struct dw3000_config* conf = &confs[inst];
+
+	if (conf->gpio_wakeup.port) {
 		/* Use WAKEUP pin if available */
 		LOG_INF("WAKEUP PIN");
-		gpio_pin_set_dt(&conf.gpio_wakeup, 1);
+		gpio_pin_set_dt(&conf->gpio_wakeup, 1);
+#if CONFIG_DW3000_READY_IRQ
+		k_busy_wait(DW3000_WAKEUP_PULSE_US);
+#else
 		k_msleep(1);
-		gpio_pin_set_dt(&conf.gpio_wakeup, 0);
+#endif
+		gpio_pin_set_dt(&conf->gpio_wakeup, 0);
 
 	} else {
 		/* Use SPI CS pin */
 		LOG_INF("WAKEUP CS");
-		dw3000_spi_wakeup();
+		dw3000_spi_wakeup_ex(inst);
 	}
 }
 
+void dw3000_hw_wakeup(void)
+{
+	dw3000_hw_wakeup_ex(cur_inst);
+}
+
 /** set WAKEUP pin low if available */
 void dw3000_hw_wakeup_pin_low(void)
 {
-	if (conf.gpio_wakeup.port) {
-		gpio_pin_set_dt(&conf.gpio_wakeup, 0);
+	const struct dw3000_config* conf = &confs[cur_inst];
+
+	if (conf->gpio_wakeup.port) {
+		gpio_pin_set_dt(&conf->gpio_wakeup, 0);
 	}
 }
@@ -2,12 +2,29 @@
 #define DW3000_HW_H
 
 #include <stdbool.h>
+#include <stdint.h>
+
+#include <zephyr/devicetree.h>
+
+/* Number of DW3000 devices in devicetree */
+#define DW3000_NUM_INST DT_NUM_INST_STATUS_OKAY(decawave_dw3000)
+
+/* Functions without instance parameter use the selected instance */
+void dw3000_hw_select(uint8_t inst);
+uint8_t dw3000_hw_selected(void);
 
 int dw3000_hw_init(void);
+int dw3000_hw_init_ex(uint8_t inst);
 int dw3000_hw_init_interrupt(void);
+int dw3000_hw_init_interrupt_ex(uint8_t inst);
 void dw3000_hw_fini(void);
+void dw3000_hw_fini_ex(uint8_t inst);
 void dw3000_hw_reset(void);
+void dw3000_hw_reset_ex(uint8_t inst);
+int32_t dw3000_hw_wait_ready(uint32_t timeout_us);
+int32_t dw3000_hw_wait_ready_ex(uint8_t inst, uint32_t timeout_us);
 void dw3000_hw_wakeup(void);
+void dw3000_hw_wakeup_ex(uint8_t inst);
 void dw3000_hw_wakeup_pin_low(void);
 void dw3000_hw_interrupt_enable(void);
 void dw3000_hw_interrupt_disable(void);
@@ -0,0 +1,287 @@
+#include <errno.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include "deca_device_api.h"
+#include "dw3000_ranging.h"
+
+/* This file implements a ranging sequence engine driven by the ISR callbacks */
+
+LOG_MODULE_DECLARE(dw3000, CONFIG_DW3000_LOG_LEVEL);
+
+#define RNG_TS_MASK 0xFFFFFFFFFFULL
+/* DX_TIME holds bits 39:8 of the device time, and the TX time is only
+ * precise to 9 bits */
+#define RNG_DX_TIME(uus) ((uint32_t)(uus) << 8)
+#define RNG_DTU(uus)	 ((uint64_t)(uus) << 16)
+#define RNG_TX_RES_MASK	 0x1FFULL
+
+static const struct dw3000_rng_schedule* rng_sched;
+static uint8_t rng_step;
+static bool rng_rx_armed; /* the next RX step is enabled after the TX */
+static uint64_t rng_last_rx;
+static uint64_t rng_last_tx;
+static uint64_t rng_ts[CONFIG_DW3000_RANGING_MAX_STEPS];
+
+uint64_t dw3000_rng_ts_get(const uint8_t* buf)
+{
+	uint64_t ts = 0;
+
+	for (int i = 4; i >= 0; i--) {
+		ts = (ts << 8) | buf[i];
+	}
+	return ts;
+}
+
+void dw3000_rng_ts_put(uint8_t* buf, uint64_t ts)
+{
+	for (int i = 0; i < 5; i++) {
+		buf[i] = (uint8_t)ts;
+		ts >>= 8;
+	}
+}
+
+uint64_t dw3000_rng_ts_sub(uint64_t a, uint64_t b)
+{
+	return (a - b) & RNG_TS_MASK;
+}
+
+int64_t dw3000_rng_ds_twr_tof(uint64_t round1, uint64_t reply1,
+							  uint64_t round2, uint64_t reply2)
+{
+	int64_t ra = (int64_t)round1;
+	int64_t da = (int64_t)reply1;
+	int64_t rb = (int64_t)round2;
+	int64_t db = (int64_t)reply2;
+
+	return (ra * rb - da * db) / (ra + rb + da + db);
+}
+
+static void rng_finish(int result)
+{
+	const struct dw3000_rng_schedule* sched = rng_sched;
+
+	rng_sched = NULL;
+	rng_rx_armed = false;
+	if (result != 0) {
+		dwt_forcetrxoff();
+	}
+
+	if (sched->done != NULL) {
+		sched->done(result, rng_ts, sched->user_data);
+	}
+}
+
+static int32_t rng_mode(const struct dw3000_rng_step* step)
+{
+	switch (step->ref) {
+	case DW3000_RNG_AFTER_RX:
+		return step->tx ? DWT_START_TX_DLY_RS : DWT_START_RX_DLY_RS;
+	case DW3000_RNG_AFTER_TX:
+		return step->tx ? DWT_START_TX_DLY_TS : DWT_START_RX_DLY_TS;
+	case DW3000_RNG_AFTER_REF:
+		return step->tx ? DWT_START_TX_DLY_REF : DWT_START_RX_DLY_REF;
+	default:
+		return step->tx ? DWT_START_TX_IMMEDIATE : DWT_START_RX_IMMEDIATE;
+	}
+}
+
+/** predict the TX timestamp of a delayed TX step */
+static uint64_t rng_tx_time(const struct dw3000_rng_step* step)
+{
+	uint64_t ref;
+
+	switch (step->ref) {
+	case DW3000_RNG_AFTER_RX:
+		ref = rng_last_rx;
+		break;
+	case DW3000_RNG_AFTER_TX:
+		ref = rng_last_tx;
+		break;
+	case DW3000_RNG_AFTER_REF:
+		ref = rng_ts[0];
+		break;
+	default:
+		return 0;
+	}
+
+	return (((ref + RNG_DTU(step->delay_uus)) & ~RNG_TX_RES_MASK)
+			+ dwt_gettxantennadelay())
+		   & RNG_TS_MASK;
+}
+
+static void rng_run(void)
+{
+	const struct dw3000_rng_step* step = &rng_sched->steps[rng_step];
+	const struct dw3000_rng_step* next = NULL;
+	dwt_txpatch_t patches[CONFIG_DW3000_RANGING_MAX_PATCHES];
+	uint8_t num_patches = 0;
+	int32_t mode = rng_mode(step);
+	int32_t ret;
+
+	if (rng_step + 1 < rng_sched->num_steps) {
+		next = &rng_sched->steps[rng_step + 1];
+	}
+
+	if (step->ref != DW3000_RNG_NOW) {
+		dwt_setdelayedtrxtime(RNG_DX_TIME(step->delay_uus));
+	}
+
+	if (!step->tx) {
+		dwt_setrxtimeout(step->timeout_uus);
+		ret = dwt_rxenable(mode);
+	} else {
+		if (next != NULL && !next->tx && next->ref == DW3000_RNG_AFTER_TX) {
+			/* let the DW3000 enable the receiver after the TX */
+			dwt_setrxaftertxdelay(next->delay_uus);
+			dwt_setrxtimeout(next->timeout_uus);
+			mode |= DWT_RESPONSE_EXPECTED;
+			rng_rx_armed = true;
+		}
+
+		if (rng_sched->prepare_tx != NULL) {
+			num_patches = rng_sched->prepare_tx(rng_step, rng_tx_time(step),
+												patches, rng_sched->user_data);
+			__ASSERT_NO_MSG(num_patches <= CONFIG_DW3000_RANGING_MAX_PATCHES);
+		}
+		ret = dwt_sendtemplate(step->tpl, patches, num_patches, 0,
+							   (uint8_t)mode);
+	}
+
+	if (ret != DWT_SUCCESS) {
+		LOG_DBG("ranging step %d too late", rng_step);
+		rng_finish(-ETIME);
+	}
+}
+
+/** the current step has completed, continue with the next one */
+static void rng_advance(void)
+{
+	if (rng_step == 0) {
+		dwt_setreferencetrxtime((uint32_t)(rng_ts[0] >> 8));
+	}
+
+	rng_step++;
+	if (rng_step >= rng_sched->num_steps) {
+		rng_finish(0);
+	} else if (rng_rx_armed) {
+		/* receiver was already enabled after the TX */
+		rng_rx_armed = false;
+	} else {
+		rng_run();
+	}
+}
+
+int dw3000_rng_start(const struct dw3000_rng_schedule* sched)
+{
+	decaIrqStatus_t stat;
+
+	if (sched->num_steps == 0
+		|| sched->num_steps > CONFIG_DW3000_RANGING_MAX_STEPS
+		|| sched->steps[0].ref != DW3000_RNG_NOW) {
+		return -EINVAL;
+	}
+
+	for (int i = 0; i < sched->num_steps; i++) {
+		if (sched->steps[i].tx && sched->steps[i].tpl == NULL) {
+			return -EINVAL;
+		}
+	}
+
+	stat = decamutexon();
+	if (rng_sched != NULL) {
+		decamutexoff(stat);
+		return -EBUSY;
+	}
+
+	rng_sched = sched;
+	rng_step = 0;
+	rng_rx_armed = false;
+	for (int i = 0; i < sched->num_steps; i++) {
+		rng_ts[i] = 0;
+	}
+	rng_run();
+	decamutexoff(stat);
+
+	return 0;
+}
+
+void dw3000_rng_stop(void)
+{
+	decaIrqStatus_t stat;
+
+	stat = decamutexon();
+	if (rng_sched != NULL) {
+		rng_sched = NULL;
+		rng_rx_armed = false;
+		dwt_forcetrxoff();
+	}
+	decamutexoff(stat);
+}
+
+bool dw3000_rng_running(void)
+{
+	return rng_sched != NULL;
+}
+
+void dw3000_rng_tx_done(const dwt_cb_data_t* cb_data)
+{
+	uint8_t ts[5];
+
+	ARG_UNUSED(cb_data);
+
+	if (rng_sched == NULL || !rng_sched->steps[rng_step].tx) {
+		return;
+	}
+
+	dwt_readtxtimestamp(ts);
+	rng_last_tx = dw3000_rng_ts_get(ts);
+	rng_ts[rng_step] = rng_last_tx;
+	rng_advance();
+}
+
+void dw3000_rng_rx_ok(const dwt_cb_data_t* cb_data)
+{
+	uint8_t ts[5];
+	int ret = 0;
+
+	if (rng_sched == NULL || rng_sched->steps[rng_step].tx) {
+		return;
+	}
+
+	dwt_readrxtimestamp(ts, DWT_COMPAT_NONE);
+
+	if (rng_sched->rx_frame != NULL) {
+		ret = rng_sched->rx_frame(rng_step, cb_data, rng_sched->user_data);
+	}
+
+	if (ret < 0) {
+		rng_finish(ret);
+	} else if (ret > 0) {
+		/* not the expected frame, the timeout restarts */
+		dwt_setrxtimeout(rng_sched->steps[rng_step].timeout_uus);
+		dwt_rxenable(DWT_START_RX_IMMEDIATE);
+	} else {
+		rng_last_rx = dw3000_rng_ts_get(ts);
+		rng_ts[rng_step] = rng_last_rx;
+		rng_advance();
+	}
+}
+
+void dw3000_rng_rx_to(const dwt_cb_data_t* cb_data)
+{
+	ARG_UNUSED(cb_data);
+
+	if (rng_sched != NULL) {
+		rng_finish(-ETIMEDOUT);
+	}
+}
+
+void dw3000_rng_rx_err(const dwt_cb_data_t* cb_data)
+{
+	ARG_UNUSED(cb_data);
+
+	if (rng_sched != NULL) {
+		rng_finish(-EIO);
+	}
+}
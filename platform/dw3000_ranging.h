@@ -0,0 +1,91 @@
+#ifndef DW3000_RANGING_H
+#define DW3000_RANGING_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "deca_device_api.h"
+
+/*
+ * Ranging sequence engine: a ranging exchange (e.g. SS-TWR or DS-TWR) is
+ * described as a list of TX and RX steps, each with a delay relative to the
+ * previous RX or TX timestamp or to the timestamp of the first step. The
+ * steps are run from the driver callbacks with the delayed TX/RX modes of the
+ * DW3000 (DWT_START_TX_DLY_RS/TS/REF), so the host does not have to react
+ * within the reply delay, and an RX step directly after a TX step is enabled
+ * automatically after the transmission (DWT_RESPONSE_EXPECTED).
+ *
+ * Usage: set dw3000_rng_tx_done(), dw3000_rng_rx_ok(), dw3000_rng_rx_to() and
+ * dw3000_rng_rx_err() as callbacks in dwt_setcallbacks() and start a schedule
+ * with dw3000_rng_start(). The done callback receives the timestamps of all
+ * steps. TX frames are templates (dwt_writetxtemplate()) which are patched in
+ * the prepare_tx callback, e.g. with the predicted TX time of the step.
+ *
+ * Times are in UWB microseconds (512/499.2MHz, as dwt_setrxtimeout()),
+ * timestamps are 40-bit device time units (DWT_TIME_UNITS).
+ */
+
+enum dw3000_rng_ref {
+	DW3000_RNG_NOW,		 /* immediately, delay_uus is ignored */
+	DW3000_RNG_AFTER_RX, /* after the RX timestamp of the last received frame */
+	DW3000_RNG_AFTER_TX, /* after the TX timestamp of the last sent frame, for
+							an RX step directly after a TX step: after the
+							end of the frame, see dwt_setrxaftertxdelay() */
+	DW3000_RNG_AFTER_REF, /* after the timestamp of the first step */
+};
+
+struct dw3000_rng_step {
+	bool tx;				 /* send tpl, or receive */
+	enum dw3000_rng_ref ref; /* the time the delay refers to */
+	uint32_t delay_uus;		 /* delay after ref */
+	uint32_t timeout_uus;	 /* RX: time the receiver stays on, 0 for none */
+	const dwt_txtemplate_t* tpl; /* TX: the frame */
+};
+
+struct dw3000_rng_schedule {
+	const struct dw3000_rng_step* steps;
+	uint8_t num_steps; /* up to CONFIG_DW3000_RANGING_MAX_STEPS */
+
+	/* Optional, called before a TX step to fill in up to
+	 * CONFIG_DW3000_RANGING_MAX_PATCHES patches of its frame. tx_ts is the
+	 * predicted TX timestamp for delayed steps and 0 for DW3000_RNG_NOW.
+	 * The patch data must stay valid after the callback returns. Returns the
+	 * number of patches. */
+	uint8_t (*prepare_tx)(uint8_t step, uint64_t tx_ts, dwt_txpatch_t* patches,
+						  void* user_data);
+
+	/* Optional, called when the frame of an RX step was received, e.g. to
+	 * read it with dwt_readrxdata(). Returns 0 to continue with the next
+	 * step, 1 to ignore the frame and receive again, or a negative error
+	 * code to stop the sequence with it. */
+	int (*rx_frame)(uint8_t step, const dwt_cb_data_t* cb_data,
+					void* user_data);
+
+	/* Called at the end of the sequence with 0 or a negative error code
+	 * (-ETIME: delayed TX/RX too late, -ETIMEDOUT: RX timeout, -EIO: RX
+	 * error) and the timestamps of the steps that completed. */
+	void (*done)(int result, const uint64_t* ts, void* user_data);
+
+	void* user_data;
+};
+
+int dw3000_rng_start(const struct dw3000_rng_schedule* sched);
+void dw3000_rng_stop(void);
+bool dw3000_rng_running(void);
+
+void dw3000_rng_tx_done(const dwt_cb_data_t* cb_data);
+void dw3000_rng_rx_ok(const dwt_cb_data_t* cb_data);
+void dw3000_rng_rx_to(const dwt_cb_data_t* cb_data);
+void dw3000_rng_rx_err(const dwt_cb_data_t* cb_data);
+
+/* 40-bit timestamp helpers */
+uint64_t dw3000_rng_ts_get(const uint8_t* buf);
+void dw3000_rng_ts_put(uint8_t* buf, uint64_t ts);
+uint64_t dw3000_rng_ts_sub(uint64_t a, uint64_t b);
+
+/* DS-TWR time of flight (asymmetric formula) in device time units, from the
+ * round and reply times of both sides, which have to be below 30ms */
+int64_t dw3000_rng_ds_twr_tof(uint64_t round1, uint64_t reply1,
+							  uint64_t round2, uint64_t reply2);
+
+#endif
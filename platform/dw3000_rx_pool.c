@@ -0,0 +1,58 @@
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/net/buf.h>
+
+#include "deca_device_api.h"
+#include "deca_interface.h"
+#include "dw3000_rx_pool.h"
+
+/* This file implements zero-copy RX frame delivery from a net_buf pool */
+
+LOG_MODULE_DECLARE(dw3000, CONFIG_DW3000_LOG_LEVEL);
+
+NET_BUF_POOL_DEFINE(dw3000_rx_pool, CONFIG_DW3000_RX_POOL_COUNT,
+					CONFIG_DW3000_RX_POOL_FRAME_SIZE, 0, NULL);
+
+static dw3000_rx_frame_cb_t rx_frame_cb;
+static atomic_t rx_dropped;
+
+void dw3000_rx_pool_set_callback(dw3000_rx_frame_cb_t cb)
+{
+	rx_frame_cb = cb;
+}
+
+uint32_t dw3000_rx_pool_dropped(void)
+{
+	return (uint32_t)atomic_get(&rx_dropped);
+}
+
+void dw3000_rx_pool_rx_ok(const dwt_cb_data_t* cb_data)
+{
+	struct net_buf* buf;
+	uint16_t len = cb_data->datalength;
+
+	if (rx_frame_cb == NULL || len == 0) {
+		return;
+	}
+
+	if (len > CONFIG_DW3000_RX_POOL_FRAME_SIZE) {
+		LOG_WRN("RX frame too long for pool (%u)", len);
+		atomic_inc(&rx_dropped);
+		rx_frame_cb(NULL, cb_data);
+		return;
+	}
+
+	/* called from the ISR handler context, must not block */
+	buf = net_buf_alloc(&dw3000_rx_pool, K_NO_WAIT);
+	if (buf == NULL) {
+		atomic_inc(&rx_dropped);
+		rx_frame_cb(NULL, cb_data);
+		return;
+	}
+
+	/* read from the chip which received the frame, not the selected one */
+	cb_data->dw->dwt_driver->dwt_ops->read_rx_data(
+		cb_data->dw, net_buf_add(buf, len), len, 0);
+
+	rx_frame_cb(buf, cb_data);
+}
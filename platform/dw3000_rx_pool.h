@@ -0,0 +1,30 @@
+#ifndef DW3000_RX_POOL_H
+#define DW3000_RX_POOL_H
+
+#include <stdint.h>
+#include <zephyr/net/buf.h>
+
+#include "deca_device_api.h"
+
+/*
+ * Zero-copy RX frame delivery: the frame is read from the DW3000 RX buffer
+ * directly into a buffer of a driver owned net_buf pool, which is then handed
+ * to the application. The application owns the buffer and has to release it
+ * with net_buf_unref() when done, possibly from another thread.
+ *
+ * Usage: set dw3000_rx_pool_rx_ok() as cbRxOk in dwt_setcallbacks() and
+ * register the frame callback with dw3000_rx_pool_set_callback().
+ */
+
+/* Called with the received frame (including FCS) and the callback data of
+ * the ISR. Ownership of buf is passed to the callback. buf is NULL if the
+ * frame was dropped (longer than CONFIG_DW3000_RX_POOL_FRAME_SIZE or no free
+ * buffer), the callback is still called so the receiver can be re-enabled. */
+typedef void (*dw3000_rx_frame_cb_t)(struct net_buf* buf,
+									 const dwt_cb_data_t* cb_data);
+
+void dw3000_rx_pool_set_callback(dw3000_rx_frame_cb_t cb);
+void dw3000_rx_pool_rx_ok(const dwt_cb_data_t* cb_data);
+uint32_t dw3000_rx_pool_dropped(void);
+
+#endif
@@ -0,0 +1,127 @@
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include "deca_device_api.h"
+#include "dw3000_rx_ring.h"
+
+/* This file implements a continuous double buffered RX pipeline */
+
+LOG_MODULE_DECLARE(dw3000, CONFIG_DW3000_LOG_LEVEL);
+
+#define RING_SIZE CONFIG_DW3000_RX_RING_SIZE
+
+static struct dw3000_rx_frame ring[RING_SIZE];
+static atomic_t ring_head; /* next slot written by the ISR */
+static atomic_t ring_tail; /* next slot released by the application */
+static atomic_t ring_stopped;
+static atomic_t ring_dropped;
+static bool ring_running;
+static K_SEM_DEFINE(ring_sem, 0, RING_SIZE);
+
+static uint32_t ring_used(void)
+{
+	return (uint32_t)atomic_get(&ring_head) - (uint32_t)atomic_get(&ring_tail);
+}
+
+static void ring_rearm(void)
+{
+	if (ring_running && atomic_cas(&ring_stopped, 1, 0)) {
+		dwt_rxenable(DWT_START_RX_IMMEDIATE);
+	}
+}
+
+int dw3000_rx_ring_start(void)
+{
+	decaIrqStatus_t stat;
+	int ret;
+
+	stat = decamutexon();
+	atomic_set(&ring_head, 0);
+	atomic_set(&ring_tail, 0);
+	atomic_set(&ring_stopped, 0);
+	k_sem_reset(&ring_sem);
+	ring_running = true;
+
+	dwt_setdblrxbuffmode(DBL_BUF_STATE_EN, DBL_BUF_MODE_AUTO);
+	ret = dwt_rxenable(DWT_START_RX_IMMEDIATE);
+	decamutexoff(stat);
+
+	return ret;
+}
+
+void dw3000_rx_ring_stop(void)
+{
+	decaIrqStatus_t stat;
+
+	stat = decamutexon();
+	ring_running = false;
+	dwt_forcetrxoff();
+	dwt_setdblrxbuffmode(DBL_BUF_STATE_DIS, DBL_BUF_MODE_MAN);
+	decamutexoff(stat);
+}
+
+void dw3000_rx_ring_rx_ok(const dwt_cb_data_t* cb_data)
+{
+	struct dw3000_rx_frame* frame;
+
+	if (!ring_running) {
+		return;
+	}
+
+	if (ring_used() >= RING_SIZE
+		|| cb_data->datalength > CONFIG_DW3000_RX_RING_FRAME_SIZE) {
+		atomic_inc(&ring_dropped);
+		return;
+	}
+
+	frame = &ring[(uint32_t)atomic_get(&ring_head) % RING_SIZE];
+	frame->status = cb_data->status;
+	frame->rx_flags = cb_data->rx_flags;
+	frame->len = cb_data->datalength;
+	dwt_readrxtimestamp(frame->timestamp, DWT_COMPAT_NONE);
+	frame->clock_offset = dwt_readclockoffset();
+	dwt_readrxdata(frame->data, frame->len, 0);
+
+	atomic_inc(&ring_head);
+	k_sem_give(&ring_sem);
+
+	if (ring_used() >= RING_SIZE) {
+		/* no space for the next frame: stop until a slot is released */
+		atomic_set(&ring_stopped, 1);
+		dwt_forcetrxoff();
+
+		/* a slot may have been released in the meantime */
+		if (ring_used() < RING_SIZE) {
+			ring_rearm();
+		}
+	}
+}
+
+struct dw3000_rx_frame* dw3000_rx_ring_get(k_timeout_t timeout)
+{
+	if (k_sem_take(&ring_sem, timeout) != 0) {
+		return NULL;
+	}
+
+	return &ring[(uint32_t)atomic_get(&ring_tail) % RING_SIZE];
+}
+
+void dw3000_rx_ring_release(struct dw3000_rx_frame* frame)
+{
+	decaIrqStatus_t stat;
+
+	__ASSERT(frame == &ring[(uint32_t)atomic_get(&ring_tail) % RING_SIZE],
+			 "RX ring frames must be released in order");
+	ARG_UNUSED(frame);
+
+	atomic_inc(&ring_tail);
+
+	stat = decamutexon();
+	ring_rearm();
+	decamutexoff(stat);
+}
+
+uint32_t dw3000_rx_ring_dropped(void)
+{
+	return (uint32_t)atomic_get(&ring_dropped);
+}
@@ -0,0 +1,37 @@
+#ifndef DW3000_RX_RING_H
+#define DW3000_RX_RING_H
+
+#include <stdint.h>
+#include <zephyr/kernel.h>
+
+#include "deca_device_api.h"
+
+/*
+ * Continuous RX pipeline: the receiver runs in double buffer mode with
+ * automatic re-enable, and every received frame is drained from the DW3000
+ * into a slot of a host ring, together with its RX timestamp and clock
+ * offset. When the ring is full the receiver is stopped, and it is re-armed
+ * as soon as the application releases a slot.
+ *
+ * Usage: set dw3000_rx_ring_rx_ok() as cbRxOk in dwt_setcallbacks(), call
+ * dw3000_rx_ring_start() and then get frames with dw3000_rx_ring_get(). Each
+ * frame has to be released with dw3000_rx_ring_release() in the same order.
+ */
+
+struct dw3000_rx_frame {
+	uint32_t status;	  /* SYS_STATUS as the ISR was entered */
+	uint8_t rx_flags;	  /* see DWT_CB_DATA_RX_FLAG_* */
+	uint8_t timestamp[5]; /* RX timestamp */
+	int16_t clock_offset; /* see dwt_readclockoffset() */
+	uint16_t len;		  /* frame length including FCS */
+	uint8_t data[CONFIG_DW3000_RX_RING_FRAME_SIZE];
+};
+
+int dw3000_rx_ring_start(void);
+void dw3000_rx_ring_stop(void);
+struct dw3000_rx_frame* dw3000_rx_ring_get(k_timeout_t timeout);
+void dw3000_rx_ring_release(struct dw3000_rx_frame* frame);
+void dw3000_rx_ring_rx_ok(const dwt_cb_data_t* cb_data);
+uint32_t dw3000_rx_ring_dropped(void);
+
+#endif
@@ -9,7 +9,10 @@
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
 
+#include "deca_interface.h"
+#include "dw3000_hw.h"
 #include "dw3000_spi.h"
+#include "dw3000_stats.h"
 
 #include "version.h"
 
@@ -19,75 +22,214 @@ LOG_MODULE_DECLARE(dw3000, CONFIG_DW3000_LOG_LEVEL);
 
 #define TX_WAIT_RESP_NRF52840_DELAY 30
 
-#define DW_INST DT_INST(0, decawave_dw3000)
-#define DW_SPI	DT_PARENT(DT_INST(0, decawave_dw3000))
+/* chained transactions of a batch sent in one spi_transceive() */
+#define DW3000_SPI_CHAIN_MAX 8
 
-static const struct device* spi;
+#define DT_DRV_COMPAT decawave_dw3000
+
+#define DW3000_SPI_DEV(n) DEVICE_DT_GET(DT_INST_BUS(n)),
+
+static const struct device* const spi_devs[] = {
+	DT_INST_FOREACH_STATUS_OKAY(DW3000_SPI_DEV)};
 #if KERNEL_VERSION_MAJOR > 3                                                   \
 	|| (KERNEL_VERSION_MAJOR == 3 && KERNEL_VERSION_MINOR >= 4)
-static struct spi_cs_control cs_ctrl = SPI_CS_CONTROL_INIT(DW_INST, 0);
+#define DW3000_SPI_CS(n) SPI_CS_CONTROL_INIT(DT_DRV_INST(n), 0),
+static struct spi_cs_control cs_ctrls[] = {
+	DT_INST_FOREACH_STATUS_OKAY(DW3000_SPI_CS)};
 #else
-static struct spi_cs_control* cs_ctrl = SPI_CS_CONTROL_PTR_DT(DW_INST, 0);
+#define DW3000_SPI_CS(n) SPI_CS_CONTROL_PTR_DT(DT_DRV_INST(n), 0),
+static struct spi_cs_control* cs_ctrls[] = {
+	DT_INST_FOREACH_STATUS_OKAY(DW3000_SPI_CS)};
 #endif
-static struct spi_config spi_cfgs[2] = {0}; // configs for slow and fast
-static struct spi_config* spi_cfg;
+#define DW3000_SPI_MAX_FREQ(n) DT_INST_PROP(n, spi_max_frequency),
+static const uint32_t spi_max_freqs[] = {
+	DT_INST_FOREACH_STATUS_OKAY(DW3000_SPI_MAX_FREQ)};
 
-int dw3000_spi_init(void)
+/* Slow SPI clock speed, needed before the DW3000 PLL is locked */
+#define DW3000_SPI_SLOW_FREQ 2000000
+
+// configs for slow and fast, per instance
+static struct spi_config spi_cfgs_inst[DW3000_NUM_INST][2] = {0};
+static bool spi_fast[DW3000_NUM_INST];
+static uint8_t spi_bus_locks[DW3000_NUM_INST];
+
+/* instance used by the functions without instance parameter */
+static uint8_t spi_inst;
+
+#if CONFIG_DW3000_SPI_ASYNC
+/* asynchronous transfer of an instance, the buffer descriptors have to stay
+ * valid until it completed */
+struct dw3000_spi_async {
+	struct spi_buf tx_buf[2];
+	struct spi_buf rx_buf[2];
+	struct spi_buf_set tx;
+	struct spi_buf_set rx;
+	dwt_spi_done_cb_t cb;
+	void* user_data;
+	uint8_t trace_flags;
+	uint32_t trace_start;
+	/* given when the transfer completed, after its callback */
+	struct k_sem done;
+};
+
+static struct dw3000_spi_async spi_async[DW3000_NUM_INST];
+#endif
+
+/* config of the current speed of the instance */
+static inline struct spi_config* dw3000_spi_cfg(uint8_t inst)
+{
+	return &spi_cfgs_inst[inst][spi_fast[inst] ? 1 : 0];
+}
+
+static int dw3000_spi_init_inst(uint8_t inst)
 {
+	struct spi_config* spi_cfgs = spi_cfgs_inst[inst];
+
 	/* set common SPI config */
-	for (int i = 0; i < ARRAY_SIZE(spi_cfgs); i++) {
-		spi_cfgs[i].cs = cs_ctrl;
+	for (int i = 0; i < 2; i++) {
+		spi_cfgs[i].cs = cs_ctrls[inst];
 		spi_cfgs[i].operation = SPI_WORD_SET(8);
 	}
 
-	/* Slow SPI clock speed: 2MHz */
-	spi_cfgs[0].frequency = 2000000;
+	/* High SPI clock speed: spi-max-frequency of the board, limited by
+	 * CONFIG_DW3000_SPI_MAX_MHZ */
+	spi_cfgs[1].frequency
+		= MIN(spi_max_freqs[inst], CONFIG_DW3000_SPI_MAX_MHZ * 1000000);
 
-	/* High SPI clock speed: assume 8MHz for all boards */
-	spi_cfgs[1].frequency = 8000000;
+	/* Slow SPI clock speed: 2MHz */
+	spi_cfgs[0].frequency = MIN(spi_cfgs[1].frequency, DW3000_SPI_SLOW_FREQ);
 
-	/* High SPI clock speed: increase for boards which support higher speeds */
-#if CONFIG_SOC_NRF52833 || CONFIG_SOC_NRF52840 || CONFIG_SOC_NRF5340_CPUAPP
-#if CONFIG_SHIELD_QORVO_DWS3000
-	/* Due to the wiring of the Nordic Development Boards and the DWS3000
-	 * Arduino shield it is not possible to use more than 16MHz */
-	spi_cfgs[1].frequency = 16000000;
-#else
-	spi_cfgs[1].frequency = CONFIG_DW3000_SPI_MAX_MHZ * 1000000;
-#endif
+#if CONFIG_DW3000_SPI_ASYNC
+	k_sem_init(&spi_async[inst].done, 0, 1);
 #endif
 
-	spi_cfg = &spi_cfgs[0];
-
-	spi = DEVICE_DT_GET(DW_SPI);
-	if (!spi) {
-		LOG_ERR("DW3000 SPI binding failed");
+	if (!device_is_ready(spi_devs[inst])) {
+		LOG_ERR("DW3000 %d SPI binding failed", inst);
 		return -1;
 	} else {
-		LOG_INF("DW3000 (max %dMHz)", spi_cfgs[1].frequency / 1000000);
+		LOG_INF("DW3000 %d (max %dMHz)", inst, spi_cfgs[1].frequency / 1000000);
 	}
 
 	return 0;
 }
 
+int dw3000_spi_init(void)
+{
+	int ret = 0;
+
+	for (uint8_t i = 0; i < DW3000_NUM_INST && ret == 0; i++) {
+		ret = dw3000_spi_init_inst(i);
+	}
+
+	return ret;
+}
+
+/** select the instance used by the SPI functions without instance parameter */
+void dw3000_spi_select(uint8_t inst)
+{
+	spi_inst = inst;
+}
+
+uint8_t dw3000_spi_selected(void)
+{
+	return spi_inst;
+}
+
+/* the bus is locked for the config pointer, so a lock moves with the speed */
+static void dw3000_spi_speed_set(uint8_t inst, bool fast)
+{
+	struct spi_config* cur = dw3000_spi_cfg(inst);
+	struct spi_config* cfg = &spi_cfgs_inst[inst][fast ? 1 : 0];
+
+	if (cfg == cur) {
+		return;
+	}
+
+	if (spi_bus_locks[inst] > 0) {
+		spi_release(spi_devs[inst], cur);
+		cur->operation &= ~SPI_LOCK_ON;
+		cfg->operation |= SPI_LOCK_ON;
+	}
+
+	spi_fast[inst] = fast;
+}
+
+void dw3000_spi_speed_slow_ex(uint8_t inst)
+{
+	dw3000_spi_speed_set(inst, false);
+}
+
+void dw3000_spi_speed_fast_ex(uint8_t inst)
+{
+	dw3000_spi_speed_set(inst, true);
+}
+
 void dw3000_spi_speed_slow(void)
 {
-	spi_cfg = &spi_cfgs[0];
+	dw3000_spi_speed_slow_ex(spi_inst);
 }
 
 void dw3000_spi_speed_fast(void)
 {
-	spi_cfg = &spi_cfgs[1];
+	dw3000_spi_speed_fast_ex(spi_inst);
+}
+
+/**
+ * keep the SPI bus for this device, from the next transfer until the
+ * matching dw3000_spi_bus_unlock(). Other devices on the same bus wait
+ * meanwhile, and the controller does not need to be reconfigured between
+ * the transfers. Can be nested.
+ */
+void dw3000_spi_bus_lock_ex(uint8_t inst)
+{
+	if (spi_bus_locks[inst]++ == 0) {
+		dw3000_spi_cfg(inst)->operation |= SPI_LOCK_ON;
+	}
+}
+
+void dw3000_spi_bus_unlock_ex(uint8_t inst)
+{
+	struct spi_config* cfg = dw3000_spi_cfg(inst);
+
+	if (spi_bus_locks[inst] == 0) {
+		return;
+	}
+
+	if (--spi_bus_locks[inst] == 0) {
+		spi_release(spi_devs[inst], cfg);
+		cfg->operation &= ~SPI_LOCK_ON;
+	}
+}
+
+void dw3000_spi_bus_lock(void)
+{
+	dw3000_spi_bus_lock_ex(spi_inst);
+}
+
+void dw3000_spi_bus_unlock(void)
+{
+	dw3000_spi_bus_unlock_ex(spi_inst);
+}
+
+/** release the SPI bus, e.g. if it was locked with SPI_LOCK_ON */
+void dw3000_spi_fini_ex(uint8_t inst)
+{
+	struct spi_config* cfg = dw3000_spi_cfg(inst);
+
+	spi_release(spi_devs[inst], cfg);
+	spi_bus_locks[inst] = 0;
+	cfg->operation &= ~SPI_LOCK_ON;
 }
 
 void dw3000_spi_fini(void)
 {
-	// TODO
+	dw3000_spi_fini_ex(spi_inst);
 }
 
-int32_t dw3000_spi_write_crc(uint16_t headerLength, const uint8_t* headerBuffer,
-						 uint16_t bodyLength, const uint8_t* bodyBuffer,
-						 uint8_t crc8)
+int32_t dw3000_spi_write_crc_ex(uint8_t inst, uint16_t headerLength,
+								const uint8_t* headerBuffer,
+								uint16_t bodyLength,
+								const uint8_t* bodyBuffer, uint8_t crc8)
 {
 	const struct spi_buf tx_buf[3] = {
 		{
@@ -107,12 +249,21 @@ int32_t dw3000_spi_write_crc(uint16_t headerLength, const uint8_t* headerBuffer,
 		.buffers = tx_buf,
 		.count = ARRAY_SIZE(tx_buf),
 	};
+	uint32_t start = dw3000_spi_trace_start();
 
-	return spi_transceive(spi, spi_cfg, &tx, NULL);
+	int ret = spi_transceive(spi_devs[inst], dw3000_spi_cfg(inst), &tx, NULL);
+
+	dw3000_spi_trace_in(DW3000_SPI_TRACE_CRC
+							| (ret ? DW3000_SPI_TRACE_ERROR : 0),
+						headerBuffer, headerLength, bodyBuffer, bodyLength,
+						start);
+	dw3000_stats_spi(headerLength + bodyLength + 1, ret);
+	return ret;
 }
 
-int32_t dw3000_spi_write(uint16_t headerLength, const uint8_t* headerBuffer,
-					 uint16_t bodyLength, const uint8_t* bodyBuffer)
+int32_t dw3000_spi_write_ex(uint8_t inst, uint16_t headerLength,
+							const uint8_t* headerBuffer, uint16_t bodyLength,
+							const uint8_t* bodyBuffer)
 {
 	const struct spi_buf tx_buf[2] = {
 		{
@@ -128,12 +279,38 @@ int32_t dw3000_spi_write(uint16_t headerLength, const uint8_t* headerBuffer,
 		.buffers = tx_buf,
 		.count = ARRAY_SIZE(tx_buf),
 	};
+	uint32_t start = dw3000_spi_trace_start();
 
-	return spi_transceive(spi, spi_cfg, &tx, NULL);
+	int ret = spi_transceive(spi_devs[inst], dw3000_spi_cfg(inst), &tx, NULL);
+
+	dw3000_spi_trace_in(ret ? DW3000_SPI_TRACE_ERROR : 0, headerBuffer,
+						headerLength, bodyBuffer, bodyLength, start);
+	dw3000_stats_spi(headerLength + bodyLength, ret);
+	return ret;
 }
 
-int32_t dw3000_spi_read(uint16_t headerLength, uint8_t* headerBuffer,
-					uint16_t readLength, uint8_t* readBuffer)
+static void dw3000_spi_read_delay(int ret)
+{
+#if (CONFIG_SOC_NRF52840_QIAA)
+	/*
+	 *  This is a hack to handle the corrupted response frame through the
+	 * nRF52840's SPI3. See this project's issue-log
+	 * (https://github.com/foldedtoad/dwm3000/issues/2) for details. The delay
+	 * value is set in the CMakeList.txt file for this subproject.
+	 */
+	if (ret == 0) {
+		for (volatile int i = 0; i < TX_WAIT_RESP_NRF52840_DELAY; i++) {
+			/* spin */
+		}
+	}
+#else
+	ARG_UNUSED(ret);
+#endif
+}
+
+int32_t dw3000_spi_read_ex(uint8_t inst, uint16_t headerLength,
+						   uint8_t* headerBuffer, uint16_t readLength,
+						   uint8_t* readBuffer)
 {
 	const struct spi_buf tx_buf = {
 		.buf = headerBuffer,
@@ -157,36 +334,261 @@ int32_t dw3000_spi_read(uint16_t headerLength, uint8_t* headerBuffer,
 		.buffers = rx_buf,
 		.count = ARRAY_SIZE(rx_buf),
 	};
+	uint32_t start = dw3000_spi_trace_start();
 
-	int ret = spi_transceive(spi, spi_cfg, &tx, &rx);
+	int ret = spi_transceive(spi_devs[inst], dw3000_spi_cfg(inst), &tx, &rx);
 
-#if (CONFIG_SOC_NRF52840_QIAA)
-	/*
-	 *  This is a hack to handle the corrupted response frame through the
-	 * nRF52840's SPI3. See this project's issue-log
-	 * (https://github.com/foldedtoad/dwm3000/issues/2) for details. The delay
-	 * value is set in the CMakeList.txt file for this subproject.
-	 */
-	if (ret == 0) {
-		for (volatile int i = 0; i < TX_WAIT_RESP_NRF52840_DELAY; i++) {
-			/* spin */
+	dw3000_spi_trace_in(DW3000_SPI_TRACE_READ
+							| (ret ? DW3000_SPI_TRACE_ERROR : 0),
+						headerBuffer, headerLength, readBuffer, readLength,
+						start);
+	dw3000_stats_spi(headerLength + readLength, ret);
+	dw3000_spi_read_delay(ret);
+	return ret;
+}
+
+int32_t dw3000_spi_write_crc(uint16_t headerLength, const uint8_t* headerBuffer,
+							 uint16_t bodyLength, const uint8_t* bodyBuffer,
+							 uint8_t crc8)
+{
+	return dw3000_spi_write_crc_ex(spi_inst, headerLength, headerBuffer,
+								   bodyLength, bodyBuffer, crc8);
+}
+
+int32_t dw3000_spi_write(uint16_t headerLength, const uint8_t* headerBuffer,
+						 uint16_t bodyLength, const uint8_t* bodyBuffer)
+{
+	return dw3000_spi_write_ex(spi_inst, headerLength, headerBuffer,
+							   bodyLength, bodyBuffer);
+}
+
+int32_t dw3000_spi_read(uint16_t headerLength, uint8_t* headerBuffer,
+						uint16_t readLength, uint8_t* readBuffer)
+{
+	return dw3000_spi_read_ex(spi_inst, headerLength, headerBuffer,
+							  readLength, readBuffer);
+}
+
+/* send the bodies of xfers[1..count-1], which are chained to xfers[0], in
+ * the frame of xfers[0], with only its header */
+static int32_t dw3000_spi_xfer_chain(uint8_t inst,
+									 const struct dwt_spi_xfer_s* xfers,
+									 uint16_t count)
+{
+	struct spi_buf bufs[DW3000_SPI_CHAIN_MAX + 1];
+	const struct spi_buf hdr_buf = {
+		.buf = (void*)xfers[0].header,
+		.len = xfers[0].headerLength,
+	};
+	struct spi_buf_set tx = {
+		.buffers = bufs,
+		.count = count + 1,
+	};
+	const struct spi_buf_set rx = {
+		.buffers = bufs,
+		.count = count + 1,
+	};
+	uint16_t len = 0;
+	uint32_t start = dw3000_spi_trace_start();
+	int ret;
+
+	bufs[0] = hdr_buf;
+	for (uint16_t i = 0; i < count; i++) {
+		bufs[i + 1].buf = xfers[i].buffer;
+		bufs[i + 1].len = xfers[i].length;
+		len += xfers[i].length;
+	}
+
+	if (xfers[0].read) {
+		/* only the header is sent, the data received meanwhile skipped */
+		bufs[0].buf = NULL;
+		tx.buffers = &hdr_buf;
+		tx.count = 1;
+		ret = spi_transceive(spi_devs[inst], dw3000_spi_cfg(inst), &tx, &rx);
+	} else {
+		ret = spi_transceive(spi_devs[inst], dw3000_spi_cfg(inst), &tx, NULL);
+	}
+
+	/* traced with the first body only */
+	dw3000_spi_trace_in((xfers[0].read ? DW3000_SPI_TRACE_READ : 0)
+							| (ret ? DW3000_SPI_TRACE_ERROR : 0),
+						xfers[0].header, xfers[0].headerLength,
+						xfers[0].buffer, xfers[0].length, start);
+	dw3000_stats_spi(xfers[0].headerLength + len, ret);
+	if (xfers[0].read) {
+		dw3000_spi_read_delay(ret);
+	}
+	return ret;
+}
+
+int32_t dw3000_spi_xfer_batch_ex(uint8_t inst,
+								 const struct dwt_spi_xfer_s* xfers,
+								 uint16_t count)
+{
+	int32_t ret = 0;
+	uint16_t n;
+
+	/* Every transaction needs its own CS assertion, except the chained ones,
+	 * which are sent in the frame they continue. The bus is held for all */
+	dw3000_spi_bus_lock_ex(inst);
+	for (uint16_t i = 0; i < count && ret == 0; i += n) {
+		n = 1;
+		while (i + n < count && n < DW3000_SPI_CHAIN_MAX
+			   && xfers[i + n].chained) {
+			n++;
+		}
+
+		if (n > 1) {
+			ret = dw3000_spi_xfer_chain(inst, &xfers[i], n);
+		} else if (xfers[i].read) {
+			ret = dw3000_spi_read_ex(inst, xfers[i].headerLength,
+									 (uint8_t*)xfers[i].header,
+									 xfers[i].length, xfers[i].buffer);
+		} else {
+			ret = dw3000_spi_write_ex(inst, xfers[i].headerLength,
+									  xfers[i].header, xfers[i].length,
+									  xfers[i].buffer);
 		}
 	}
-#endif
+	dw3000_spi_bus_unlock_ex(inst);
 
 	return ret;
 }
 
-void dw3000_spi_wakeup()
+int32_t dw3000_spi_xfer_batch(const struct dwt_spi_xfer_s* xfers, uint16_t count)
+{
+	return dw3000_spi_xfer_batch_ex(spi_inst, xfers, count);
+}
+
+#if CONFIG_DW3000_SPI_ASYNC
+static void dw3000_spi_async_done(const struct device* dev, int result,
+								  void* data)
+{
+	struct dw3000_spi_async* async = data;
+	const struct spi_buf* body = (async->trace_flags & DW3000_SPI_TRACE_READ)
+									 ? &async->rx_buf[1]
+									 : &async->tx_buf[1];
+
+	ARG_UNUSED(dev);
+
+	dw3000_spi_trace_in(async->trace_flags
+							| (result ? DW3000_SPI_TRACE_ERROR : 0),
+						async->tx_buf[0].buf, async->tx_buf[0].len, body->buf,
+						body->len, async->trace_start);
+	dw3000_stats_spi(async->tx_buf[0].len + body->len, result);
+
+	if (async->cb != NULL) {
+		async->cb(result == 0 ? DWT_SUCCESS : DWT_ERROR, async->user_data);
+	}
+	k_sem_give(&async->done);
+}
+
+int32_t dw3000_spi_write_async_ex(uint8_t inst, uint16_t headerLength,
+								  const uint8_t* headerBuffer,
+								  uint16_t bodyLength,
+								  const uint8_t* bodyBuffer,
+								  dwt_spi_done_cb_t cb, void* user_data)
+{
+	struct dw3000_spi_async* async = &spi_async[inst];
+
+	async->tx_buf[0].buf = (void*)headerBuffer;
+	async->tx_buf[0].len = headerLength;
+	async->tx_buf[1].buf = (void*)bodyBuffer;
+	async->tx_buf[1].len = bodyLength;
+	async->tx.buffers = async->tx_buf;
+	async->tx.count = ARRAY_SIZE(async->tx_buf);
+
+	async->cb = cb;
+	async->user_data = user_data;
+	async->trace_flags = DW3000_SPI_TRACE_ASYNC;
+	async->trace_start = dw3000_spi_trace_start();
+	k_sem_reset(&async->done);
+
+	return spi_transceive_cb(spi_devs[inst], dw3000_spi_cfg(inst), &async->tx,
+							 NULL, dw3000_spi_async_done, async);
+}
+
+int32_t dw3000_spi_read_async_ex(uint8_t inst, uint16_t headerLength,
+								 uint8_t* headerBuffer, uint16_t readLength,
+								 uint8_t* readBuffer, dwt_spi_done_cb_t cb,
+								 void* user_data)
+{
+	struct dw3000_spi_async* async = &spi_async[inst];
+
+	async->tx_buf[0].buf = headerBuffer;
+	async->tx_buf[0].len = headerLength;
+	async->tx.buffers = async->tx_buf;
+	async->tx.count = 1;
+
+	async->rx_buf[0].buf = NULL;
+	async->rx_buf[0].len = headerLength;
+	async->rx_buf[1].buf = readBuffer;
+	async->rx_buf[1].len = readLength;
+	async->rx.buffers = async->rx_buf;
+	async->rx.count = ARRAY_SIZE(async->rx_buf);
+
+	async->cb = cb;
+	async->user_data = user_data;
+	async->trace_flags = DW3000_SPI_TRACE_ASYNC | DW3000_SPI_TRACE_READ;
+	async->trace_start = dw3000_spi_trace_start();
+	k_sem_reset(&async->done);
+
+	return spi_transceive_cb(spi_devs[inst], dw3000_spi_cfg(inst), &async->tx,
+							 &async->rx, dw3000_spi_async_done, async);
+}
+
+int32_t dw3000_spi_wait_async_ex(uint8_t inst)
+{
+	return k_sem_take(&spi_async[inst].done, K_FOREVER) == 0 ? DWT_SUCCESS
+															 : DWT_ERROR;
+}
+
+int32_t dw3000_spi_write_async(uint16_t headerLength,
+							   const uint8_t* headerBuffer, uint16_t bodyLength,
+							   const uint8_t* bodyBuffer, dwt_spi_done_cb_t cb,
+							   void* user_data)
+{
+	return dw3000_spi_write_async_ex(spi_inst, headerLength, headerBuffer,
+									 bodyLength, bodyBuffer, cb, user_data);
+}
+
+int32_t dw3000_spi_read_async(uint16_t headerLength, uint8_t* headerBuffer,
+							  uint16_t readLength, uint8_t* readBuffer,
+							  dwt_spi_done_cb_t cb, void* user_data)
+{
+	return dw3000_spi_read_async_ex(spi_inst, headerLength, headerBuffer,
+									readLength, readBuffer, cb, user_data);
+}
+
+int32_t dw3000_spi_wait_async(void)
+{
+	return dw3000_spi_wait_async_ex(spi_inst);
+}
+#endif
+
+void dw3000_spi_wakeup_ex(uint8_t inst)
 {
 #if KERNEL_VERSION_MAJOR > 3                                                   \
 	|| (KERNEL_VERSION_MAJOR == 3 && KERNEL_VERSION_MINOR >= 4)
-	gpio_pin_set_dt(&cs_ctrl.gpio, 0);
+	gpio_pin_set_dt(&cs_ctrls[inst].gpio, 0);
+#if CONFIG_DW3000_READY_IRQ
+	k_busy_wait(500);
+#else
 	k_sleep(K_USEC(500));
-	gpio_pin_set_dt(&cs_ctrl.gpio, 1);
+#endif
+	gpio_pin_set_dt(&cs_ctrls[inst].gpio, 1);
+#else
+	gpio_pin_set_dt(&cs_ctrls[inst]->gpio, 0);
+#if CONFIG_DW3000_READY_IRQ
+	k_busy_wait(500);
 #else
-	gpio_pin_set_dt(&cs_ctrl->gpio, 0);
 	k_sleep(K_USEC(500));
-	gpio_pin_set_dt(&cs_ctrl->gpio, 1);
 #endif
+	gpio_pin_set_dt(&cs_ctrls[inst]->gpio, 1);
+#endif
+}
+
+void dw3000_spi_wakeup()
+{
+	dw3000_spi_wakeup_ex(spi_inst);
 }
@@ -2,6 +2,11 @@
 #define DW3000_SPI_H
 
 #include <stdint.h>
+#include <zephyr/kernel.h>
+
+#include "deca_device_api.h"
+
+struct dwt_spi_xfer_s;
 
 #ifndef CONFIG_DW3000_SPI_TRACE
 #define CONFIG_DW3000_SPI_TRACE 0
@@ -9,9 +14,14 @@
 
 int dw3000_spi_init(void);
 void dw3000_spi_fini(void);
+void dw3000_spi_select(uint8_t inst);
+uint8_t dw3000_spi_selected(void);
 void dw3000_spi_wakeup(void);
+void dw3000_spi_wakeup_ex(uint8_t inst);
 void dw3000_spi_speed_slow(void);
 void dw3000_spi_speed_fast(void);
+void dw3000_spi_bus_lock(void);
+void dw3000_spi_bus_unlock(void);
 int32_t dw3000_spi_read(uint16_t headerLength, uint8_t* headerBuffer,
 						uint16_t readLength, uint8_t* readBuffer);
 int32_t dw3000_spi_write(uint16_t headerLength, const uint8_t* headerBuffer,
@@ -19,7 +29,81 @@ int32_t dw3000_spi_write(uint16_t headerLength, const uint8_t* headerBuffer,
 int32_t dw3000_spi_write_crc(uint16_t headerLength, const uint8_t* headerBuffer,
 							 uint16_t bodyLength, const uint8_t* bodyBuffer,
 							 uint8_t crc8);
+int32_t dw3000_spi_xfer_batch(const struct dwt_spi_xfer_s* xfers, uint16_t count);
+
+/* the same for an explicit instance, independent of the selected one */
+void dw3000_spi_fini_ex(uint8_t inst);
+void dw3000_spi_speed_slow_ex(uint8_t inst);
+void dw3000_spi_speed_fast_ex(uint8_t inst);
+void dw3000_spi_bus_lock_ex(uint8_t inst);
+void dw3000_spi_bus_unlock_ex(uint8_t inst);
+int32_t dw3000_spi_read_ex(uint8_t inst, uint16_t headerLength,
+						   uint8_t* headerBuffer, uint16_t readLength,
+						   uint8_t* readBuffer);
+int32_t dw3000_spi_write_ex(uint8_t inst, uint16_t headerLength,
+							const uint8_t* headerBuffer, uint16_t bodyLength,
+							const uint8_t* bodyBuffer);
+int32_t dw3000_spi_write_crc_ex(uint8_t inst, uint16_t headerLength,
+								const uint8_t* headerBuffer,
+								uint16_t bodyLength,
+								const uint8_t* bodyBuffer, uint8_t crc8);
+int32_t dw3000_spi_xfer_batch_ex(uint8_t inst,
+								 const struct dwt_spi_xfer_s* xfers,
+								 uint16_t count);
+#if CONFIG_DW3000_SPI_ASYNC
+int32_t dw3000_spi_read_async(uint16_t headerLength, uint8_t* headerBuffer,
+							  uint16_t readLength, uint8_t* readBuffer,
+							  dwt_spi_done_cb_t cb, void* user_data);
+int32_t dw3000_spi_write_async(uint16_t headerLength,
+							   const uint8_t* headerBuffer, uint16_t bodyLength,
+							   const uint8_t* bodyBuffer, dwt_spi_done_cb_t cb,
+							   void* user_data);
+int32_t dw3000_spi_wait_async(void);
+int32_t dw3000_spi_read_async_ex(uint8_t inst, uint16_t headerLength,
+								 uint8_t* headerBuffer, uint16_t readLength,
+								 uint8_t* readBuffer, dwt_spi_done_cb_t cb,
+								 void* user_data);
+int32_t dw3000_spi_write_async_ex(uint8_t inst, uint16_t headerLength,
+								  const uint8_t* headerBuffer,
+								  uint16_t bodyLength,
+								  const uint8_t* bodyBuffer,
+								  dwt_spi_done_cb_t cb, void* user_data);
+int32_t dw3000_spi_wait_async_ex(uint8_t inst);
+#endif
+
+/* SPI trace, see CONFIG_DW3000_SPI_TRACE */
+#define DW3000_SPI_TRACE_READ  0x01
+#define DW3000_SPI_TRACE_HDR2  0x02 /* two byte header */
+#define DW3000_SPI_TRACE_CRC   0x04 /* write with SPI CRC byte */
+#define DW3000_SPI_TRACE_ASYNC 0x08
+#define DW3000_SPI_TRACE_ERROR 0x80 /* the transfer failed */
+
+#if CONFIG_DW3000_SPI_TRACE
+static inline uint32_t dw3000_spi_trace_start(void)
+{
+	return k_cycle_get_32();
+}
+
+/* record a transaction which started at the cycle count start */
+void dw3000_spi_trace_in(uint8_t flags, const uint8_t* headerBuffer,
+						 uint16_t headerLength, const uint8_t* bodyBuffer,
+						 uint16_t bodyLength, uint32_t start);
+#else
+static inline uint32_t dw3000_spi_trace_start(void)
+{
+	return 0;
+}
+
+static inline void dw3000_spi_trace_in(uint8_t flags,
+									   const uint8_t* headerBuffer,
+									   uint16_t headerLength,
+									   const uint8_t* bodyBuffer,
+									   uint16_t bodyLength, uint32_t start)
+{
+}
+#endif
 
+/* log the trace ring, when it is not exported in the background */
 void dw3000_spi_trace_output(void);
 
 #endif
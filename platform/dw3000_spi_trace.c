@@ -1,40 +1,58 @@
 #include <stdbool.h>
 #include <stdio.h>
 #include <string.h>
+#include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
 
 #include "dw3000_spi.h"
 
-#if CONFIG_DW3000_SPI_TRACE
+/* This file implements a lock-free trace ring of the SPI transactions */
 
-LOG_MODULE_REGISTER(dw3000, CONFIG_DW3000_LOG_LEVEL);
+#if CONFIG_DW3000_SPI_TRACE
 
-// Real-time output (normally too slow)
-#ifndef CONFIG_DW3000_SPI_TRACE_REALTIME
-#define CONFIG_DW3000_SPI_TRACE_REALTIME 0
+#if CONFIG_DW3000_SPI_TRACE_EXPORT_RTT
+#include <SEGGER_RTT.h>
 #endif
-
-#ifndef CONFIG_DW3000_SPI_TRACE_CNT
-#define CONFIG_DW3000_SPI_TRACE_CNT 256
+#if CONFIG_DW3000_SPI_TRACE_EXPORT_UART
+#include <zephyr/drivers/uart.h>
 #endif
-
-#ifndef CONFIG_DW3000_SPI_TRACE_BODY_LEN
-#define CONFIG_DW3000_SPI_TRACE_BODY_LEN 12
+#if CONFIG_DW3000_SPI_TRACE_EXPORT_RTT || CONFIG_DW3000_SPI_TRACE_EXPORT_UART
+#include <zephyr/sys/byteorder.h>
+#define DW3000_SPI_TRACE_EXPORT 1
 #endif
+#define DW3000_SPI_TRACE_LOG                                                   \
+	(CONFIG_DW3000_SPI_TRACE_REALTIME || !DW3000_SPI_TRACE_EXPORT)
+
+LOG_MODULE_DECLARE(dw3000, CONFIG_DW3000_LOG_LEVEL);
 
 #define DW3000_SPI_TRACE_RAW 0
 
+BUILD_ASSERT((CONFIG_DW3000_SPI_TRACE_CNT & (CONFIG_DW3000_SPI_TRACE_CNT - 1))
+				 == 0,
+			 "CONFIG_DW3000_SPI_TRACE_CNT has to be a power of two");
+
+#define TRACE_MASK (CONFIG_DW3000_SPI_TRACE_CNT - 1)
+
 struct spi_dbg {
-	bool rw;
+	uint32_t seq; /* index + 1, 0 while the entry is written */
+	uint32_t start;
+	uint32_t cycles;
+	uint16_t len;
+	uint8_t flags;
 	uint8_t hdr[2];
-	uint8_t hdr_len;
-	uint8_t bdy[CONFIG_DW3000_SPI_TRACE_BODY_LEN];
 	uint8_t bdy_len;
+	uint8_t bdy[CONFIG_DW3000_SPI_TRACE_BODY_LEN];
 };
 
+/* Writers reserve an entry by incrementing dbgs_head and publish it by
+ * setting its seq last. When the ring is full the oldest entries are
+ * overwritten, the single reader detects this from seq and skips them. */
 static struct spi_dbg dbgs[CONFIG_DW3000_SPI_TRACE_CNT];
-static int dbgs_cnt;
+static atomic_t dbgs_head;
+static uint32_t dbgs_tail;
+static uint32_t dbgs_lost;
 
+#if DW3000_SPI_TRACE_LOG
 static char* spi_dbg_out_reg(const char* prefix, bool rw,
 							 const uint8_t* headerBuffer, uint16_t headerLength)
 {
@@ -83,70 +101,264 @@ static char* spi_dbg_out_reg(const char* prefix, bool rw,
 	return buf;
 }
 
-void dw3000_spi_trace_in(bool rw, const uint8_t* headerBuffer,
+static void spi_dbg_log(const struct spi_dbg* d)
+{
+	bool rw = d->flags & DW3000_SPI_TRACE_READ;
+	uint16_t hdr_len = (d->flags & DW3000_SPI_TRACE_HDR2) ? 2 : 1;
+	char* s = spi_dbg_out_reg(NULL, rw, d->hdr, hdr_len);
+
+	if (d->bdy_len) {
+		LOG_HEXDUMP_INF(d->bdy, d->bdy_len, s);
+	} else {
+		LOG_INF("%s", s);
+	}
+	LOG_INF("   len %d at %u +%uus%s", d->len,
+			k_cyc_to_us_floor32(d->start), k_cyc_to_us_floor32(d->cycles),
+			(d->flags & DW3000_SPI_TRACE_ERROR) ? " ERR" : "");
+}
+#endif
+
+void dw3000_spi_trace_in(uint8_t flags, const uint8_t* headerBuffer,
 						 uint16_t headerLength, const uint8_t* bodyBuffer,
-						 uint16_t bodyLength)
+						 uint16_t bodyLength, uint32_t start)
 {
+	uint32_t end = k_cycle_get_32();
+	uint32_t idx = (uint32_t)atomic_inc(&dbgs_head);
+	struct spi_dbg* d = &dbgs[idx & TRACE_MASK];
+
 #if DW3000_SPI_TRACE_RAW
-	LOG_INF("---SPI #%d %s hdrlen %d bodylen %d", dbgs_cnt,
-			rw ? "READ" : "WRITE", headerLength, bodyLength);
-	LOG_HEXDUMP("   SPI HEADER: ", headerBuffer, headerLength);
-	LOG_HEXDUMP("   SPI BODY: ", bodyBuffer, bodyLength);
+	LOG_INF("---SPI #%d %s hdrlen %d bodylen %d", idx,
+			(flags & DW3000_SPI_TRACE_READ) ? "READ" : "WRITE", headerLength,
+			bodyLength);
+	LOG_HEXDUMP_INF(headerBuffer, headerLength, "   SPI HEADER: ");
+	LOG_HEXDUMP_INF(bodyBuffer, bodyLength, "   SPI BODY: ");
 #endif
 
-	if (dbgs_cnt >= CONFIG_DW3000_SPI_TRACE_CNT) {
-		LOG_ERR("ERR not enough debug space");
-		return;
-	}
-
-	dbgs[dbgs_cnt].rw = rw;
+	d->seq = 0;
+	__atomic_thread_fence(__ATOMIC_RELEASE);
 
-	if (headerLength <= 2) {
-		memcpy(dbgs[dbgs_cnt].hdr, headerBuffer, headerLength);
-	} else {
-		LOG_ERR("ERR hdr len %d", headerLength);
+	if (headerLength == 2) {
+		flags |= DW3000_SPI_TRACE_HDR2;
 	}
+	d->flags = flags;
+	d->start = start;
+	d->cycles = end - start;
+	d->len = bodyLength;
+	d->hdr[0] = headerBuffer[0];
+	d->hdr[1] = headerLength > 1 ? headerBuffer[1] : 0;
 
-	dbgs[dbgs_cnt].hdr_len = headerLength;
 	if (bodyLength > CONFIG_DW3000_SPI_TRACE_BODY_LEN) {
-		// LOG_ERR("ERR bdy len %d at #%d", bodyLength, dbgs_cnt);
 		bodyLength = CONFIG_DW3000_SPI_TRACE_BODY_LEN;
 	}
-	memcpy(dbgs[dbgs_cnt].bdy, bodyBuffer, bodyLength);
-	dbgs[dbgs_cnt].bdy_len = bodyLength;
+	if (bodyLength > 0) {
+		memcpy(d->bdy, bodyBuffer, bodyLength);
+	}
+	d->bdy_len = bodyLength;
+
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	d->seq = idx + 1;
 
 #if CONFIG_DW3000_SPI_TRACE_REALTIME
-	if (dbgs[dbgs_cnt].bdy_len) {
-		char* s = spi_dbg_out_reg(LOG_TAG, dbgs[dbgs_cnt].rw,
-								  dbgs[dbgs_cnt].hdr, dbgs[dbgs_cnt].hdr_len);
-		LOG_HEXDUMP(s, dbgs[dbgs_cnt].bdy, dbgs[dbgs_cnt].bdy_len);
-	} else {
-		char* s = spi_dbg_out_reg(NULL, dbgs[dbgs_cnt].rw, dbgs[dbgs_cnt].hdr,
-								  dbgs[dbgs_cnt].hdr_len);
-		LOG_INF("%s", s);
+	spi_dbg_log(d);
+#endif
+}
+
+/** get the oldest entry from the ring, only one reader is allowed */
+static bool spi_dbg_get(struct spi_dbg* out)
+{
+	while (true) {
+		uint32_t head = (uint32_t)atomic_get(&dbgs_head);
+		const struct spi_dbg* d;
+		uint32_t seq;
+
+		if (head - dbgs_tail > CONFIG_DW3000_SPI_TRACE_CNT) {
+			dbgs_lost += head - dbgs_tail - CONFIG_DW3000_SPI_TRACE_CNT;
+			dbgs_tail = head - CONFIG_DW3000_SPI_TRACE_CNT;
+		}
+
+		if (dbgs_tail == head) {
+			return false;
+		}
+
+		d = &dbgs[dbgs_tail & TRACE_MASK];
+		seq = d->seq;
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if (seq == 0 || (int32_t)(seq - (dbgs_tail + 1)) < 0) {
+			/* still being written */
+			return false;
+		}
+
+		if (seq == dbgs_tail + 1) {
+			memcpy(out, d, sizeof(*out));
+			__atomic_thread_fence(__ATOMIC_ACQUIRE);
+			if (d->seq == seq) {
+				dbgs_tail++;
+				return true;
+			}
+		}
+
+		/* overwritten by a newer entry */
+		dbgs_lost++;
+		dbgs_tail++;
 	}
+}
+
+#if DW3000_SPI_TRACE_EXPORT
+
+/* Binary export format, all values little endian. Every frame starts with
+ * TRACE_SYNC and its type:
+ *   XFER: flags, hdr[2], len (16 bit), bdy_len, start (32 bit cycles),
+ *         duration (32 bit cycles), bdy[bdy_len]
+ *   LOST: number of entries lost (32 bit)
+ *   INFO: cycles per second (32 bit), format version
+ * scripts/dw3000_spi_trace.py decodes it. */
+#define TRACE_SYNC		0xD3
+#define TRACE_XFER		0x01
+#define TRACE_LOST		0x02
+#define TRACE_INFO		0x03
+#define TRACE_VERSION	1
+#define TRACE_XFER_SIZE	16
+
+/* time between ring drains, and INFO frames every this many drains */
+#define TRACE_EXPORT_INTERVAL_MS 10
+#define TRACE_EXPORT_INFO_CNT	 100
+
+#if CONFIG_DW3000_SPI_TRACE_EXPORT_RTT
+static uint8_t trace_rtt_buf[CONFIG_DW3000_SPI_TRACE_RTT_BUF_SIZE];
+
+static bool trace_export_init(void)
+{
+	SEGGER_RTT_ConfigUpBuffer(CONFIG_DW3000_SPI_TRACE_RTT_CHANNEL,
+							  "DW3000 SPI", trace_rtt_buf,
+							  sizeof(trace_rtt_buf),
+							  SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+	return true;
+}
+
+static bool trace_export_write(const uint8_t* buf, size_t len)
+{
+	/* whole frame or nothing */
+	return SEGGER_RTT_Write(CONFIG_DW3000_SPI_TRACE_RTT_CHANNEL, buf, len)
+		   == len;
+}
+#else
+static const struct device* const trace_uart
+	= DEVICE_DT_GET(DT_CHOSEN(dw3000_trace_uart));
+
+static bool trace_export_init(void)
+{
+	if (!device_is_ready(trace_uart)) {
+		LOG_ERR("DW3000 SPI trace UART not ready");
+		return false;
+	}
+	return true;
+}
+
+static bool trace_export_write(const uint8_t* buf, size_t len)
+{
+	for (size_t i = 0; i < len; i++) {
+		uart_poll_out(trace_uart, buf[i]);
+	}
+	return true;
+}
 #endif
 
-	dbgs_cnt++;
+static void trace_export_info(void)
+{
+	uint8_t buf[7];
+
+	buf[0] = TRACE_SYNC;
+	buf[1] = TRACE_INFO;
+	sys_put_le32(sys_clock_hw_cycles_per_sec(), &buf[2]);
+	buf[6] = TRACE_VERSION;
+	trace_export_write(buf, sizeof(buf));
 }
 
+static void trace_export_lost(uint32_t lost)
+{
+	uint8_t buf[6];
+
+	buf[0] = TRACE_SYNC;
+	buf[1] = TRACE_LOST;
+	sys_put_le32(lost, &buf[2]);
+	if (!trace_export_write(buf, sizeof(buf))) {
+		dbgs_lost += lost;
+	}
+}
+
+static void trace_export_xfer(const struct spi_dbg* d)
+{
+	uint8_t buf[TRACE_XFER_SIZE + CONFIG_DW3000_SPI_TRACE_BODY_LEN];
+
+	buf[0] = TRACE_SYNC;
+	buf[1] = TRACE_XFER;
+	buf[2] = d->flags;
+	buf[3] = d->hdr[0];
+	buf[4] = d->hdr[1];
+	sys_put_le16(d->len, &buf[5]);
+	buf[7] = d->bdy_len;
+	sys_put_le32(d->start, &buf[8]);
+	sys_put_le32(d->cycles, &buf[12]);
+	memcpy(&buf[TRACE_XFER_SIZE], d->bdy, d->bdy_len);
+	if (!trace_export_write(buf, TRACE_XFER_SIZE + d->bdy_len)) {
+		dbgs_lost++;
+	}
+}
+
+static void trace_export_thread(void* p1, void* p2, void* p3)
+{
+	struct spi_dbg d;
+	uint32_t lost;
+	int cnt = 0;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	if (!trace_export_init()) {
+		return;
+	}
+
+	while (true) {
+		if (cnt-- == 0) {
+			trace_export_info();
+			cnt = TRACE_EXPORT_INFO_CNT;
+		}
+
+		while (spi_dbg_get(&d)) {
+			trace_export_xfer(&d);
+		}
+
+		if (dbgs_lost > 0) {
+			lost = dbgs_lost;
+			dbgs_lost = 0;
+			trace_export_lost(lost);
+		}
+
+		k_sleep(K_MSEC(TRACE_EXPORT_INTERVAL_MS));
+	}
+}
+
+K_THREAD_DEFINE(dw3000_spi_trace_thread, CONFIG_DW3000_SPI_TRACE_STACK_SIZE,
+				trace_export_thread, NULL, NULL, NULL,
+				K_LOWEST_APPLICATION_THREAD_PRIO, 0, 0);
+#endif
+
 #endif
 
 void dw3000_spi_trace_output(void)
 {
-#if CONFIG_DW3000_SPI_TRACE
+#if CONFIG_DW3000_SPI_TRACE && !DW3000_SPI_TRACE_EXPORT
+	struct spi_dbg d;
+
 	LOG_INF("--- SPI DBG START");
-	for (int i = 0; i < CONFIG_DW3000_SPI_TRACE_CNT && i < dbgs_cnt; i++) {
-		struct spi_dbg* d = &dbgs[i];
-		if (d->bdy_len) {
-			char* s = spi_dbg_out_reg(LOG_TAG, d->rw, d->hdr, d->hdr_len);
-			LOG_HEXDUMP(s, d->bdy, d->bdy_len);
-		} else {
-			char* s = spi_dbg_out_reg(NULL, d->rw, d->hdr, d->hdr_len);
-			LOG_INF("%s", s);
-		}
+	while (spi_dbg_get(&d)) {
+		spi_dbg_log(&d);
+	}
+	if (dbgs_lost > 0) {
+		LOG_INF("--- %u lost", dbgs_lost);
+		dbgs_lost = 0;
 	}
-	dbgs_cnt = 0;
 	LOG_INF("--- SPI DBG END");
 #endif
 }
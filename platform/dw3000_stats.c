@@ -0,0 +1,283 @@
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/stats/stats.h>
+#if CONFIG_SHELL
+#include <zephyr/shell/shell.h>
+#endif
+
+#include "deca_device_api.h"
+#include "dw3000_hw.h"
+#include "dw3000_stats.h"
+
+/* This file implements the runtime SPI and ISR performance counters */
+
+LOG_MODULE_DECLARE(dw3000, CONFIG_DW3000_LOG_LEVEL);
+
+STATS_SECT_START(dw3000)
+STATS_SECT_ENTRY32(spi_xfers)
+STATS_SECT_ENTRY32(spi_bytes)
+STATS_SECT_ENTRY32(spi_errors)
+STATS_SECT_ENTRY32(spi_crc_errors)
+STATS_SECT_ENTRY32(spi_err_events)
+STATS_SECT_ENTRY32(irq_edges)
+STATS_SECT_ENTRY32(irq_coalesced)
+STATS_SECT_ENTRY32(irq_backlog_max)
+STATS_SECT_ENTRY32(isr_count)
+STATS_SECT_ENTRY32(isr_latency_max_us)
+STATS_SECT_ENTRY32(cb_time_max_us)
+STATS_SECT_END;
+
+STATS_NAME_START(dw3000)
+STATS_NAME(dw3000, spi_xfers)
+STATS_NAME(dw3000, spi_bytes)
+STATS_NAME(dw3000, spi_errors)
+STATS_NAME(dw3000, spi_crc_errors)
+STATS_NAME(dw3000, spi_err_events)
+STATS_NAME(dw3000, irq_edges)
+STATS_NAME(dw3000, irq_coalesced)
+STATS_NAME(dw3000, irq_backlog_max)
+STATS_NAME(dw3000, isr_count)
+STATS_NAME(dw3000, isr_latency_max_us)
+STATS_NAME(dw3000, cb_time_max_us)
+STATS_NAME_END(dw3000);
+
+static STATS_SECT_DECL(dw3000) dw3000_stats;
+static bool stats_initialized;
+static int64_t stats_since;
+
+static struct dw3000_stats_time isr_latency;
+static struct dw3000_stats_time isr_time;
+static struct dw3000_stats_time cb_latency;
+static struct dw3000_stats_time cb_time;
+
+/* IRQ edges per instance which were not handled by dwt_isr() yet and the
+ * time of the first of them */
+static atomic_t irq_pending[DW3000_NUM_INST];
+static uint32_t irq_edge[DW3000_NUM_INST];
+
+/* edge and start time of the running dwt_isr() */
+static uint32_t isr_edge;
+static uint32_t isr_start;
+
+static dwt_callbacks_s app_cbs[DW3000_NUM_INST];
+
+static void stats_time_add(struct dw3000_stats_time* t, uint32_t cycles)
+{
+	uint32_t us = k_cyc_to_us_floor32(cycles);
+	int idx = 0;
+
+	if (t->cnt == 0 || us < t->min_us) {
+		t->min_us = us;
+	}
+	if (us > t->max_us) {
+		t->max_us = us;
+	}
+	t->cnt++;
+	t->sum_us += us;
+
+	for (uint32_t lim = 16; us >= lim && idx < DW3000_STATS_HIST_LEN - 1;
+		 lim <<= 1) {
+		idx++;
+	}
+	t->hist[idx]++;
+}
+
+void dw3000_stats_init(void)
+{
+	if (stats_initialized) {
+		return;
+	}
+
+	stats_init(&dw3000_stats.s_hdr, STATS_SIZE_32, 11,
+			   STATS_NAME_INIT_PARMS(dw3000));
+	stats_register("dw3000", &dw3000_stats.s_hdr);
+	stats_since = k_uptime_get();
+	stats_initialized = true;
+}
+
+void dw3000_stats_reset(void)
+{
+	stats_reset(&dw3000_stats.s_hdr);
+	memset(&isr_latency, 0, sizeof(isr_latency));
+	memset(&isr_time, 0, sizeof(isr_time));
+	memset(&cb_latency, 0, sizeof(cb_latency));
+	memset(&cb_time, 0, sizeof(cb_time));
+	stats_since = k_uptime_get();
+}
+
+void dw3000_stats_spi(uint32_t len, int ret)
+{
+	STATS_INC(dw3000_stats, spi_xfers);
+	STATS_INCN(dw3000_stats, spi_bytes, len);
+	if (ret != 0) {
+		STATS_INC(dw3000_stats, spi_errors);
+	}
+}
+
+void dw3000_stats_spi_crc_err(void)
+{
+	STATS_INC(dw3000_stats, spi_crc_errors);
+}
+
+/** called from the GPIO interrupt, queued is false if the previous edge was
+ * not handled yet */
+void dw3000_stats_irq(uint8_t inst, bool queued)
+{
+	uint32_t now = k_cycle_get_32();
+	uint32_t backlog = (uint32_t)atomic_inc(&irq_pending[inst]) + 1;
+
+	if (backlog == 1) {
+		irq_edge[inst] = now;
+	}
+	if (backlog > dw3000_stats.irq_backlog_max) {
+		dw3000_stats.irq_backlog_max = backlog;
+	}
+
+	STATS_INC(dw3000_stats, irq_edges);
+	if (!queued) {
+		STATS_INC(dw3000_stats, irq_coalesced);
+	}
+}
+
+void dw3000_stats_isr_start(uint8_t inst)
+{
+	isr_start = k_cycle_get_32();
+	isr_edge = irq_edge[inst];
+
+	if (atomic_set(&irq_pending[inst], 0) == 0) {
+		/* not started by an IRQ edge */
+		isr_edge = isr_start;
+	}
+
+	STATS_INC(dw3000_stats, isr_count);
+	stats_time_add(&isr_latency, isr_start - isr_edge);
+	dw3000_stats.isr_latency_max_us = isr_latency.max_us;
+}
+
+void dw3000_stats_isr_end(void)
+{
+	stats_time_add(&isr_time, k_cycle_get_32() - isr_start);
+}
+
+static void stats_cb_run(dwt_cb_t cb, const dwt_cb_data_t* cb_data)
+{
+	uint32_t start = k_cycle_get_32();
+
+	stats_time_add(&cb_latency, start - isr_edge);
+	cb(cb_data);
+	stats_time_add(&cb_time, k_cycle_get_32() - start);
+	dw3000_stats.cb_time_max_us = cb_time.max_us;
+}
+
+#define DW3000_STATS_CB(name)                                                  \
+	static void stats_##name(const dwt_cb_data_t* cb_data)                     \
+	{                                                                          \
+		stats_cb_run(app_cbs[dw3000_hw_selected()].name, cb_data);             \
+	}
+
+DW3000_STATS_CB(cbTxDone)
+DW3000_STATS_CB(cbRxOk)
+DW3000_STATS_CB(cbRxTo)
+DW3000_STATS_CB(cbRxErr)
+DW3000_STATS_CB(cbSPIRdy)
+DW3000_STATS_CB(cbCiaDone)
+
+static void stats_cbSPIErr(const dwt_cb_data_t* cb_data)
+{
+	dwt_cb_t cb = app_cbs[dw3000_hw_selected()].cbSPIErr;
+
+	STATS_INC(dw3000_stats, spi_err_events);
+	if (cb != NULL) {
+		stats_cb_run(cb, cb_data);
+	}
+}
+
+/**
+ * dwt_setcallbacks() with the callbacks wrapped to measure their latency
+ * and run time, and to count SPI error events
+ */
+void dw3000_stats_setcallbacks(dwt_callbacks_s* callbacks)
+{
+	dwt_callbacks_s* app = &app_cbs[dw3000_hw_selected()];
+	dwt_callbacks_s cbs = *callbacks;
+
+	*app = *callbacks;
+	cbs.cbTxDone = app->cbTxDone ? stats_cbTxDone : NULL;
+	cbs.cbRxOk = app->cbRxOk ? stats_cbRxOk : NULL;
+	cbs.cbRxTo = app->cbRxTo ? stats_cbRxTo : NULL;
+	cbs.cbRxErr = app->cbRxErr ? stats_cbRxErr : NULL;
+	cbs.cbSPIRdy = app->cbSPIRdy ? stats_cbSPIRdy : NULL;
+	cbs.cbCiaDone = app->cbCiaDone ? stats_cbCiaDone : NULL;
+	cbs.cbSPIErr = stats_cbSPIErr;
+	dwt_setcallbacks(&cbs);
+}
+
+#if CONFIG_SHELL
+static void stats_time_print(const struct shell* sh, const char* name,
+							 const struct dw3000_stats_time* t)
+{
+	shell_print(sh,
+				"%-12s %8u %6u %6u %6u | %6u %6u %6u %6u %6u %6u %6u %6u",
+				name, t->cnt, t->min_us,
+				t->cnt ? (uint32_t)(t->sum_us / t->cnt) : 0, t->max_us,
+				t->hist[0], t->hist[1], t->hist[2], t->hist[3], t->hist[4],
+				t->hist[5], t->hist[6], t->hist[7]);
+}
+
+static int cmd_dw3000_stats(const struct shell* sh, size_t argc, char** argv)
+{
+	int64_t secs = (k_uptime_get() - stats_since) / 1000;
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	if (secs == 0) {
+		secs = 1;
+	}
+
+	shell_print(sh, "SPI: %u xfers (%u/s), %u bytes (%u/s), %u errors",
+				dw3000_stats.spi_xfers,
+				(uint32_t)(dw3000_stats.spi_xfers / secs),
+				dw3000_stats.spi_bytes,
+				(uint32_t)(dw3000_stats.spi_bytes / secs),
+				dw3000_stats.spi_errors);
+	shell_print(sh, "SPI CRC errors: %u read, %u error events",
+				dw3000_stats.spi_crc_errors, dw3000_stats.spi_err_events);
+	shell_print(sh, "IRQ: %u edges, %u coalesced, max backlog %u, %u ISR runs",
+				dw3000_stats.irq_edges, dw3000_stats.irq_coalesced,
+				dw3000_stats.irq_backlog_max, dw3000_stats.isr_count);
+	shell_print(sh,
+				"%-12s %8s %6s %6s %6s | %6s %6s %6s %6s %6s %6s %6s %6s",
+				"us", "count", "min", "avg", "max", "<16", "<32", "<64",
+				"<128", "<256", "<512", "<1024", ">=1024");
+	stats_time_print(sh, "isr latency", &isr_latency);
+	stats_time_print(sh, "isr time", &isr_time);
+	stats_time_print(sh, "cb latency", &cb_latency);
+	stats_time_print(sh, "cb time", &cb_time);
+	return 0;
+}
+
+static int cmd_dw3000_stats_reset(const struct shell* sh, size_t argc,
+								  char** argv)
+{
+	ARG_UNUSED(sh);
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	dw3000_stats_reset();
+	return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(dw3000_stats_cmds,
+							   SHELL_CMD(reset, NULL, "Reset the counters",
+										 cmd_dw3000_stats_reset),
+							   SHELL_SUBCMD_SET_END);
+
+SHELL_STATIC_SUBCMD_SET_CREATE(dw3000_cmds,
+							   SHELL_CMD(stats, &dw3000_stats_cmds,
+										 "SPI and ISR performance counters",
+										 cmd_dw3000_stats),
+							   SHELL_SUBCMD_SET_END);
+
+SHELL_CMD_REGISTER(dw3000, &dw3000_cmds, "DW3000 driver", NULL);
+#endif
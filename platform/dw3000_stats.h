@@ -0,0 +1,86 @@
+#ifndef DW3000_STATS_H
+#define DW3000_STATS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "deca_device_api.h"
+
+/*
+ * Runtime performance counters (CONFIG_DW3000_STATS): SPI transactions,
+ * bytes and errors, IRQ edges and how many were coalesced before dwt_isr()
+ * ran, and min/max/histograms of
+ *
+ *   isr_latency: IRQ edge to the start of dwt_isr()
+ *   isr_time:    run time of dwt_isr(), including the callbacks
+ *   cb_latency:  IRQ edge to the start of a callback
+ *   cb_time:     run time of the callbacks
+ *
+ * The counters are a Zephyr stats group "dw3000" (see "stats show"), and
+ * together with the histograms printed by the "dw3000 stats" shell command.
+ *
+ * The callback times are only measured for callbacks set with
+ * dw3000_stats_setcallbacks() instead of dwt_setcallbacks(). SPI CRC errors
+ * of read transactions are counted when dw3000_stats_spi_crc_err() is the
+ * callback of dwt_enablespicrccheck() or is called from it.
+ */
+
+/* histogram buckets in us: <16, <32, ..., <1024, >=1024 */
+#define DW3000_STATS_HIST_LEN 8
+
+struct dw3000_stats_time {
+	uint32_t cnt;
+	uint32_t min_us;
+	uint32_t max_us;
+	uint64_t sum_us;
+	uint32_t hist[DW3000_STATS_HIST_LEN];
+};
+
+#if CONFIG_DW3000_STATS
+void dw3000_stats_init(void);
+void dw3000_stats_reset(void);
+
+void dw3000_stats_setcallbacks(dwt_callbacks_s* callbacks);
+void dw3000_stats_spi_crc_err(void);
+
+/* hooks of the platform code */
+void dw3000_stats_spi(uint32_t len, int ret);
+void dw3000_stats_irq(uint8_t inst, bool queued);
+void dw3000_stats_isr_start(uint8_t inst);
+void dw3000_stats_isr_end(void);
+#else
+static inline void dw3000_stats_init(void)
+{
+}
+
+static inline void dw3000_stats_reset(void)
+{
+}
+
+static inline void dw3000_stats_setcallbacks(dwt_callbacks_s* callbacks)
+{
+	dwt_setcallbacks(callbacks);
+}
+
+static inline void dw3000_stats_spi_crc_err(void)
+{
+}
+
+static inline void dw3000_stats_spi(uint32_t len, int ret)
+{
+}
+
+static inline void dw3000_stats_irq(uint8_t inst, bool queued)
+{
+}
+
+static inline void dw3000_stats_isr_start(uint8_t inst)
+{
+}
+
+static inline void dw3000_stats_isr_end(void)
+{
+}
+#endif
+
+#endif
@@ -0,0 +1,289 @@
+#include <zephyr/device.h>
+#include <zephyr/drivers/counter.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/pm/device_runtime.h>
+
+#include "deca_device_api.h"
+#include "deca_probe_interface.h"
+#include "dw3000_hw.h"
+#include "dw3000_timer.h"
+
+/* This file provides the DW3720 TIMER0/1 as Zephyr counter device */
+
+LOG_MODULE_DECLARE(dw3000, CONFIG_DW3000_LOG_LEVEL);
+
+#define DT_DRV_COMPAT decawave_dw3000
+
+#define DW3000_TIMER_FREQ (38400000U >> CONFIG_DW3000_TIMER_DIV)
+
+/* the alarm channel runs on TIMER0, the top value on TIMER1 */
+#define DW3000_TIMER_ALARM DWT_TIMER0
+#define DW3000_TIMER_TOP   DWT_TIMER1
+#define DW3000_TIMER_INT_ALARM ((uint32_t)DWT_INT_TIMER0_BIT_MASK)
+#define DW3000_TIMER_INT_TOP   ((uint32_t)DWT_INT_TIMER1_BIT_MASK)
+
+struct dw3000_timer_config {
+	struct counter_config_info info; /* has to be first */
+	uint8_t inst;
+	const struct device* dw3000;
+};
+
+struct dw3000_timer_data {
+	bool running;
+	counter_alarm_callback_t alarm_cb;
+	void* alarm_user_data;
+	uint32_t alarm_ticks;
+	counter_top_callback_t top_cb;
+	void* top_user_data;
+	uint32_t top_ticks;
+};
+
+static const struct device* timer_devs[CONFIG_DW3000_NUM_INSTANCES];
+
+const struct device* dw3000_timer_get(uint8_t inst)
+{
+	return inst < CONFIG_DW3000_NUM_INSTANCES ? timer_devs[inst] : NULL;
+}
+
+/** (re)start a timer which was configured by dw3000_timer_start() */
+static void dw3000_timer_run(dwt_timers_e timer, uint32_t int_mask,
+							 uint32_t ticks)
+{
+	/* an expiry while the interrupt was disabled would still be pending */
+	dwt_writesysstatuslo(int_mask);
+	dwt_set_timer_expiration(timer, ticks);
+	dwt_timer_enable(timer);
+	dwt_setinterrupt(int_mask, 0, DWT_ENABLE_INT);
+}
+
+static void dw3000_timer_configure(dwt_timers_e timer, dwt_timer_mode_e mode)
+{
+	dwt_timer_cfg_t tim_cfg = {
+		.timer = timer,
+		.timer_div = (dwt_timer_period_e)CONFIG_DW3000_TIMER_DIV,
+		.timer_mode = mode,
+	};
+
+	dwt_configure_timer(&tim_cfg);
+}
+
+static int dw3000_timer_start(const struct device* dev)
+{
+	const struct dw3000_timer_config* cfg = dev->config;
+	struct dw3000_timer_data* data = dev->data;
+
+	if (data->running) {
+		return 0;
+	}
+
+	(void)pm_device_runtime_get(cfg->dw3000);
+
+	dw3000_lock(cfg->inst);
+	dwt_timers_reset();
+	dw3000_timer_configure(DW3000_TIMER_ALARM, DWT_TIM_SINGLE);
+	dw3000_timer_configure(DW3000_TIMER_TOP, DWT_TIM_REPEAT);
+	data->running = true;
+	if (data->top_cb != NULL) {
+		dw3000_timer_run(DW3000_TIMER_TOP, DW3000_TIMER_INT_TOP,
+						 data->top_ticks);
+	}
+	dw3000_unlock(cfg->inst);
+
+	return 0;
+}
+
+static int dw3000_timer_stop(const struct device* dev)
+{
+	const struct dw3000_timer_config* cfg = dev->config;
+	struct dw3000_timer_data* data = dev->data;
+
+	if (!data->running) {
+		return 0;
+	}
+
+	dw3000_lock(cfg->inst);
+	dwt_setinterrupt(DW3000_TIMER_INT_ALARM | DW3000_TIMER_INT_TOP, 0,
+					 DWT_DISABLE_INT);
+	dwt_timers_reset();
+	data->running = false;
+	data->alarm_cb = NULL;
+	dw3000_unlock(cfg->inst);
+
+	(void)pm_device_runtime_put(cfg->dw3000);
+	return 0;
+}
+
+static int dw3000_timer_get_value(const struct device* dev, uint32_t* ticks)
+{
+	/* the DW3720 has no readable timer count */
+	return -ENOTSUP;
+}
+
+static int dw3000_timer_set_alarm(const struct device* dev, uint8_t chan_id,
+								  const struct counter_alarm_cfg* alarm_cfg)
+{
+	const struct dw3000_timer_config* cfg = dev->config;
+	struct dw3000_timer_data* data = dev->data;
+	int ret = 0;
+
+	if (alarm_cfg->flags & COUNTER_ALARM_CFG_ABSOLUTE) {
+		return -ENOTSUP;
+	}
+
+	if (alarm_cfg->ticks == 0 || alarm_cfg->ticks > DW3000_TIMER_MAX_TICKS) {
+		return -EINVAL;
+	}
+
+	dw3000_lock(cfg->inst);
+	if (!data->running) {
+		ret = -EINVAL;
+	} else if (data->alarm_cb != NULL) {
+		ret = -EBUSY;
+	} else {
+		data->alarm_cb = alarm_cfg->callback;
+		data->alarm_user_data = alarm_cfg->user_data;
+		data->alarm_ticks = alarm_cfg->ticks;
+		dw3000_timer_run(DW3000_TIMER_ALARM, DW3000_TIMER_INT_ALARM,
+						 alarm_cfg->ticks);
+	}
+	dw3000_unlock(cfg->inst);
+
+	return ret;
+}
+
+static int dw3000_timer_cancel_alarm(const struct device* dev, uint8_t chan_id)
+{
+	const struct dw3000_timer_config* cfg = dev->config;
+	struct dw3000_timer_data* data = dev->data;
+
+	dw3000_lock(cfg->inst);
+	if (data->running) {
+		dwt_setinterrupt(DW3000_TIMER_INT_ALARM, 0, DWT_DISABLE_INT);
+	}
+	data->alarm_cb = NULL;
+	dw3000_unlock(cfg->inst);
+
+	return 0;
+}
+
+static int dw3000_timer_set_top_value(const struct device* dev,
+									  const struct counter_top_cfg* top_cfg)
+{
+	const struct dw3000_timer_config* cfg = dev->config;
+	struct dw3000_timer_data* data = dev->data;
+
+	/* the period always restarts */
+	if (top_cfg->flags & COUNTER_TOP_CFG_DONT_RESET) {
+		return -ENOTSUP;
+	}
+
+	if (top_cfg->ticks == 0 || top_cfg->ticks > DW3000_TIMER_MAX_TICKS) {
+		return -EINVAL;
+	}
+
+	dw3000_lock(cfg->inst);
+	data->top_cb = top_cfg->callback;
+	data->top_user_data = top_cfg->user_data;
+	data->top_ticks = top_cfg->ticks;
+	if (data->running) {
+		if (data->top_cb != NULL) {
+			dw3000_timer_run(DW3000_TIMER_TOP, DW3000_TIMER_INT_TOP,
+							 data->top_ticks);
+		} else {
+			dwt_setinterrupt(DW3000_TIMER_INT_TOP, 0, DWT_DISABLE_INT);
+		}
+	}
+	dw3000_unlock(cfg->inst);
+
+	return 0;
+}
+
+static uint32_t dw3000_timer_get_top_value(const struct device* dev)
+{
+	struct dw3000_timer_data* data = dev->data;
+
+	return data->top_ticks;
+}
+
+static uint32_t dw3000_timer_get_pending_int(const struct device* dev)
+{
+	return 0;
+}
+
+void dw3000_timer_sys_event(const dwt_cb_data_t* cb_data)
+{
+	const struct device* dev = dw3000_timer_get(dw3000_hw_selected());
+	struct dw3000_timer_data* data;
+	counter_alarm_callback_t alarm_cb;
+	uint16_t events;
+
+	if (dev == NULL
+		|| (cb_data->status
+			& (DW3000_TIMER_INT_ALARM | DW3000_TIMER_INT_TOP)) == 0) {
+		return;
+	}
+
+	data = dev->data;
+	events = dwt_timers_read_and_clear_events();
+	if ((events >> 8) > 1) {
+		LOG_DBG("DW3000 timer missed %u periods",
+				(unsigned int)(events >> 8) - 1);
+	}
+
+	if ((cb_data->status & DW3000_TIMER_INT_ALARM) && data->alarm_cb != NULL) {
+		/* one-shot: clear before the callback so it can set a new alarm */
+		alarm_cb = data->alarm_cb;
+		data->alarm_cb = NULL;
+		dwt_setinterrupt(DW3000_TIMER_INT_ALARM, 0, DWT_DISABLE_INT);
+		alarm_cb(dev, 0, data->alarm_ticks, data->alarm_user_data);
+	}
+
+	if ((cb_data->status & DW3000_TIMER_INT_TOP) && data->top_cb != NULL) {
+		data->top_cb(dev, data->top_user_data);
+	}
+}
+
+static int dw3000_timer_init(const struct device* dev)
+{
+	const struct dw3000_timer_config* cfg = dev->config;
+	struct dw3000_timer_data* data = dev->data;
+
+	if (cfg->inst >= CONFIG_DW3000_NUM_INSTANCES) {
+		return -EINVAL;
+	}
+
+	data->top_ticks = DW3000_TIMER_MAX_TICKS;
+	timer_devs[cfg->inst] = dev;
+	return 0;
+}
+
+static const struct counter_driver_api dw3000_timer_api = {
+	.start = dw3000_timer_start,
+	.stop = dw3000_timer_stop,
+	.get_value = dw3000_timer_get_value,
+	.set_alarm = dw3000_timer_set_alarm,
+	.cancel_alarm = dw3000_timer_cancel_alarm,
+	.set_top_value = dw3000_timer_set_top_value,
+	.get_pending_int = dw3000_timer_get_pending_int,
+	.get_top_value = dw3000_timer_get_top_value,
+};
+
+#define DW3000_TIMER_DEFINE(n)                                                 \
+	static const struct dw3000_timer_config dw3000_timer_config_##n = {        \
+		.info = {                                                              \
+			.max_top_value = DW3000_TIMER_MAX_TICKS,                           \
+			.freq = DW3000_TIMER_FREQ,                                         \
+			.flags = COUNTER_CONFIG_INFO_COUNT_UP,                             \
+			.channels = 1,                                                     \
+		},                                                                     \
+		.inst = n,                                                             \
+		.dw3000 = DEVICE_DT_INST_GET(n),                                       \
+	};                                                                         \
+	static struct dw3000_timer_data dw3000_timer_data_##n;                     \
+	DEVICE_DEFINE(dw3000_timer_##n, "dw3000_timer" #n, dw3000_timer_init,      \
+				  NULL, &dw3000_timer_data_##n, &dw3000_timer_config_##n,      \
+				  POST_KERNEL, CONFIG_DW3000_INIT_PRIORITY,                    \
+				  &dw3000_timer_api);
+
+DT_INST_FOREACH_STATUS_OKAY(DW3000_TIMER_DEFINE)
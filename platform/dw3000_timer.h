@@ -0,0 +1,41 @@
+#ifndef DW3000_TIMER_H
+#define DW3000_TIMER_H
+
+#include <stdint.h>
+#include <zephyr/device.h>
+
+#include "deca_device_api.h"
+
+/*
+ * Zephyr counter device on the TIMER0/1 of the DW3720, one for each
+ * "decawave,dw3000" devicetree node. The timers run from the XTAL of the
+ * DW3720 (38.4 MHz divided by 2^CONFIG_DW3000_TIMER_DIV) and their expiry is
+ * an interrupt of the DW3000 IRQ line, so the MCU can sleep until the next
+ * slot boundary without a k_timer and its system tick rounding.
+ *
+ * Usage: set dw3000_timer_sys_event() as cbSysEvent in dwt_setcallbacks() (or
+ * call it from cbSysEvent), get the counter device with dw3000_timer_get()
+ * and use it with the counter API:
+ *
+ * - counter_set_top_value() runs TIMER1 in repeat mode and calls the top
+ *   callback every period, e.g. at each TDMA slot boundary
+ * - counter_set_channel_alarm() on channel 0 runs TIMER0 once. Only relative
+ *   alarms are supported, the counter value can not be read.
+ *
+ * The counter has to be started with counter_start() before an alarm can be
+ * set, this also keeps the DW3000 awake with pm_device_runtime_get() (the
+ * timers do not run in DEEPSLEEP) until counter_stop().
+ *
+ * The callbacks run in the context of dwt_isr() with the device selected, so
+ * they can directly start a delayed TX or RX whose exact time is set with
+ * dwt_setdelayedtrxtime(): the timer wakes up the host ahead of the slot and
+ * the frame is sent or received at device time resolution.
+ */
+
+/* Maximum number of ticks of an alarm or of the top value */
+#define DW3000_TIMER_MAX_TICKS 0x3FFFFFU
+
+const struct device* dw3000_timer_get(uint8_t inst);
+void dw3000_timer_sys_event(const dwt_cb_data_t* cb_data);
+
+#endif
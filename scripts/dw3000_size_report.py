@@ -0,0 +1,117 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: Apache-2.0
+
+"""List the flash and RAM used by each feature of the DW3000 driver.
+
+Reads the symbols of the driver library (or object files) with nm and sums
+their sizes per feature, so the savings of the Kconfig options like
+CONFIG_DW3000_REDUCED_RAM can be seen before linking. The numbers are those
+of the library: functions the application does not call are still counted,
+the linker removes them later. Stack usage is not included.
+"""
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+from collections import defaultdict
+
+# feature and the symbols belonging to it, the first match counts, symbols
+# without a match are counted for the file they are in
+FEATURES = [
+    ("cir", r"readcir|cir_scratch|cir_acc_offset"),
+    ("diagnostics", r"diag"),
+    ("aes", r"aes|keyreg|mic_size"),
+    ("otp write", r"otpwrite|otpprog|otp_write|otp_prog"),
+    ("spi crc", r"crc"),
+    ("timer", r"timer"),
+    ("ranging", r"ranging"),
+    ("rx pool/ring", r"rx_pool|rx_ring"),
+    ("spi trace", r"spi_trace"),
+    ("stats", r"stats"),
+]
+
+# features of whole files, the others are named after the file
+OBJECTS = {
+    "deca_cir": "cir analysis",
+    "deca_clktrack": "clock tracking",
+    "deca_rsl": "rsl",
+}
+
+ROM_TYPES = "tTrRwW"
+DATA_TYPES = "dDgG"
+BSS_TYPES = "bBsSC"
+
+OBJ_RE = re.compile(r"^(.*?):$")
+SYM_RE = re.compile(r"^[0-9a-fA-F]+\s+([0-9a-fA-F]+)\s+(\w)\s+(\S+)$")
+
+
+def read_symbols(nm, files):
+    """yields (object file, symbol, type, size) for the sized symbols"""
+    out = subprocess.run([nm, "-S", "--defined-only"] + files, check=True,
+                         stdout=subprocess.PIPE,
+                         universal_newlines=True).stdout
+    obj = files[0] if len(files) == 1 else ""
+    for line in out.splitlines():
+        m = OBJ_RE.match(line)
+        if m:
+            obj = m.group(1)
+            continue
+        m = SYM_RE.match(line.strip())
+        if m:
+            yield obj, m.group(3), m.group(2), int(m.group(1), 16)
+
+
+def feature_of(obj, sym):
+    for name, regex in FEATURES:
+        if re.search(regex, sym):
+            return name
+    name = os.path.basename(obj).split(".")[0]
+    if name.endswith("_device"):
+        return "core"
+    return OBJECTS.get(name, name)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("files", nargs="+",
+                        help="driver library or object files")
+    parser.add_argument("--nm", default="nm", help="nm of the toolchain")
+    parser.add_argument("--symbols", action="store_true",
+                        help="also list the symbols of each feature")
+    args = parser.parse_args()
+
+    # feature: [flash, ram, {symbol: (flash, ram)}]
+    sizes = defaultdict(lambda: [0, 0, {}])
+    for obj, sym, typ, size in read_symbols(args.nm, args.files):
+        if typ in ROM_TYPES:
+            rom, ram = size, 0
+        elif typ in DATA_TYPES:
+            rom, ram = size, size
+        elif typ in BSS_TYPES:
+            rom, ram = 0, size
+        else:
+            continue
+        s = sizes[feature_of(obj, sym)]
+        s[0] += rom
+        s[1] += ram
+        s[2][sym] = (rom, ram)
+
+    if not sizes:
+        sys.exit("no symbols found")
+
+    print("%-20s %8s %8s" % ("feature", "flash", "ram"))
+    for name, (rom, ram, syms) in sorted(sizes.items(),
+                                         key=lambda i: -i[1][0]):
+        print("%-20s %8d %8d" % (name, rom, ram))
+        if args.symbols:
+            for sym, (srom, sram) in sorted(syms.items(),
+                                            key=lambda i: -sum(i[1])):
+                print("  %-40s %8d %8d" % (sym, srom, sram))
+    print("%-20s %8d %8d" % ("total", sum(s[0] for s in sizes.values()),
+                             sum(s[1] for s in sizes.values())))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,212 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: Apache-2.0
+
+"""Decode the binary SPI trace of CONFIG_DW3000_SPI_TRACE_EXPORT_RTT/UART.
+
+The register names are taken from the register header of the driver, so the
+trace shows e.g. "READ SYS_STATUS" instead of the raw SPI header.
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+from collections import defaultdict
+
+TRACE_SYNC = 0xD3
+TRACE_XFER = 0x01
+TRACE_LOST = 0x02
+TRACE_INFO = 0x03
+TRACE_VERSION = 1
+
+FLAG_READ = 0x01
+FLAG_HDR2 = 0x02
+FLAG_CRC = 0x04
+FLAG_ASYNC = 0x08
+FLAG_ERROR = 0x80
+
+XFER_HDR = struct.Struct("<BBBHBII")
+DRIVER_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..",
+                          "dwt_uwb_driver")
+
+
+class Registers:
+    """register and fast command names from the *_deca_regs.h/vals.h files"""
+
+    def __init__(self, chip, regs_file=None, vals_file=None):
+        base = os.path.join(DRIVER_DIR, chip, chip)
+        self.regs = defaultdict(dict)
+        self.cmds = {}
+
+        with open(regs_file or base + "_deca_regs.h") as f:
+            for m in re.finditer(r"#define\s+(\w+)_ID\s+0x([0-9A-Fa-f]+)UL",
+                                 f.read()):
+                addr = int(m.group(2), 16)
+                self.regs[addr >> 16].setdefault(addr & 0xFFFF, m.group(1))
+
+        with open(vals_file or base + "_deca_vals.h") as f:
+            for m in re.finditer(r"#define\s+CMD_(\w+)\s+0x([0-9A-Fa-f]+)",
+                                 f.read()):
+                self.cmds.setdefault(int(m.group(2), 16), m.group(1))
+
+    def name(self, reg, sub):
+        offsets = self.regs.get(reg, {})
+        below = [o for o in offsets if o <= sub]
+        if not below:
+            return "%02X:%02X" % (reg, sub)
+        off = max(below)
+        if off == sub:
+            return offsets[off]
+        return "%s+%d" % (offsets[off], sub - off)
+
+    def cmd(self, cmd):
+        return self.cmds.get(cmd, "0x%02X" % cmd)
+
+
+def decode_header(regs, flags, hdr0, hdr1):
+    """returns (operation, register name) like spi_dbg_out_reg()"""
+    if (hdr0 & 0xC1) == 0x81 and not flags & FLAG_HDR2:
+        return "FAST", regs.cmd((hdr0 >> 1) & 0x1F)
+
+    reg = (hdr0 & 0x3E) >> 1
+    sub = 0
+    if flags & FLAG_HDR2:
+        sub = ((hdr1 & 0xFC) >> 2) | ((hdr0 & 0x01) << 6)
+
+    if not hdr0 & 0x80:
+        op = "READ"
+    elif flags & FLAG_HDR2 and hdr1 & 0x03:
+        op = "AND_OR_%d" % (8 << ((hdr1 & 0x03) - 1))
+    else:
+        op = "WRITE"
+    return op, regs.name(reg, sub)
+
+
+def frames(stream):
+    """parse frames from a binary stream, skipping garbage before a sync"""
+    buf = b""
+    while True:
+        data = stream.read(4096)
+        if not data:
+            return
+        buf += data
+
+        while True:
+            start = buf.find(bytes([TRACE_SYNC]))
+            if start < 0:
+                buf = b""
+                break
+            buf = buf[start:]
+            if len(buf) < 2:
+                break
+
+            ftype = buf[1]
+            if ftype == TRACE_XFER:
+                if len(buf) < 2 + XFER_HDR.size:
+                    break
+                fields = XFER_HDR.unpack_from(buf, 2)
+                end = 2 + XFER_HDR.size + fields[4]
+                if len(buf) < end:
+                    break
+                yield ftype, fields + (buf[2 + XFER_HDR.size:end],)
+            elif ftype == TRACE_LOST:
+                if len(buf) < 6:
+                    break
+                end = 6
+                yield ftype, struct.unpack_from("<I", buf, 2)
+            elif ftype == TRACE_INFO:
+                if len(buf) < 7:
+                    break
+                end = 7
+                yield ftype, struct.unpack_from("<IB", buf, 2)
+            else:
+                end = 1
+            buf = buf[end:]
+
+
+def open_input(args):
+    if args.serial:
+        import serial  # pyserial
+
+        return serial.Serial(args.serial, args.baud)
+    if args.input == "-":
+        return sys.stdin.buffer
+    return open(args.input, "rb")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("input", nargs="?", default="-",
+                        help="binary trace file, - for stdin")
+    parser.add_argument("--serial", help="read from this serial port")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--chip", choices=["dw3000", "dw3720"],
+                        default="dw3720")
+    parser.add_argument("--regs", help="register header file")
+    parser.add_argument("--vals", help="register values header file")
+    parser.add_argument("--freq", type=int, default=0,
+                        help="cycle counter frequency, until an INFO frame")
+    parser.add_argument("--summary", action="store_true",
+                        help="print count and time per register at the end")
+    args = parser.parse_args()
+
+    regs = Registers(args.chip, args.regs, args.vals)
+    freq = args.freq
+    first = None
+    last = None
+    wraps = 0
+    stats = defaultdict(lambda: [0, 0, 0])
+
+    try:
+        for ftype, fields in frames(open_input(args)):
+            if ftype == TRACE_INFO:
+                if fields[1] != TRACE_VERSION:
+                    print("unknown trace version %d" % fields[1])
+                freq = fields[0]
+                continue
+            if ftype == TRACE_LOST:
+                print("--- %d lost" % fields[0])
+                continue
+
+            flags, hdr0, hdr1, length, _, start, cycles, body = fields
+            if last is not None and start < last:
+                wraps += 1
+            last = start
+            start += wraps << 32
+            if first is None:
+                first = start
+
+            op, name = decode_header(regs, flags, hdr0, hdr1)
+            if freq:
+                ts = "%12.6f +%7.1fus" % ((start - first) / freq,
+                                         cycles * 1e6 / freq)
+            else:
+                ts = "%12d +%8d" % (start - first, cycles)
+            extra = "".join([" CRC" if flags & FLAG_CRC else "",
+                             " ASYNC" if flags & FLAG_ASYNC else "",
+                             " ERROR" if flags & FLAG_ERROR else ""])
+            line = "%s %-8s %-20s %4d  %s%s" % (ts, op, name, length,
+                                                 body.hex(" "), extra)
+            print(line.rstrip())
+
+            s = stats[(op, name)]
+            s[0] += 1
+            s[1] += length
+            s[2] += cycles
+    except KeyboardInterrupt:
+        pass
+
+    if args.summary:
+        print("\n%-8s %-20s %8s %8s %12s" % ("op", "register", "count",
+                                             "bytes", "time us" if freq
+                                             else "cycles"))
+        for (op, name), (count, length, cycles) in sorted(
+                stats.items(), key=lambda i: -i[1][2]):
+            total = cycles * 1e6 / freq if freq else cycles
+            print("%-8s %-20s %8d %8d %12.1f" % (op, name, count, length,
+                                                  total))
+
+
+if __name__ == "__main__":
+    main()